@@ -31,6 +31,7 @@
 #include "annotation/include/Annotator.h"
 #include "harmonization/include/Harmonizer.h"
 #include "independization/include/Selector.h"
+#include "sorting/include/Sorter.h"
 
 #include <R.h>
 
@@ -146,6 +147,7 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 	SEXP renamed_columns = R_NilValue;
 	SEXP reordered_columns = R_NilValue;
 	SEXP ld_files = R_NilValue;
+	SEXP shards = R_NilValue;
 
 	if (external_descriptor_pointer == R_NilValue) {
 		error("\nThe external Descriptor pointer argument is NULL.");
@@ -157,7 +159,7 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 
 	descriptor = (Descriptor*)R_ExternalPtrAddr(external_descriptor_pointer);
 
-	PROTECT(attributes = allocVector(STRSXP, 11));
+	PROTECT(attributes = allocVector(STRSXP, 12));
 	SET_STRING_ELT(attributes, 0, mkChar("path_separator"));
 	SET_STRING_ELT(attributes, 1, mkChar("name"));
 	SET_STRING_ELT(attributes, 2, mkChar("path"));
@@ -169,11 +171,12 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 	SET_STRING_ELT(attributes, 8, mkChar("renamed_columns"));
 	SET_STRING_ELT(attributes, 9, mkChar("reordered_columns"));
 	SET_STRING_ELT(attributes, 10, mkChar("ld_files"));
+	SET_STRING_ELT(attributes, 11, mkChar("shards"));
 
 	PROTECT(class_name = allocVector(STRSXP, 1));
 	SET_STRING_ELT(class_name, 0, mkChar("Descriptor"));
 
-	PROTECT(descriptor_robj = allocVector(VECSXP, 11));
+	PROTECT(descriptor_robj = allocVector(VECSXP, 12));
 
 	PROTECT(path_separator = allocVector(STRSXP, 1));
 	buffer[0] = descriptor->get_path_separator();
@@ -312,6 +315,20 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 		UNPROTECT(1);
 	}
 
+	if (descriptor->shards.size() > 0) {
+		PROTECT(shards = allocVector(STRSXP, descriptor->shards.size()));
+
+		descriptor->vector_char_it = descriptor->shards.begin();
+		i = 0;
+		while (descriptor->vector_char_it != descriptor->shards.end()) {
+			SET_STRING_ELT(shards, i, mkChar(*(descriptor->vector_char_it)));
+			i += 1;
+			descriptor->vector_char_it++;
+		}
+
+		UNPROTECT(1);
+	}
+
 	SET_VECTOR_ELT(descriptor_robj, 0, path_separator);
 	SET_VECTOR_ELT(descriptor_robj, 1, name);
 	SET_VECTOR_ELT(descriptor_robj, 2, path);
@@ -323,6 +340,7 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 	SET_VECTOR_ELT(descriptor_robj, 8, renamed_columns);
 	SET_VECTOR_ELT(descriptor_robj, 9, reordered_columns);
 	SET_VECTOR_ELT(descriptor_robj, 10, ld_files);
+	SET_VECTOR_ELT(descriptor_robj, 11, shards);
 
 	setAttrib(descriptor_robj, R_NamesSymbol, attributes);
 	setAttrib(descriptor_robj, R_ClassSymbol, class_name);
@@ -368,6 +386,7 @@ SEXP Robj2Descriptor(SEXP descriptor_Robj) {
 	SEXP renamed_columns = R_NilValue;
 	SEXP reordered_columns = R_NilValue;
 	SEXP ld_files = R_NilValue;
+	SEXP shards = R_NilValue;
 
 	int ncol = 0;
 
@@ -534,6 +553,16 @@ SEXP Robj2Descriptor(SEXP descriptor_Robj) {
 						descriptor->add_ld_file(CHAR(STRING_ELT(ld_files, j)), CHAR(STRING_ELT(ld_files, j + ncol / 2)));
 					}
 				}
+			} else if (strcmp(value, "shards") == 0) {
+				shards = VECTOR_ELT(descriptor_Robj, i);
+				if (shards != R_NilValue) {
+					if (!isString(shards)) {
+						error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+					}
+					for (int j = 0; j < length(shards); j++) {
+						descriptor->add_shard(CHAR(STRING_ELT(shards, j)));
+					}
+				}
 			}
 		}
 
@@ -1161,7 +1190,7 @@ SEXP perform_formatting(SEXP external_descriptor_pointer) {
 	Descriptor* descriptor = NULL;
 	GwaFile* gwa_file = NULL;
 
-	void (GwaFile::*check_functions[8])(Descriptor*) = {
+	void (GwaFile::*check_functions[10])(Descriptor*) = {
 			&GwaFile::check_filters,
 			&GwaFile::check_thresholds,
 			&GwaFile::check_prefix,
@@ -1169,7 +1198,9 @@ SEXP perform_formatting(SEXP external_descriptor_pointer) {
 			&GwaFile::check_missing_value,
 			&GwaFile::check_separators,
 			&GwaFile::check_order,
-			&GwaFile::check_genomiccontrol
+			&GwaFile::check_genomiccontrol,
+			&GwaFile::check_index,
+			&GwaFile::check_compression
 	};
 
 	double inflation_factor = numeric_limits<double>::quiet_NaN();
@@ -1211,7 +1242,7 @@ SEXP perform_formatting(SEXP external_descriptor_pointer) {
 	try {
 		Formatter formatter;
 
-		gwa_file = new GwaFile(descriptor, check_functions, 8);
+		gwa_file = new GwaFile(descriptor, check_functions, 10);
 
 		formatter.open_gwafile(gwa_file);
 		formatter.process_header();
@@ -1268,7 +1299,7 @@ SEXP perform_annotation(SEXP external_descriptor_pointer) {
 	Descriptor* descriptor = NULL;
 	GwaFile* gwa_file = NULL;
 
-	void (GwaFile::*check_functions[8])(Descriptor*) = {
+	void (GwaFile::*check_functions[10])(Descriptor*) = {
 			&GwaFile::check_prefix,
 			&GwaFile::check_casesensitivity,
 			&GwaFile::check_separators,
@@ -1276,7 +1307,9 @@ SEXP perform_annotation(SEXP external_descriptor_pointer) {
 			&GwaFile::check_regions_file_separators,
 			&GwaFile::check_regions_deviation,
 			&GwaFile::check_regions_append,
-			&GwaFile::check_map_file_separators
+			&GwaFile::check_map_file_separators,
+			&GwaFile::check_index,
+			&GwaFile::check_compression
 	};
 
 	if (external_descriptor_pointer == R_NilValue) {
@@ -1292,7 +1325,7 @@ SEXP perform_annotation(SEXP external_descriptor_pointer) {
 	try {
 		Annotator annotator;
 
-		gwa_file = new GwaFile(descriptor, check_functions, 8);
+		gwa_file = new GwaFile(descriptor, check_functions, 10);
 
 		annotator.open_gwafile(gwa_file);
 		annotator.process_header();
@@ -1509,14 +1542,15 @@ SEXP perform_snps_independization(SEXP external_descriptor_pointer) {
 	Descriptor* descriptor = NULL;
 	GwaFile* gwa_file = NULL;
 
-	void (GwaFile::*check_functions[7])(Descriptor*) = {
+	void (GwaFile::*check_functions[8])(Descriptor*) = {
 			&GwaFile::check_prefix,
 			&GwaFile::check_casesensitivity,
 			&GwaFile::check_missing_value,
 			&GwaFile::check_separators,
 			&GwaFile::check_ld_files,
 			&GwaFile::check_ld_files_separators,
-			&GwaFile::check_ld_threshold
+			&GwaFile::check_ld_threshold,
+			&GwaFile::check_compression
 	};
 
 	if (external_descriptor_pointer == R_NilValue) {
@@ -1532,7 +1566,7 @@ SEXP perform_snps_independization(SEXP external_descriptor_pointer) {
 	try {
 		Selector selector;
 
-		gwa_file = new GwaFile(descriptor, check_functions, 7);
+		gwa_file = new GwaFile(descriptor, check_functions, 8);
 
 		selector.open_gwafile(gwa_file);
 		selector.process_header();
@@ -1573,6 +1607,47 @@ SEXP perform_snps_independization(SEXP external_descriptor_pointer) {
 	return R_NilValue;
 }
 
+SEXP perform_sorting(SEXP external_descriptor_pointer) {
+	Descriptor* descriptor = NULL;
+	GwaFile* gwa_file = NULL;
+
+	void (GwaFile::*check_functions[5])(Descriptor*) = {
+			&GwaFile::check_prefix,
+			&GwaFile::check_casesensitivity,
+			&GwaFile::check_separators,
+			&GwaFile::check_index,
+			&GwaFile::check_compression
+	};
+
+	if (external_descriptor_pointer == R_NilValue) {
+		error("\nThe external Descriptor pointer argument is NULL.");
+	}
+
+	if (TYPEOF(external_descriptor_pointer) != EXTPTRSXP) {
+		error("\nThe external Descriptor pointer argument has an incorrect type.");
+	}
+
+	descriptor = (Descriptor*)R_ExternalPtrAddr(external_descriptor_pointer);
+
+	try {
+		Sorter sorter;
+
+		gwa_file = new GwaFile(descriptor, check_functions, 5);
+
+		sorter.open_gwafile(gwa_file);
+		sorter.process_header();
+		sorter.sort();
+		sorter.close_gwafile();
+
+		delete gwa_file;
+		gwa_file = NULL;
+	} catch (Exception &e) {
+		error("\n%s", e.what());
+	}
+
+	return R_NilValue;
+}
+
 }
 
 /*
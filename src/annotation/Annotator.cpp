@@ -22,7 +22,7 @@
 const unsigned int Annotator::MAP_HEAP_SIZE = 3000000;
 const unsigned int Annotator::MAP_HEAP_INCREMENT = 10000;
 
-Annotator::Annotator() : gwafile(NULL), regions_file(NULL), map_file(NULL),
+Annotator::Annotator() : gwafile(NULL), regions_file(NULL), map_file(NULL), reader(NULL),
 	header_backup(NULL),
 	total_columns(numeric_limits<int>::min()),
 	marker_column_pos(numeric_limits<int>::min()),
@@ -83,6 +83,11 @@ Annotator::~Annotator() {
 		header_backup = NULL;
 	}
 
+	if (reader != NULL) {
+		delete reader;
+		reader = NULL;
+	}
+
 	gwafile = NULL;
 	regions_file = NULL;
 	map_file = NULL;
@@ -103,8 +108,9 @@ void Annotator::open_gwafile(GwaFile* gwafile) throw (AnnotatorException) {
 		}
 
 		this->gwafile = gwafile;
-		reader.set_file_name(gwafile->get_descriptor()->get_full_path());
-		reader.open();
+		reader = gwafile->create_reader();
+		reader->set_file_name(gwafile->get_descriptor()->get_full_path());
+		reader->open();
 	} catch (DescriptorException& e) {
 		AnnotatorException new_e(e);
 		new_e.add_message("Annotator", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
@@ -113,6 +119,10 @@ void Annotator::open_gwafile(GwaFile* gwafile) throw (AnnotatorException) {
 		AnnotatorException new_e(e);
 		new_e.add_message("Annotator", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
 		throw new_e;
+	} catch (GwaFileException& e) {
+		AnnotatorException new_e(e);
+		new_e.add_message("Annotator", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
 	} catch (AnnotatorException& e) {
 		e.add_message("Annotator", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
 		throw;
@@ -121,7 +131,12 @@ void Annotator::open_gwafile(GwaFile* gwafile) throw (AnnotatorException) {
 
 void Annotator::close_gwafile() throw (AnnotatorException) {
 	try {
-		reader.close();
+		if (reader != NULL) {
+			reader->close();
+
+			delete reader;
+			reader = NULL;
+		}
 	} catch (ReaderException &e) {
 		AnnotatorException new_e(e);
 		new_e.add_message("Annotator", "close_gwafile()", __LINE__, 4, (gwafile != NULL) ? gwafile->get_descriptor()->get_full_path() : "NULL");
@@ -189,11 +204,11 @@ void Annotator::process_header_without_map() throw (AnnotatorException) {
 		header_separator = gwafile->get_header_separator();
 		regions_append = gwafile->is_regions_append_on();
 
-		if (reader.read_line() <= 0) {
+		if (reader->read_line() <= 0) {
 			throw AnnotatorException("Annotator", "process_header_without_map()", __LINE__, 5, 1, gwafile->get_descriptor()->get_name());
 		}
 
-		header = *reader.line;
+		header = *(reader->line);
 
 		if (regions_append) {
 			header_backup = (char*)malloc((strlen(header) + 1u) * sizeof(char));
@@ -208,7 +223,7 @@ void Annotator::process_header_without_map() throw (AnnotatorException) {
 		chr_column_pos = numeric_limits<int>::min();
 		position_column_pos = numeric_limits<int>::min();
 
-		token = auxiliary::strtok(&header, header_separator);
+		token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 		while (token != NULL) {
 			column_name = descriptor->get_default_column(token, gwafile->is_case_sensitive());
 			if (column_name != NULL) {
@@ -220,7 +235,7 @@ void Annotator::process_header_without_map() throw (AnnotatorException) {
 					position_column_pos = column_position;
 				}
 			}
-			token = auxiliary::strtok(&header, header_separator);
+			token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 			++column_position;
 		}
 
@@ -266,11 +281,11 @@ void Annotator::process_header_with_map() throw (AnnotatorException) {
 		header_separator = gwafile->get_header_separator();
 		regions_append = gwafile->is_regions_append_on();
 
-		if (reader.read_line() <= 0) {
+		if (reader->read_line() <= 0) {
 			throw AnnotatorException("Annotator", "process_header_with_map()", __LINE__, 5, 1, gwafile->get_descriptor()->get_name());
 		}
 
-		header = *reader.line;
+		header = *(reader->line);
 
 		if (regions_append) {
 			header_backup = (char*)malloc((strlen(header) + 1u) * sizeof(char));
@@ -283,7 +298,7 @@ void Annotator::process_header_with_map() throw (AnnotatorException) {
 		total_columns = numeric_limits<int>::min();
 		marker_column_pos = numeric_limits<int>::min();
 
-		token = auxiliary::strtok(&header, header_separator);
+		token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 		while (token != NULL) {
 			column_name = descriptor->get_default_column(token, gwafile->is_case_sensitive());
 			if (column_name != NULL) {
@@ -291,7 +306,7 @@ void Annotator::process_header_with_map() throw (AnnotatorException) {
 					marker_column_pos = column_position;
 				}
 			}
-			token = auxiliary::strtok(&header, header_separator);
+			token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 			++column_position;
 		}
 
@@ -392,7 +407,7 @@ void Annotator::index_map() throw (AnnotatorException) {
 void Annotator::annotate_without_map() throw (AnnotatorException) {
 	Descriptor* descriptor = NULL;
 
-	ofstream ofile_stream;
+	Writer* writer = NULL;
 
 	const char* output_prefix = NULL;
 	const char* file_name = NULL;
@@ -406,11 +421,14 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 	char data_separator = '\0';
 	char region_separator = '\0';
 	bool regions_append = false;
+	const char* index_format = NULL;
+	const char* compression = NULL;
 
-	char* token = NULL;
+	vector<char*> fields;
 	char* end_ptr = NULL;
 
 	int column_position = 0;
+	int needed_columns = 0;
 
 	const char* column_name = NULL;
 
@@ -441,8 +459,14 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 		data_separator = gwafile->get_data_separator();
 		deviation = descriptor->get_threshold(Descriptor::REGIONS_DEVIATION);
 		regions_append = gwafile->is_regions_append_on();
+		index_format = gwafile->get_index_format();
+		compression = gwafile->get_compression();
 
-		auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, NULL, true);
+		if ((compression != NULL) && ((strlen(file_name) < 3) || (strcmp(file_name + strlen(file_name) - 3, ".gz") != 0))) {
+			auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, ".gz", true);
+		} else {
+			auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, NULL, true);
+		}
 		if (output_file_name == NULL) {
 			throw AnnotatorException("Annotator", "annotate_without_map()", __LINE__, 16);
 		}
@@ -453,65 +477,71 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 			region_separator = ',';
 		}
 
-		ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
+		if ((index_format != NULL) && ((header_separator != '\t') || (data_separator != '\t'))) {
+			throw AnnotatorException("Annotator", "annotate_without_map()", __LINE__, 23, output_file_name);
+		}
 
 		try {
-			ofile_stream.open(output_file_name);
-		} catch (ofstream::failure &e) {
+			writer = WriterFactory::create_async(compression != NULL ? compression : WriterFactory::TEXT);
+			writer->set_file_name(output_file_name);
+			writer->open();
+		} catch (WriterException &e) {
 			throw AnnotatorException("Annotator", "annotate_without_map()", __LINE__, 17, output_file_name);
 		}
 
 		try {
 			if (regions_append) {
-				ofile_stream << header_backup;
+				writer->put_str(header_backup);
 			} else {
-				ofile_stream << ((column_name = descriptor->get_column(Descriptor::MARKER)) != NULL ? column_name : Descriptor::MARKER);
-				ofile_stream << header_separator;
-				ofile_stream << ((column_name = descriptor->get_column(Descriptor::CHR)) != NULL ? column_name : Descriptor::CHR);
-				ofile_stream << header_separator;
-				ofile_stream << ((column_name = descriptor->get_column(Descriptor::POSITION)) != NULL ? column_name : Descriptor::POSITION);
+				writer->put_str((column_name = descriptor->get_column(Descriptor::MARKER)) != NULL ? column_name : Descriptor::MARKER);
+				writer->put_char(header_separator);
+				writer->put_str((column_name = descriptor->get_column(Descriptor::CHR)) != NULL ? column_name : Descriptor::CHR);
+				writer->put_char(header_separator);
+				writer->put_str((column_name = descriptor->get_column(Descriptor::POSITION)) != NULL ? column_name : Descriptor::POSITION);
 			}
 			for (unsigned int i = 0u; i < deviation->size(); ++i) {
 				deviation_value = (int)deviation->at(i);
 				if (deviation_value != 0) {
-					ofile_stream << header_separator << "+/-" << deviation_value;
+					writer->put_char(header_separator);
+					writer->put_str("+/-");
+					writer->put_int(deviation_value);
 				} else {
-					ofile_stream << header_separator << "IN";
+					writer->put_char(header_separator);
+					writer->put_str("IN");
 				}
 			}
-			ofile_stream << endl;
-
-			while ((line_length = reader.read_line()) > 0) {
-				line = *reader.line;
+			writer->put_char('\n');
 
+			if (index_format != NULL) {
 				if (regions_append) {
-					ofile_stream << line;
+					writer->set_index(index_format, chr_column_pos + 1, position_column_pos + 1);
+				} else {
+					writer->set_index(index_format, 2, 3);
 				}
+			}
 
-				column_position = 0;
-				marker_token = NULL;
-				chr_token = NULL;
-				position_token = NULL;
-				token = auxiliary::strtok(&line, data_separator);
-				while (token != NULL) {
-					if (column_position == marker_column_pos) {
-						marker_token = token;
-					} else if (column_position == chr_column_pos) {
-						chr_token = token;
-					} else if (column_position == position_column_pos) {
-						position_token = token;
-					}
-					token = auxiliary::strtok(&line, data_separator);
-					++column_position;
+			needed_columns = max(max(marker_column_pos, chr_column_pos), position_column_pos) + 1;
+
+			while ((line_length = reader->read_line()) > 0) {
+				line = *(reader->line);
+
+				if (regions_append) {
+					writer->put_str(line);
 				}
 
+				column_position = auxiliary::split(line, data_separator, fields, needed_columns, gwafile->is_quoted());
+
 				if (column_position < total_columns) {
 					throw AnnotatorException("Annotator", "annotate_without_map()", __LINE__, 8, line_number, gwafile->get_descriptor()->get_name(), column_position, total_columns);
 				} else if (column_position > total_columns) {
 					throw AnnotatorException("Annotator", "annotate_without_map()", __LINE__, 9, line_number, gwafile->get_descriptor()->get_name(), column_position, total_columns);
 				}
 
-				position = (int)strtol(position_token, &end_ptr, 10);
+				marker_token = fields[marker_column_pos];
+				chr_token = fields[chr_column_pos];
+				position_token = fields[position_column_pos];
+
+				position = (int)auxiliary::fast_strtol(position_token, &end_ptr);
 				if (*end_ptr != '\0') {
 					throw AnnotatorException("Annotator", "annotate_without_map()",  __LINE__, 10, position_token, ((column_name = descriptor->get_column(Descriptor::POSITION)) != NULL) ? column_name : Descriptor::POSITION, line_number);
 				}
@@ -521,7 +551,11 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 				}
 
 				if (!regions_append) {
-					ofile_stream << marker_token << data_separator << chr_token << data_separator << position_token;
+					writer->put_str(marker_token);
+					writer->put_char(data_separator);
+					writer->put_str(chr_token);
+					writer->put_char(data_separator);
+					writer->put_str(position_token);
 				}
 
 				regions_indices_it = regions_indices.find(chr_token);
@@ -539,20 +573,21 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 
 					if (annotated_genes.size() > 0) {
 						for (unsigned int i = 0u; i < deviation->size(); ++i) {
-							ofile_stream << data_separator;
+							writer->put_char(data_separator);
 							annotated_genes_it = annotated_genes.find(((int)deviation->at(i)));
 							if (annotated_genes_it != annotated_genes.end()) {
-								write_char_vector(ofile_stream, annotated_genes_it->second, region_separator);
+								write_char_vector(writer, annotated_genes_it->second, region_separator);
 							} else {
-								ofile_stream << "NA";
+								writer->put_str("NA");
 							}
 						}
-						ofile_stream << endl;
+						writer->put_char('\n');
 					} else {
 						for (unsigned int i = 0u; i < deviation->size(); ++i) {
-							ofile_stream << data_separator << "NA";
+							writer->put_char(data_separator);
+							writer->put_str("NA");
 						}
-						ofile_stream << endl;
+						writer->put_char('\n');
 					}
 
 					annotated_genes_it = annotated_genes.begin();
@@ -565,35 +600,50 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 					genes_index_subset.clear();
 				} else {
 					for (unsigned int i = 0u; i < deviation->size(); ++i) {
-						ofile_stream << data_separator << "NA";
+						writer->put_char(data_separator);
+						writer->put_str("NA");
 					}
-					ofile_stream << endl;
+					writer->put_char('\n');
+				}
+
+				if (index_format != NULL) {
+					writer->index_record(chr_token, position);
 				}
 
 				++line_number;
 			}
-		} catch (ofstream::failure &e) {
-			throw AnnotatorException("Annotator", "annotate_without_map()", __LINE__, 19, output_file_name);
+		} catch (WriterException &e) {
+			AnnotatorException new_e(e);
+			new_e.add_message("Annotator", "annotate_without_map()", __LINE__, 19, output_file_name);
+			throw new_e;
 		}
 
 		try {
-			ofile_stream.close();
-		} catch (ofstream::failure &e) {
-			throw AnnotatorException("Annotator", "annotate_without_map()", __LINE__, 18, output_file_name);
+			writer->close();
+		} catch (WriterException &e) {
+			AnnotatorException new_e(e);
+			new_e.add_message("Annotator", "annotate_without_map()", __LINE__, 18, output_file_name);
+			throw new_e;
 		}
 
+		delete writer;
+		writer = NULL;
+
 		if (line_length == 0) {
 			throw AnnotatorException("Annotator", "annotate_without_map()", __LINE__, 13, line_number, gwafile->get_descriptor()->get_name());
 		}
 	} catch (DescriptorException &e) {
+		delete writer;
 		AnnotatorException new_e(e);
 		new_e.add_message("Annotator", "annotate_without_map()", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw new_e;
 	} catch (ReaderException &e) {
+		delete writer;
 		AnnotatorException new_e(e);
 		new_e.add_message("Annotator", "annotate_without_map()", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw new_e;
 	} catch (AnnotatorException &e) {
+		delete writer;
 		e.add_message("Annotator", "annotate_without_map()", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw;
 	}
@@ -602,7 +652,7 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 void Annotator::annotate_with_map() throw (AnnotatorException) {
 	Descriptor* descriptor = NULL;
 
-	ofstream ofile_stream;
+	Writer* writer = NULL;
 
 	const char* output_prefix = NULL;
 	const char* file_name = NULL;
@@ -612,15 +662,20 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 	int line_length = 0;
 	unsigned int line_number = 2u;
 	char* line_backup = NULL;
+	char* new_line_backup = NULL;
+	int line_backup_size = 0;
 
 	char header_separator = '\0';
 	char data_separator = '\0';
 	char region_separator = '\0';
 	bool regions_append = false;
+	const char* index_format = NULL;
+	const char* compression = NULL;
 
-	char* token = NULL;
+	vector<char*> fields;
 
 	int column_position = 0;
+	int needed_columns = 0;
 
 	const char* column_name = NULL;
 
@@ -652,16 +707,23 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 		data_separator = gwafile->get_data_separator();
 		deviation = descriptor->get_threshold(Descriptor::REGIONS_DEVIATION);
 		regions_append = gwafile->is_regions_append_on();
+		index_format = gwafile->get_index_format();
+		compression = gwafile->get_compression();
 
-		auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, NULL, true);
+		if ((compression != NULL) && ((strlen(file_name) < 3) || (strcmp(file_name + strlen(file_name) - 3, ".gz") != 0))) {
+			auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, ".gz", true);
+		} else {
+			auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, NULL, true);
+		}
 		if (output_file_name == NULL) {
 			throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 16);
 		}
 
 		if (regions_append) {
-			line_backup = (char*)malloc(reader.get_buffer_size() * sizeof(char));
+			line_backup_size = reader->get_buffer_size() + 1;
+			line_backup = (char*)malloc(line_backup_size * sizeof(char));
 			if (line_backup == NULL) {
-				throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 2, (reader.get_buffer_size() * sizeof(char)));
+				throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 2, (line_backup_size * sizeof(char)));
 			}
 		}
 
@@ -671,73 +733,104 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 			region_separator = ',';
 		}
 
-		ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
+		if ((index_format != NULL) && ((header_separator != '\t') || (data_separator != '\t'))) {
+			throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 23, output_file_name);
+		}
 
 		try {
-			ofile_stream.open(output_file_name);
-		} catch (ofstream::failure &e) {
+			writer = WriterFactory::create_async(compression != NULL ? compression : WriterFactory::TEXT);
+			writer->set_file_name(output_file_name);
+			writer->open();
+		} catch (WriterException &e) {
 			throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 17, output_file_name);
 		}
 
 		try {
 			if (regions_append) {
-				ofile_stream << header_backup;
-				ofile_stream << header_separator;
-				ofile_stream << ((column_name = descriptor->get_property(Descriptor::MAP_CHR)) != NULL ? column_name : Descriptor::MAP_CHR);
-				ofile_stream << header_separator;
-				ofile_stream << ((column_name = descriptor->get_property(Descriptor::MAP_POSITION)) != NULL ? column_name : Descriptor::MAP_POSITION);
+				writer->put_str(header_backup);
+				writer->put_char(header_separator);
+				writer->put_str((column_name = descriptor->get_property(Descriptor::MAP_CHR)) != NULL ? column_name : Descriptor::MAP_CHR);
+				writer->put_char(header_separator);
+				writer->put_str((column_name = descriptor->get_property(Descriptor::MAP_POSITION)) != NULL ? column_name : Descriptor::MAP_POSITION);
 			} else {
-				ofile_stream << ((column_name = descriptor->get_column(Descriptor::MARKER)) != NULL ? column_name : Descriptor::MARKER);
-				ofile_stream << header_separator;
-				ofile_stream << ((column_name = descriptor->get_property(Descriptor::MAP_CHR)) != NULL ? column_name : Descriptor::MAP_CHR);
-				ofile_stream << header_separator;
-				ofile_stream << ((column_name = descriptor->get_property(Descriptor::MAP_POSITION)) != NULL ? column_name : Descriptor::MAP_POSITION);
+				writer->put_str((column_name = descriptor->get_column(Descriptor::MARKER)) != NULL ? column_name : Descriptor::MARKER);
+				writer->put_char(header_separator);
+				writer->put_str((column_name = descriptor->get_property(Descriptor::MAP_CHR)) != NULL ? column_name : Descriptor::MAP_CHR);
+				writer->put_char(header_separator);
+				writer->put_str((column_name = descriptor->get_property(Descriptor::MAP_POSITION)) != NULL ? column_name : Descriptor::MAP_POSITION);
 			}
 			for (unsigned int i = 0u; i < deviation->size(); ++i) {
 				deviation_value = (int)deviation->at(i);
 				if (deviation_value != 0) {
-					ofile_stream << header_separator << "+/-" << deviation_value;
+					writer->put_char(header_separator);
+					writer->put_str("+/-");
+					writer->put_int(deviation_value);
 				} else {
-					ofile_stream << header_separator << "IN";
+					writer->put_char(header_separator);
+					writer->put_str("IN");
 				}
 			}
-			ofile_stream << endl;
-
-			while ((line_length = reader.read_line()) > 0) {
-				line = *reader.line;
+			writer->put_char('\n');
 
+			if (index_format != NULL) {
 				if (regions_append) {
-					strcpy(line_backup, line);
+					writer->set_index(index_format, total_columns + 1, total_columns + 2);
+				} else {
+					writer->set_index(index_format, 2, 3);
 				}
+			}
+
+			needed_columns = marker_column_pos + 1;
 
-				column_position = 0;
-				key_marker_index.name = NULL;
-				token = auxiliary::strtok(&line, data_separator);
-				while (token != NULL) {
-					if (column_position == marker_column_pos) {
-						key_marker_index.name = token;
+			while ((line_length = reader->read_line()) > 0) {
+				line = *(reader->line);
+
+				if (regions_append) {
+					if (line_length >= line_backup_size) {
+						line_backup_size = reader->get_buffer_size() + 1;
+						new_line_backup = (char*)realloc(line_backup, line_backup_size * sizeof(char));
+						if (new_line_backup == NULL) {
+							throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 2, (line_backup_size * sizeof(char)));
+						}
+						line_backup = new_line_backup;
 					}
-					token = auxiliary::strtok(&line, data_separator);
-					++column_position;
+					strcpy(line_backup, line);
 				}
 
+				column_position = auxiliary::split(line, data_separator, fields, needed_columns, gwafile->is_quoted());
+
 				if (column_position < total_columns) {
 					throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 8, line_number, gwafile->get_descriptor()->get_name(), column_position, total_columns);
 				} else if (column_position > total_columns) {
 					throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 9, line_number, gwafile->get_descriptor()->get_name(), column_position, total_columns);
 				}
 
+				key_marker_index.name = fields[marker_column_pos];
+
 				found_marker_index = (marker_index*)bsearch(&key_marker_index, map_index, map_index_size, sizeof(marker_index), qsort_marker_index_cmp);
 				if (found_marker_index == NULL) {
 					if (regions_append) {
-						ofile_stream << line_backup << data_separator << "NA" << data_separator << "NA";
+						writer->put_str(line_backup);
+						writer->put_char(data_separator);
+						writer->put_str("NA");
+						writer->put_char(data_separator);
+						writer->put_str("NA");
 					} else {
-						ofile_stream << key_marker_index.name << data_separator << "NA" << data_separator << "NA";
+						writer->put_str(key_marker_index.name);
+						writer->put_char(data_separator);
+						writer->put_str("NA");
+						writer->put_char(data_separator);
+						writer->put_str("NA");
 					}
 					for (unsigned int i = 0u; i < deviation->size(); ++i) {
-						ofile_stream << data_separator << "NA";
+						writer->put_char(data_separator);
+						writer->put_str("NA");
+					}
+					writer->put_char('\n');
+
+					if (index_format != NULL) {
+						writer->index_record(NULL, -1l);
 					}
-					ofile_stream << endl;
 				} else {
 					found_marker_index_pos = found_marker_index - map_index;
 					while ((found_marker_index_pos < map_index_size) && (auxiliary::strcmp_ignore_case(key_marker_index.name, map_index[found_marker_index_pos].name) == 0)) {
@@ -746,9 +839,17 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 						position = map_positions[index];
 
 						if (regions_append) {
-							ofile_stream << line_backup << data_separator << chr << data_separator << position;
+							writer->put_str(line_backup);
+							writer->put_char(data_separator);
+							writer->put_str(chr);
+							writer->put_char(data_separator);
+							writer->put_int(position);
 						} else {
-							ofile_stream << key_marker_index.name << data_separator << chr << data_separator << position;
+							writer->put_str(key_marker_index.name);
+							writer->put_char(data_separator);
+							writer->put_str(chr);
+							writer->put_char(data_separator);
+							writer->put_int(position);
 						}
 
 						regions_indices_it = regions_indices.find(chr);
@@ -766,20 +867,21 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 
 							if (annotated_genes.size() > 0) {
 								for (unsigned int i = 0u; i < deviation->size(); ++i) {
-									ofile_stream << data_separator;
+									writer->put_char(data_separator);
 									annotated_genes_it = annotated_genes.find(((int)deviation->at(i)));
 									if (annotated_genes_it != annotated_genes.end()) {
-										write_char_vector(ofile_stream, annotated_genes_it->second, region_separator);
+										write_char_vector(writer, annotated_genes_it->second, region_separator);
 									} else {
-										ofile_stream << "NA";
+										writer->put_str("NA");
 									}
 								}
-								ofile_stream << endl;
+								writer->put_char('\n');
 							} else {
 								for (unsigned int i = 0u; i < deviation->size(); ++i) {
-									ofile_stream << data_separator << "NA";
+									writer->put_char(data_separator);
+									writer->put_str("NA");
 								}
-								ofile_stream << endl;
+								writer->put_char('\n');
 							}
 
 							annotated_genes_it = annotated_genes.begin();
@@ -792,9 +894,14 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 							genes_index_subset.clear();
 						} else {
 							for (unsigned int i = 0u; i < deviation->size(); ++i) {
-								ofile_stream << data_separator << "NA";
+								writer->put_char(data_separator);
+								writer->put_str("NA");
 							}
-							ofile_stream << endl;
+							writer->put_char('\n');
+						}
+
+						if (index_format != NULL) {
+							writer->index_record(chr, position);
 						}
 
 						++found_marker_index_pos;
@@ -803,16 +910,23 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 
 				++line_number;
 			}
-		} catch (ofstream::failure &e) {
-			throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 19, output_file_name);
+		} catch (WriterException &e) {
+			AnnotatorException new_e(e);
+			new_e.add_message("Annotator", "annotate_with_map()", __LINE__, 19, output_file_name);
+			throw new_e;
 		}
 
 		try {
-			ofile_stream.close();
-		} catch (ofstream::failure &e) {
-			throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 18, output_file_name);
+			writer->close();
+		} catch (WriterException &e) {
+			AnnotatorException new_e(e);
+			new_e.add_message("Annotator", "annotate_with_map()", __LINE__, 18, output_file_name);
+			throw new_e;
 		}
 
+		delete writer;
+		writer = NULL;
+
 		if (line_backup != NULL) {
 			free(line_backup);
 			line_backup = NULL;
@@ -822,14 +936,17 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 			throw AnnotatorException("Annotator", "annotate_with_map()", __LINE__, 13, line_number, gwafile->get_descriptor()->get_name());
 		}
 	} catch (DescriptorException &e) {
+		delete writer;
 		AnnotatorException new_e(e);
 		new_e.add_message("Annotator", "annotate_with_map()", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw new_e;
 	} catch (ReaderException &e) {
+		delete writer;
 		AnnotatorException new_e(e);
 		new_e.add_message("Annotator", "annotate_with_map()", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw new_e;
 	} catch (AnnotatorException &e) {
+		delete writer;
 		e.add_message("Annotator", "annotate_with_map()", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw;
 	}
@@ -993,10 +1110,11 @@ void Annotator::process_regions_file_data()  throw (AnnotatorException) {
 
 	char data_separator = '\0';
 
-	char* token = NULL;
+	vector<char*> fields;
 	char* end_ptr = NULL;
 
 	int column_position = 0;
+	int needed_columns = 0;
 
 	const char* region_name_column = NULL;
 	const char* region_chr_column = NULL;
@@ -1028,28 +1146,12 @@ void Annotator::process_regions_file_data()  throw (AnnotatorException) {
 		region_start_column = descriptor->get_property(Descriptor::REGION_START);
 		region_end_column = descriptor->get_property(Descriptor::REGION_END);
 
+		needed_columns = max(max(region_name_column_pos, region_chr_column_pos), max(region_start_column_pos, region_end_column_pos)) + 1;
+
 		while ((line_length = regions_reader.read_line()) > 0) {
 			line = *regions_reader.line;
 
-			column_position = 0;
-			region_name_token = NULL;
-			region_chr_token = NULL;
-			region_start_token = NULL;
-			region_end_token = NULL;
-			token = auxiliary::strtok(&line, data_separator);
-			while (token != NULL) {
-				if (column_position == region_name_column_pos) {
-					region_name_token = token;
-				} else if (column_position == region_chr_column_pos) {
-					region_chr_token = token;
-				} else if (column_position == region_start_column_pos) {
-					region_start_token = token;
-				} else if (column_position == region_end_column_pos) {
-					region_end_token = token;
-				}
-				token = auxiliary::strtok(&line, data_separator);
-				++column_position;
-			}
+			column_position = auxiliary::split(line, data_separator, fields, needed_columns);
 
 			if (column_position < regions_file_total_columns) {
 				throw AnnotatorException("Annotator", "process_regions_file_data()", __LINE__, 8, line_number, regions_file, column_position, regions_file_total_columns);
@@ -1057,13 +1159,18 @@ void Annotator::process_regions_file_data()  throw (AnnotatorException) {
 				throw AnnotatorException("Annotator", "process_regions_file_data()", __LINE__, 9, line_number, regions_file, column_position, regions_file_total_columns);
 			}
 
+			region_name_token = fields[region_name_column_pos];
+			region_chr_token = fields[region_chr_column_pos];
+			region_start_token = fields[region_start_column_pos];
+			region_end_token = fields[region_end_column_pos];
+
 			region_name = (char*)malloc((strlen(region_name_token) + 1u) * sizeof(char));
 			if (region_name == NULL) {
 				throw AnnotatorException("Annotator", "process_regions_file_data()",  __LINE__, 2, ((strlen(region_name_token) + 1u) * sizeof(char)));
 			}
 			strcpy(region_name, region_name_token);
 
-			region_start = (int)strtol(region_start_token, &end_ptr, 10);
+			region_start = (int)auxiliary::fast_strtol(region_start_token, &end_ptr);
 			if (*end_ptr != '\0') {
 				throw AnnotatorException("Annotator", "process_regions_file_data()",  __LINE__, 10, region_start_token, region_start_column, line_number);
 			}
@@ -1072,7 +1179,7 @@ void Annotator::process_regions_file_data()  throw (AnnotatorException) {
 				throw AnnotatorException("Annotator", "process_regions_file_data()",  __LINE__, 11, region_start_column, region_start, line_number);
 			}
 
-			region_end = (int)strtol(region_end_token, &end_ptr, 10);
+			region_end = (int)auxiliary::fast_strtol(region_end_token, &end_ptr);
 			if (*end_ptr != '\0') {
 				throw AnnotatorException("Annotator", "process_regions_file_data()",  __LINE__, 10, region_end_token, region_end_column, line_number);
 			}
@@ -1256,10 +1363,11 @@ void Annotator::process_map_file_data() throw (AnnotatorException) {
 
 	char data_separator = '\0';
 
-	char* token = NULL;
+	vector<char*> fields;
 	char* end_ptr = NULL;
 
 	int column_position = 0;
+	int needed_columns = 0;
 
 	const char* map_marker_column = NULL;
 	const char* map_chr_column = NULL;
@@ -1302,25 +1410,12 @@ void Annotator::process_map_file_data() throw (AnnotatorException) {
 			throw AnnotatorException("Annotator", "process_map_file_data()", __LINE__, 2, (current_map_heap_size * sizeof(int)));
 		}
 
+		needed_columns = max(max(map_marker_column_pos, map_chr_column_pos), map_position_column_pos) + 1;
+
 		while ((line_length = map_reader.read_line()) > 0) {
 			line = *map_reader.line;
 
-			column_position = 0;
-			map_marker_token = NULL;
-			map_chr_token = NULL;
-			map_position_token = NULL;
-			token = auxiliary::strtok(&line, data_separator);
-			while (token != NULL) {
-				if (column_position == map_marker_column_pos) {
-					map_marker_token = token;
-				} else if (column_position == map_chr_column_pos) {
-					map_chr_token = token;
-				} else if (column_position == map_position_column_pos) {
-					map_position_token = token;
-				}
-				token = auxiliary::strtok(&line, data_separator);
-				++column_position;
-			}
+			column_position = auxiliary::split(line, data_separator, fields, needed_columns);
 
 			if (column_position < map_file_total_columns) {
 				throw AnnotatorException("Annotator", "process_map_file_data()", __LINE__, 8, line_number, map_file, column_position, map_file_total_columns);
@@ -1328,6 +1423,10 @@ void Annotator::process_map_file_data() throw (AnnotatorException) {
 				throw AnnotatorException("Annotator", "process_map_file_data()", __LINE__, 9, line_number, map_file, column_position, map_file_total_columns);
 			}
 
+			map_marker_token = fields[map_marker_column_pos];
+			map_chr_token = fields[map_chr_column_pos];
+			map_position_token = fields[map_position_column_pos];
+
 			if ((auxiliary::strcmp_ignore_case(map_marker_token, "NA") != 0) &&
 					(auxiliary::strcmp_ignore_case(map_chr_token, "NA") != 0) &&
 					(auxiliary::strcmp_ignore_case(map_position_token, "NA") != 0)) {
@@ -1370,7 +1469,7 @@ void Annotator::process_map_file_data() throw (AnnotatorException) {
 				}
 				strcpy(map_chromosomes[map_index_size], map_chr_token);
 
-				map_positions[map_index_size] = (int)strtol(map_position_token, &end_ptr, 10);
+				map_positions[map_index_size] = (int)auxiliary::fast_strtol(map_position_token, &end_ptr);
 				if (*end_ptr != '\0') {
 					throw AnnotatorException("Annotator", "process_map_file_data()",  __LINE__, 10, map_position_token, map_position_column, line_number);
 				}
@@ -1404,14 +1503,15 @@ void Annotator::process_map_file_data() throw (AnnotatorException) {
 	}
 }
 
-void Annotator::write_char_vector(ofstream &ofile_stream, vector<char*>* values, char separator) throw (ofstream::failure) {
+void Annotator::write_char_vector(Writer* writer, vector<char*>* values, char separator) throw (WriterException) {
 	int size = 0;
 	if ((values != NULL) && ((size = values->size()) > 0)) {
 		--size;
 		for (int i = 0; i < size; ++i) {
-			ofile_stream << values->at(i) << separator;
+			writer->put_str(values->at(i));
+			writer->put_char(separator);
 		}
-		ofile_stream << values->at(size);
+		writer->put_str(values->at(size));
 	}
 }
 
@@ -19,7 +19,7 @@
 
 #include "include/AnnotatorException.h"
 
-const int AnnotatorException::MESSAGE_TEMPLATES_NUMBER = 23;
+const int AnnotatorException::MESSAGE_TEMPLATES_NUMBER = 24;
 const char* AnnotatorException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
@@ -43,7 +43,8 @@ const char* AnnotatorException::MESSAGE_TEMPLATES[] = {
 /*19*/	"Error while writing '%s' output file.",
 /*20*/	"Error while indexing map.",
 /*21*/	"Error while annotating.",
-/*22*/	"Memory re-allocation error."
+/*22*/	"Memory re-allocation error.",
+/*23*/	"Output file '%s' must be tab-delimited to be indexed."
 };
 
 AnnotatorException::AnnotatorException() : Exception() {
@@ -26,7 +26,9 @@
 #include "AnnotatorException.h"
 #include "../../auxiliary/include/auxiliary.h"
 #include "../../reader/include/TextReader.h"
+#include "../../reader/include/ReaderFactory.h"
 #include "../../gwafile/include/GwaFile.h"
+#include "../../writer/include/WriterFactory.h"
 #include "../../intervaltree/include/IntervalTree.h"
 
 class Annotator {
@@ -35,7 +37,7 @@ private:
 	const char* regions_file;
 	const char* map_file;
 
-	TextReader reader;
+	Reader* reader;
 	TextReader regions_reader;
 	TextReader map_reader;
 
@@ -90,7 +92,7 @@ private:
 	void process_map_file_header() throw (AnnotatorException);
 	void process_map_file_data() throw (AnnotatorException);
 
-	void write_char_vector(ofstream &ofile_stream, vector<char*>* values, char separator) throw (ofstream::failure);
+	void write_char_vector(Writer* writer, vector<char*>* values, char separator) throw (WriterException);
 
 public:
 	static const unsigned int MAP_HEAP_SIZE;
@@ -23,9 +23,18 @@
 #include <iostream>
 #include <cctype>
 #include <cstdlib>
+#include <cstdio>
 #include <cstring>
+#include <cerrno>
+#include <climits>
 #include <cmath>
 #include <limits>
+#include <vector>
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
@@ -33,6 +42,10 @@ namespace auxiliary {
 
 	char* strtok(char** start, char separator);
 
+	char* strtok(char** start, char separator, bool quoted);
+
+	int split(char* line, char separator, vector<char*>& fields, int needed = INT_MAX, bool quoted = false);
+
 	int strcmp_ignore_case(const char* first, const char* second);
 
 	int strcmp_ignore_case(const char* first, const char* second, int n);
@@ -105,6 +118,14 @@ namespace auxiliary {
 		return 0;
 	}
 
+	double fast_strtod(const char* str, char** end_ptr);
+
+	long int fast_strtol(const char* str, char** end_ptr);
+
+	int format_double(char* buffer, double value, int precision);
+
+	unsigned long int memcount(const char* data, unsigned long int size, char character);
+
 	char* transform_file_name(char** new_file_name, const char* prefix, const char* file_name, const char* suffix, bool preserve_old_suffix);
 
 	double stats_mean(double* data, unsigned int size);
@@ -81,6 +81,19 @@ unsigned long int BitArray::get_total_bytes() {
 	return total_bytes;
 }
 
+/* the first size bits of the source are copied starting from the offset */
+void BitArray::merge(BitArray& source, unsigned long int offset, unsigned long int size) throw (BitArrayException) {
+	if (size > source.total_bytes * 8) {
+		size = source.total_bytes * 8;
+	}
+
+	for (unsigned long int i = 0u; i < size; ++i) {
+		if (source.get_bit(i) != 0x00) {
+			set_bit(offset + i);
+		}
+	}
+}
+
 void BitArray::filter(const double* data, double* filtered_data, unsigned long int size) throw (BitArrayException) {
 	unsigned long int upper_byte = bit_array_size >> 3;
 	unsigned long int current_chunk = 0;
@@ -47,6 +47,8 @@ public:
 	unsigned char get_bit(unsigned long int bit);
 	unsigned long int get_total_bytes();
 
+	void merge(BitArray& source, unsigned long int offset, unsigned long int size) throw (BitArrayException);
+
 	void filter(const double* data, double* filtered_data, unsigned long int size) throw (BitArrayException);
 };
 
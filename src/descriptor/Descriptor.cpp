@@ -49,13 +49,19 @@ const char* Descriptor::LD = "LD";
 const char* Descriptor::ANALYZE = "ANALYZE";
 const char* Descriptor::BOXPLOTWIDTH = "BOXPLOTWIDTH";
 const char* Descriptor::CASESENSITIVE = "CASESENSITIVE";
+const char* Descriptor::COMPRESSION = "COMPRESSION";
 const char* Descriptor::GC = "GC";
 const char* Descriptor::GENOMICCONTROL = "GENOMICCONTROL";
+const char* Descriptor::INDEX = "INDEX";
 const char* Descriptor::MISSING = "MISSING";
 const char* Descriptor::ORDER = "ORDER";
 const char* Descriptor::OUTFILE = "OUTFILE";
 const char* Descriptor::PREFIX = "PREFIX";
 const char* Descriptor::PROCESS = "PROCESS";
+const char* Descriptor::SHARDS = "SHARDS";
+const char* Descriptor::SHARD_THREADS = "SHARD_THREADS";
+const char* Descriptor::SKETCH = "SKETCH";
+const char* Descriptor::SORT_MEMORY = "SORT_MEMORY";
 const char* Descriptor::SEPARATOR = "SEPARATOR";
 const char* Descriptor::VERBOSITY = "VERBOSITY";
 const char* Descriptor::RENAME = "RENAME";
@@ -89,6 +95,11 @@ const char* Descriptor::TAB = "TAB";
 const char* Descriptor::TABULATION = "TABULATION";
 const char* Descriptor::WHITESPACE = "WHITESPACE";
 
+const char* Descriptor::TBI = "TBI";
+const char* Descriptor::CSI = "CSI";
+const char* Descriptor::GZIP = "GZIP";
+const char* Descriptor::BGZF = "BGZF";
+
 const char* Descriptor::ON_MODES[] = {"ON", "1"};
 const char* Descriptor::OFF_MODES[] = {"OFF", "0"};
 const char* Descriptor::LOW_MODES[] = {"LOW", "1"};
@@ -140,6 +151,7 @@ Descriptor::Descriptor(const char* full_path, Descriptor& file, char path_separa
 		copy(renamed_columns, file.renamed_columns);
 		copy(reordered_columns, file.reordered_columns);
 		copy(ld_files, file.ld_files);
+		copy(shards, file.shards);
 	} catch (DescriptorException &e) {
 		e.add_message("Descriptor", "Descriptor( const char*, Descriptor&, char )", __LINE__, 3);
 		throw;
@@ -188,12 +200,17 @@ Descriptor::~Descriptor() {
 		free(map_char_it->second);
 	}
 
+	for (vector_char_it = shards.begin(); vector_char_it != shards.end(); vector_char_it++) {
+		free((char*)*vector_char_it);
+	}
+
 	columns.clear();
 	properties.clear();
 	thresholds.clear();
 	renamed_columns.clear();
 	reordered_columns.clear();
 	ld_files.clear();
+	shards.clear();
 }
 
 char* Descriptor::extract_name(const char* full_path, char path_separator) throw (DescriptorException) {
@@ -264,6 +281,64 @@ char* Descriptor::extract_path(const char* full_path, char path_separator) throw
 	return file_path;
 }
 
+#ifndef WIN32
+/* a file name with wildcards becomes a set of shards; the name without the wildcards stays as the logical file name */
+void Descriptor::expand_shards() throw (DescriptorException) {
+	glob_t matches;
+	char* logical_path = NULL;
+	int length = 0;
+
+	if (strpbrk(full_path, "*?[") == NULL) {
+		return;
+	}
+
+	if (glob(full_path, 0, NULL, &matches) != 0) {
+		globfree(&matches);
+		return;
+	}
+
+	try {
+		for (size_t i = 0; i < matches.gl_pathc; i++) {
+			add_shard(matches.gl_pathv[i]);
+		}
+
+		logical_path = (char*)malloc((strlen(full_path) + 1) * sizeof(char));
+		if (logical_path == NULL) {
+			throw DescriptorException("Descriptor", "expand_shards()", __LINE__, 2, (strlen(full_path) + 1) * sizeof(char));
+		}
+
+		for (const char* symbol = full_path; *symbol != '\0'; symbol++) {
+			if (*symbol == '[') {
+				while ((*symbol != '\0') && (*symbol != ']')) {
+					symbol++;
+				}
+
+				if (*symbol == '\0') {
+					break;
+				}
+			} else if ((*symbol != '*') && (*symbol != '?')) {
+				logical_path[length++] = *symbol;
+			}
+		}
+		logical_path[length] = '\0';
+
+		if ((length <= 0) || (logical_path[length - 1] == path_separator)) {
+			free(logical_path);
+			throw DescriptorException("Descriptor", "expand_shards()", __LINE__, 24, full_path);
+		}
+
+		set_full_path(logical_path, path_separator);
+		free(logical_path);
+	} catch (DescriptorException &e) {
+		globfree(&matches);
+		e.add_message("Descriptor", "expand_shards()", __LINE__, 24, full_path);
+		throw;
+	}
+
+	globfree(&matches);
+}
+#endif
+
 void Descriptor::set_full_path(const char* full_path, char path_separator) throw (DescriptorException) {
 	if (full_path == NULL) {
 		throw DescriptorException("Descriptor", "set_name_and_paths( const char*, char )", __LINE__, 0, "full_path");
@@ -698,6 +773,22 @@ int Descriptor::get_ld_files_number() {
 	return ld_files.size();
 }
 
+vector<const char*>* Descriptor::get_shards() {
+	vector<const char*>* shards = new vector<const char*>();
+
+	vector_char_it = this->shards.begin();
+	while (vector_char_it != this->shards.end()) {
+		shards->push_back(*vector_char_it);
+		vector_char_it++;
+	}
+
+	return shards;
+}
+
+int Descriptor::get_shards_number() {
+	return shards.size();
+}
+
 void Descriptor::set_abbreviation(const char* abbreviation) throw (DescriptorException) {
 	if (abbreviation == NULL) {
 		throw DescriptorException("Descriptor", "set_abbreviation( const char* )", __LINE__, 0, "abbreviation");
@@ -833,6 +924,31 @@ void Descriptor::add_ld_file(const char* name, const char* path) throw (Descript
 	}
 }
 
+void Descriptor::add_shard(const char* path) throw (DescriptorException) {
+	char* path_copy = NULL;
+
+	try {
+		if (path == NULL) {
+			throw DescriptorException("Descriptor", "add_shard( const char* )", __LINE__, 0, "path");
+		}
+
+		if (strlen(path) <= 0) {
+			throw DescriptorException("Descriptor", "add_shard( const char* )", __LINE__, 1, "path");
+		}
+
+		path_copy = (char*)malloc((strlen(path) + 1) * sizeof(char));
+		if (path_copy == NULL) {
+			throw DescriptorException("Descriptor", "add_shard( const char* )", __LINE__, 2, (strlen(path) + 1) * sizeof(char));
+		}
+		strcpy(path_copy, path);
+
+		shards.push_back(path_copy);
+	} catch (DescriptorException &e) {
+		e.add_message("Descriptor", "add_shard( const char* )", __LINE__, 23);
+		throw;
+	}
+}
+
 bool Descriptor::remove_column(const char* common_name) throw (DescriptorException) {
 	try {
 		return remove(columns, common_name);
@@ -877,6 +993,14 @@ void Descriptor::remove_reordered_columns() {
 	reordered_columns.clear();
 }
 
+void Descriptor::remove_shards() {
+	for (vector_char_it = shards.begin(); vector_char_it != shards.end(); vector_char_it++) {
+		free((char*)*vector_char_it);
+	}
+
+	shards.clear();
+}
+
 bool Descriptor::remove_ld_file(const char* name) throw (DescriptorException) {
 	try {
 		return remove(ld_files, name);
@@ -1162,7 +1286,13 @@ vector<Descriptor*>* Descriptor::process_instructions(const char* script_name, c
 				} else if (strcmp(token, PROCESS) == 0) {
 					if (!tokens.empty()) {
 						new_descriptor = new Descriptor(tokens.front(), default_descriptor, path_separator);
+						default_descriptor.remove_shards();
 						tokens.pop_front();
+#ifndef WIN32
+						if (new_descriptor->get_shards_number() <= 0) {
+							new_descriptor->expand_shards();
+						}
+#endif
 
 						if ((!tokens.empty()) && (tokens.front()[0] != SCRIPT_COMMENT_SYMBOL)) {
 							new_descriptor->set_abbreviation(tokens.front());
@@ -1170,6 +1300,71 @@ vector<Descriptor*>* Descriptor::process_instructions(const char* script_name, c
 
 						descriptors->push_back(new_descriptor);
 					}
+				} else if (strcmp(token, SHARDS) == 0) {
+					if ((!tokens.empty()) && (tokens.front()[0] != SCRIPT_COMMENT_SYMBOL)) {
+						default_descriptor.remove_shards();
+
+						do {
+							default_descriptor.add_shard(tokens.front());
+							tokens.pop_front();
+						} while ((!tokens.empty()) && (tokens.front()[0] != SCRIPT_COMMENT_SYMBOL));
+					}
+				} else if (strcmp(token, SHARD_THREADS) == 0) {
+					if (!tokens.empty()) {
+						if (is_numeric(tokens.front()) && (atoi(tokens.front()) >= 1)) {
+							default_descriptor.add_property(SHARD_THREADS, tokens.front());
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), SHARD_THREADS);
+						}
+					}
+				} else if (strcmp(token, SKETCH) == 0) {
+					if (!tokens.empty()) {
+						if ((strcmp_ignore_case(tokens.front(), ON_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), ON_MODES[1]) == 0)) {
+							default_descriptor.add_property(SKETCH, ON_MODES[0]);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(SKETCH, OFF_MODES[0]);
+						} else if (is_numeric(tokens.front()) && (atof(tokens.front()) > 0.0) && (atof(tokens.front()) < 1.0)) {
+							default_descriptor.add_property(SKETCH, tokens.front());
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), SKETCH);
+						}
+					}
+				} else if (strcmp(token, SORT_MEMORY) == 0) {
+					if (!tokens.empty()) {
+						if (is_numeric(tokens.front()) && (atoi(tokens.front()) >= 1)) {
+							default_descriptor.add_property(SORT_MEMORY, tokens.front());
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), SORT_MEMORY);
+						}
+					}
+				} else if (strcmp(token, INDEX) == 0) {
+					if (!tokens.empty()) {
+						if (strcmp_ignore_case(tokens.front(), TBI) == 0) {
+							default_descriptor.add_property(INDEX, TBI);
+						} else if (strcmp_ignore_case(tokens.front(), CSI) == 0) {
+							default_descriptor.add_property(INDEX, CSI);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(INDEX, OFF_MODES[0]);
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), INDEX);
+						}
+					}
+				} else if (strcmp(token, COMPRESSION) == 0) {
+					if (!tokens.empty()) {
+						if (strcmp_ignore_case(tokens.front(), GZIP) == 0) {
+							default_descriptor.add_property(COMPRESSION, GZIP);
+						} else if (strcmp_ignore_case(tokens.front(), BGZF) == 0) {
+							default_descriptor.add_property(COMPRESSION, BGZF);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(COMPRESSION, OFF_MODES[0]);
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), COMPRESSION);
+						}
+					}
 				} else if (strcmp(token, SEPARATOR) == 0) {
 					if (!tokens.empty()) {
 						if ((strcmp_ignore_case(tokens.front(), COMMA) == 0) ||
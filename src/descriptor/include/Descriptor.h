@@ -34,6 +34,10 @@
 #include <cctype>
 #include <string.h>
 
+#ifndef WIN32
+#include <glob.h>
+#endif
+
 #include "../../auxiliary/include/auxiliary.h"
 #include "../../reader/include/ReaderFactory.h"
 #include "DescriptorException.h"
@@ -63,6 +67,7 @@ private:
 	map<const char* const, char*, bool(*)(const char*, const char*)> renamed_columns;
 	vector<const char*> reordered_columns;
 	map<const char* const, char*, bool(*)(const char*, const char*)> ld_files;
+	vector<const char*> shards;
 
 	map<const char* const, char*, bool(*)(const char*, const char*)>::iterator map_char_it;
 	map<const char* const, vector<double>*, bool(*)(const char*, const char*)>::iterator map_vect_it;
@@ -71,6 +76,9 @@ private:
 
 	char* extract_name(const char* full_path, char path_separator) throw (DescriptorException);
 	char* extract_path(const char* full_path, char path_separator) throw (DescriptorException);
+#ifndef WIN32
+	void expand_shards() throw (DescriptorException);
+#endif
 
 	vector<double>* get(map<const char* const, vector<double>*, bool(*)(const char*, const char*)>& map, const char* key) throw (DescriptorException);
 	const char* get(map<const char* const, char*, bool(*)(const char*, const char*)>& map, const char* key) throw (DescriptorException);
@@ -120,13 +128,19 @@ public:
 	static const char* ANALYZE;
 	static const char* BOXPLOTWIDTH;
 	static const char* CASESENSITIVE;
+	static const char* COMPRESSION;
 	static const char* GC;
 	static const char* GENOMICCONTROL;
+	static const char* INDEX;
 	static const char* MISSING;
 	static const char* ORDER;
 	static const char* OUTFILE;
 	static const char* PREFIX;
 	static const char* PROCESS;
+	static const char* SHARDS;
+	static const char* SHARD_THREADS;
+	static const char* SKETCH;
+	static const char* SORT_MEMORY;
 	static const char* SEPARATOR;
 	static const char* VERBOSITY;
 	static const char* RENAME;
@@ -160,6 +174,11 @@ public:
 	static const char* TABULATION;
 	static const char* WHITESPACE;
 
+	static const char* TBI;
+	static const char* CSI;
+	static const char* GZIP;
+	static const char* BGZF;
+
 	static const char* ON_MODES[];
 	static const char* OFF_MODES[];
 	static const char* LOW_MODES[];
@@ -185,11 +204,13 @@ public:
 	vector<const char*>* get_reordered_columns();
 	const char* get_ld_file(const char* name) throw (DescriptorException);
 	vector<const char*>* get_ld_files();
+	vector<const char*>* get_shards();
 	int get_columns_number();
 	int get_properties_number();
 	int get_thresholds_number();
 	int get_reordered_columns_number();
 	int get_ld_files_number();
+	int get_shards_number();
 
 	void set_full_path(const char* full_path, char path_separator = DEFAULT_PATH_SEPARATOR) throw (DescriptorException);
 
@@ -203,6 +224,7 @@ public:
 	void add_renamed_column(const char* name, const char* new_name) throw (DescriptorException);
 	void add_reordered_column(const char* name) throw (DescriptorException);
 	void add_ld_file(const char* name, const char* path) throw (DescriptorException);
+	void add_shard(const char* path) throw (DescriptorException);
 
 	bool remove_column(const char* common_name) throw (DescriptorException);
 	bool remove_property(const char* name) throw (DescriptorException);
@@ -210,6 +232,7 @@ public:
 	bool remove_renamed_column(const char* name) throw (DescriptorException);
 	void remove_reordered_columns();
 	bool remove_ld_file(const char* name) throw (DescriptorException);
+	void remove_shards();
 
 	static vector<Descriptor*>* process_instructions(const char* script_name, char path_separator = DEFAULT_PATH_SEPARATOR) throw (DescriptorException);
 
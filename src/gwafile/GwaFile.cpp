@@ -19,7 +19,7 @@
 
 #include "include/GwaFile.h"
 
-GwaFile::GwaFile(Descriptor* descriptor) throw (GwaFileException) : descriptor(descriptor) {
+GwaFile::GwaFile(Descriptor* descriptor) throw (GwaFileException) : descriptor(descriptor), probe(NULL), quoted(false), index_format(NULL), compression(NULL) {
 	if (descriptor == NULL) {
 		throw GwaFileException("GwaFile", "GwaFile( Descriptor* )", __LINE__, 0, "descriptor");
 	}
@@ -35,7 +35,7 @@ GwaFile::GwaFile(Descriptor* descriptor) throw (GwaFileException) : descriptor(d
 	check_genomiccontrol(descriptor);
 }
 
-GwaFile::GwaFile(Descriptor* descriptor, void (GwaFile::*check_functions[])(Descriptor*), unsigned int check_functions_number) throw (GwaFileException): descriptor(descriptor)  {
+GwaFile::GwaFile(Descriptor* descriptor, void (GwaFile::*check_functions[])(Descriptor*), unsigned int check_functions_number) throw (GwaFileException): descriptor(descriptor), probe(NULL), quoted(false), index_format(NULL), compression(NULL)  {
 	if (descriptor == NULL) {
 		throw GwaFileException("GwaFile", "GwaFile( Descriptor* )", __LINE__, 0, "descriptor");
 	}
@@ -47,12 +47,93 @@ GwaFile::GwaFile(Descriptor* descriptor, void (GwaFile::*check_functions[])(Desc
 
 GwaFile::~GwaFile() {
 	descriptor = NULL;
+
+	if (probe != NULL) {
+		delete probe;
+		probe = NULL;
+	}
 }
 
 Descriptor* GwaFile::get_descriptor() {
 	return descriptor;
 }
 
+/* the input is probed once, and again only if it was modified since; a sharded input is probed through its first shard */
+FileProbe* GwaFile::get_probe() throw (GwaFileException) {
+	vector<const char*>* shards = NULL;
+
+	try {
+		if (probe == NULL) {
+			probe = new FileProbe();
+		}
+
+		if (descriptor->get_shards_number() > 0) {
+			shards = descriptor->get_shards();
+			if (!probe->is_current(shards->front())) {
+				probe->probe(shards->front());
+			}
+			delete shards;
+		} else if (!probe->is_current(descriptor->get_full_path())) {
+			probe->probe(descriptor->get_full_path());
+		}
+	} catch (Exception &e) {
+		if (shards != NULL) {
+			delete shards;
+		}
+
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "get_probe()", __LINE__, 16, descriptor->get_full_path());
+		throw new_e;
+	}
+
+	return probe;
+}
+
+/* sharded inputs are read back to back as one file */
+Reader* GwaFile::create_reader() throw (GwaFileException) {
+	ShardReader* shard_reader = NULL;
+	Reader* reader = NULL;
+	vector<const char*>* shards = NULL;
+	vector<const char*>::iterator shards_it;
+	const char* shard_threads = NULL;
+
+	try {
+		if (descriptor->get_shards_number() > 0) {
+			shard_reader = new ShardReader();
+			reader = shard_reader;
+
+			shards = descriptor->get_shards();
+			for (shards_it = shards->begin(); shards_it != shards->end(); shards_it++) {
+				shard_reader->add_shard(*shards_it);
+			}
+			delete shards;
+			shards = NULL;
+
+			if ((shard_threads = descriptor->get_property(Descriptor::SHARD_THREADS)) != NULL) {
+				shard_reader->set_parallel_shards(atoi(shard_threads));
+			}
+		} else {
+			reader = ReaderFactory::create(get_probe());
+		}
+
+		reader->set_file_name(descriptor->get_full_path());
+	} catch (Exception &e) {
+		if (shards != NULL) {
+			delete shards;
+		}
+
+		if (reader != NULL) {
+			delete reader;
+		}
+
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "create_reader()", __LINE__, 17, descriptor->get_full_path());
+		throw new_e;
+	}
+
+	return reader;
+}
+
 bool GwaFile::is_case_sensitive() {
 	return casesensitive;
 }
@@ -81,6 +162,10 @@ char GwaFile::get_data_separator() {
 	return data_separator;
 }
 
+bool GwaFile::is_quoted() {
+	return quoted;
+}
+
 unsigned long int GwaFile::get_estimated_size() {
 	return estimated_size;
 }
@@ -97,6 +182,16 @@ bool GwaFile::is_regions_append_on() {
 	return regions_append_on;
 }
 
+/* Descriptor::TBI or Descriptor::CSI if the output is indexed; NULL otherwise */
+const char* GwaFile::get_index_format() {
+	return index_format;
+}
+
+/* indexed output is always BGZF compressed */
+const char* GwaFile::get_compression() {
+	return index_format != NULL ? Descriptor::BGZF : compression;
+}
+
 char GwaFile::get_map_file_header_separartor() {
 	return map_file_header_separator;
 }
@@ -345,14 +440,7 @@ void GwaFile::check_separators(Descriptor* descriptor) throw (GwaFileException)
 
 	try {
 		if ((separator_name = descriptor->get_property(Descriptor::SEPARATOR)) == NULL) {
-			Reader* reader = NULL;
-
-			reader = ReaderFactory::create(descriptor->get_full_path());
-			reader->detect_field_separators(&header_separator, &data_separator);
-			reader->close();
-
-			delete reader;
-			reader = NULL;
+			get_probe()->get_field_separators(&header_separator, &data_separator);
 		} else if ((strcmp_ignore_case(separator_name, Descriptor::COMMA) == 0) ||
 				(strcmp_ignore_case(separator_name, Descriptor::COMMAS) == 0)) {
 			header_separator = ',';
@@ -368,6 +456,9 @@ void GwaFile::check_separators(Descriptor* descriptor) throw (GwaFileException)
 			header_separator = ' ';
 			data_separator = ' ';
 		}
+
+		/* quoting is probed also when the separator is given */
+		quoted = get_probe()->is_quoted();
 	} catch (Exception &e) {
 		GwaFileException new_e(e);
 		new_e.add_message("GwaFile", "check_separators( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
@@ -376,12 +467,26 @@ void GwaFile::check_separators(Descriptor* descriptor) throw (GwaFileException)
 }
 
 void GwaFile::check_filesize(Descriptor* descriptor) throw (GwaFileException) {
+	FileProbe shard_probe;
+	vector<const char*>* shards = NULL;
+
 	try {
-		TextReader reader;
-		reader.set_file_name(descriptor->get_full_path());
-		estimated_size = reader.estimate_lines_count();
-		reader.close();
+		estimated_size = get_probe()->get_estimated_lines_count();
+
+		if (descriptor->get_shards_number() > 1) {
+			shards = descriptor->get_shards();
+			for (unsigned int i = 1u; i < shards->size(); i++) {
+				shard_probe.probe(shards->at(i));
+				estimated_size += shard_probe.get_estimated_lines_count();
+			}
+			delete shards;
+			shards = NULL;
+		}
 	} catch (Exception &e) {
+		if (shards != NULL) {
+			delete shards;
+		}
+
 		GwaFileException new_e(e);
 		new_e.add_message("GwaFile", "check_filesize( Descriptor* )", __LINE__, 11, descriptor->get_full_path());
 		throw new_e;
@@ -534,6 +639,52 @@ void GwaFile::check_regions_append(Descriptor* descriptor) throw (GwaFileExcepti
 	}
 }
 
+void GwaFile::check_index(Descriptor* descriptor) throw (GwaFileException) {
+	const char* index = NULL;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_index( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		index_format = NULL;
+		if ((index = descriptor->get_property(Descriptor::INDEX)) == NULL) {
+			descriptor->add_property(Descriptor::INDEX, Descriptor::OFF_MODES[0]);
+		} else if (strcmp_ignore_case(index, Descriptor::TBI) == 0) {
+			index_format = Descriptor::TBI;
+		} else if (strcmp_ignore_case(index, Descriptor::CSI) == 0) {
+			index_format = Descriptor::CSI;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_index( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
+void GwaFile::check_compression(Descriptor* descriptor) throw (GwaFileException) {
+	const char* compression_name = NULL;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_compression( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		compression = NULL;
+		if ((compression_name = descriptor->get_property(Descriptor::COMPRESSION)) == NULL) {
+			descriptor->add_property(Descriptor::COMPRESSION, Descriptor::OFF_MODES[0]);
+		} else if (strcmp_ignore_case(compression_name, Descriptor::GZIP) == 0) {
+			compression = Descriptor::GZIP;
+		} else if (strcmp_ignore_case(compression_name, Descriptor::BGZF) == 0) {
+			compression = Descriptor::BGZF;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_compression( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
 void GwaFile::check_map_file_separators(Descriptor* descriptor) throw (GwaFileException) {
 	const char* map_file = NULL;
 	const char* separator_name = NULL;
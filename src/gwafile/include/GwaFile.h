@@ -28,6 +28,7 @@
 class GwaFile {
 private:
 	Descriptor* descriptor;
+	FileProbe* probe;
 
 	bool casesensitive;
 	bool high_verbosity;
@@ -36,10 +37,13 @@ private:
 	double inflation_factor;
 	char header_separator;
 	char data_separator;
+	bool quoted;
 	unsigned long int estimated_size;
 	char regions_file_header_separator;
 	char regions_file_data_separator;
 	bool regions_append_on;
+	const char* index_format;
+	const char* compression;
 	char map_file_header_separator;
 	char map_file_data_separator;
 	char ld_file_header_separator;
@@ -51,6 +55,8 @@ public:
 	virtual ~GwaFile();
 
 	Descriptor* get_descriptor();
+	FileProbe* get_probe() throw (GwaFileException);
+	Reader* create_reader() throw (GwaFileException);
 	bool is_case_sensitive();
 	bool is_high_verbosity();
 	bool is_order_on();
@@ -58,10 +64,13 @@ public:
 	double get_inflation_factor();
 	char get_header_separator();
 	char get_data_separator();
+	bool is_quoted();
 	unsigned long int get_estimated_size();
 	char get_regions_file_header_separator();
 	char get_regions_file_data_separator();
 	bool is_regions_append_on();
+	const char* get_index_format();
+	const char* get_compression();
 	char get_map_file_header_separartor();
 	char get_map_file_data_separator();
 	char get_ld_file_header_separator();
@@ -81,6 +90,8 @@ public:
 	void check_regions_file_separators(Descriptor* descriptor) throw (GwaFileException);
 	void check_regions_deviation(Descriptor* descriptor) throw (GwaFileException);
 	void check_regions_append(Descriptor* descriptor) throw (GwaFileException);
+	void check_index(Descriptor* descriptor) throw (GwaFileException);
+	void check_compression(Descriptor* descriptor) throw (GwaFileException);
 	void check_map_file_separators(Descriptor* descriptor) throw (GwaFileException);
 	void check_ld_files(Descriptor* descriptor) throw (GwaFileException);
 	void check_ld_files_separators(Descriptor* descriptor) throw (GwaFileException);
@@ -29,6 +29,8 @@
 #include <Rmath.h>
 
 #include "ColumnException.h"
+#include "../../../auxiliary/include/auxiliary.h"
+#include "../../../writer/include/Writer.h"
 
 using namespace std;
 
@@ -58,7 +60,7 @@ public:
 	void set_order(int order);
 	int get_order();
 
-	virtual void out(ofstream& output_stream) throw (ofstream::failure);
+	virtual void out(Writer* writer) throw (WriterException);
 };
 
 #endif
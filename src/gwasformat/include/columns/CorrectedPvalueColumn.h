@@ -31,7 +31,7 @@ public:
 	CorrectedPvalueColumn(Column* pvalue_column, double lambda);
 	virtual ~CorrectedPvalueColumn();
 
-	void out(ofstream& output_stream) throw (ofstream::failure);
+	void out(Writer* writer) throw (WriterException);
 };
 
 #endif
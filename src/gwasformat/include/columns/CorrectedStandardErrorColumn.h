@@ -32,7 +32,7 @@ public:
 	CorrectedStandardErrorColumn(Column* stderr_column, double lambda);
 	virtual ~CorrectedStandardErrorColumn();
 
-	void out(ofstream& output_stream) throw (ofstream::failure);
+	void out(Writer* writer) throw (WriterException);
 };
 
 #endif
@@ -36,7 +36,7 @@ public:
 	EffectiveSampleSizeColumn(Column* n_total_column, Column* oevar_imp_column);
 	virtual ~EffectiveSampleSizeColumn();
 
-	void out(ofstream& output_stream) throw (ofstream::failure);
+	void out(Writer* writer) throw (WriterException);
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include "../../../auxiliary/include/auxiliary.h"
 #include "../../../reader/include/TextReader.h"
 #include "../../../gwafile/include/GwaFile.h"
+#include "../../../writer/include/WriterFactory.h"
 #include "../columns/Column.h"
 #include "../columns/CorrectedPvalueColumn.h"
 #include "../columns/CorrectedStandardErrorColumn.h"
@@ -38,7 +39,7 @@
 
 class Formatter {
 private:
-	TextReader reader;
+	Reader* reader;
 	GwaFile* gwafile;
 
 	vector<Column*> input_columns;
@@ -50,6 +51,8 @@ private:
 	Column* stderr_column;
 	Column* n_total_column;
 	Column* oevar_imp_column;
+	Column* chr_column;
+	Column* position_column;
 
 	int pvalue_column_pos;
 	int maf_column_pos;
@@ -57,6 +60,7 @@ private:
 
 	static bool compare_columns(Column* first, Column* second);
 	static bool compare_columns_by_name(Column* first, Column* second);
+	static long int get_index_position(const char* value);
 
 public:
 	static const unsigned int HEAP_SIZE;
@@ -76,7 +76,7 @@ char* Column::get_value() {
 }
 
 double Column::get_numeric_value() {
-	numeric_value = R_strtod(char_value, &end_ptr);
+	numeric_value = auxiliary::fast_strtod(char_value, &end_ptr);
 	if ((*end_ptr != '\0') || (ISNAN(numeric_value))) {
 		return numeric_limits<double>::quiet_NaN();
 	}
@@ -91,6 +91,9 @@ int Column::get_order() {
 	return order;
 }
 
-void Column::out(ofstream& output_stream) throw (ofstream::failure) {
-	output_stream << char_value;
+void Column::out(Writer* writer) throw (WriterException) {
+	if (char_value == NULL) {
+		throw WriterException("Column", "out( Writer* )", __LINE__, 4, writer->get_file_name());
+	}
+	writer->put_str(char_value);
 }
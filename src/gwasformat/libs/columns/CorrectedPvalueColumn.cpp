@@ -28,14 +28,14 @@ CorrectedPvalueColumn::~CorrectedPvalueColumn() {
 	pvalue_column = NULL;
 }
 
-void CorrectedPvalueColumn::out(ofstream& output_stream) throw (ofstream::failure) {
-	numeric_value = R_strtod(pvalue_column->char_value, &end_ptr);
+void CorrectedPvalueColumn::out(Writer* writer) throw (WriterException) {
+	numeric_value = auxiliary::fast_strtod(pvalue_column->char_value, &end_ptr);
 	if ((*end_ptr != '\0') || (ISNAN(numeric_value))) {
-		output_stream << "NA";
+		writer->put_str("NA");
 	} else {
 		if (lambda > 1.0) {
 			numeric_value = Rf_pchisq((Rf_qchisq(numeric_value, 1, 0, 0) / lambda), 1, 0, 0);
 		}
-		output_stream << numeric_value;
+		writer->put_double(numeric_value, numeric_limits<double>::digits10);
 	}
 }
@@ -28,14 +28,14 @@ CorrectedStandardErrorColumn::~CorrectedStandardErrorColumn() {
 	stderr_column = NULL;
 }
 
-void CorrectedStandardErrorColumn::out(ofstream& output_stream) throw (ofstream::failure) {
-	numeric_value = R_strtod(stderr_column->char_value, &end_ptr);
+void CorrectedStandardErrorColumn::out(Writer* writer) throw (WriterException) {
+	numeric_value = auxiliary::fast_strtod(stderr_column->char_value, &end_ptr);
 	if ((*end_ptr != '\0') || (ISNAN(numeric_value))) {
-		output_stream << "NA";
+		writer->put_str("NA");
 	} else {
 		if (lambda > 1.0) {
 			numeric_value = numeric_value * sqrt_lambda;
 		}
-		output_stream << numeric_value;
+		writer->put_double(numeric_value, numeric_limits<double>::digits10);
 	}
 }
@@ -30,17 +30,17 @@ EffectiveSampleSizeColumn::~EffectiveSampleSizeColumn() {
 	oevar_imp_column = NULL;
 }
 
-void EffectiveSampleSizeColumn::out(ofstream& output_stream) throw (ofstream::failure) {
-	n_total = R_strtod(n_total_column->char_value, &end_ptr);
+void EffectiveSampleSizeColumn::out(Writer* writer) throw (WriterException) {
+	n_total = auxiliary::fast_strtod(n_total_column->char_value, &end_ptr);
 	if ((*end_ptr != '\0') || (ISNAN(n_total))) {
-		output_stream << "NA";
+		writer->put_str("NA");
 	} else {
-		oevar_imp = R_strtod(oevar_imp_column->char_value, &end_ptr);
+		oevar_imp = auxiliary::fast_strtod(oevar_imp_column->char_value, &end_ptr);
 		if ((*end_ptr != '\0') || (ISNAN(oevar_imp))) {
-			output_stream << "NA";
+			writer->put_str("NA");
 		} else {
 			n_total = n_total * oevar_imp;
-			output_stream << n_total;
+			writer->put_double(n_total, numeric_limits<double>::digits10);
 		}
 	}
 }
@@ -23,7 +23,7 @@ const unsigned int Formatter::HEAP_SIZE = 3500000;
 const unsigned int Formatter::HEAP_INCREMENT = 100000;
 const double Formatter::EPSILON = 0.00000001;
 
-Formatter::Formatter() : gwafile(NULL), maf_column(NULL), pvalue_column(NULL),
+Formatter::Formatter() : reader(NULL), gwafile(NULL), maf_column(NULL), pvalue_column(NULL),
 	stderr_column(NULL), n_total_column(NULL), oevar_imp_column(NULL),
 	pvalue_column_pos(numeric_limits<int>::min()),
 	maf_column_pos(numeric_limits<int>::min()),
@@ -32,6 +32,11 @@ Formatter::Formatter() : gwafile(NULL), maf_column(NULL), pvalue_column(NULL),
 }
 
 Formatter::~Formatter() {
+	if (reader != NULL) {
+		delete reader;
+		reader = NULL;
+	}
+
 	gwafile = NULL;
 
 	input_columns.clear();
@@ -46,6 +51,8 @@ Formatter::~Formatter() {
 	stderr_column = NULL;
 	n_total_column = NULL;
 	oevar_imp_column = NULL;
+	chr_column = NULL;
+	position_column = NULL;
 
 	pvalue_column_pos = numeric_limits<int>::min();
 	maf_column_pos = numeric_limits<int>::min();
@@ -56,6 +63,23 @@ bool Formatter::compare_columns(Column* first, Column* second) {
 	return (first->get_order() < second->get_order());
 }
 
+/* non-numeric positions are not indexed */
+long int Formatter::get_index_position(const char* value) {
+	char* end_ptr = NULL;
+	long int position = 0l;
+
+	if (value == NULL) {
+		return -1l;
+	}
+
+	position = auxiliary::fast_strtol(value, &end_ptr);
+	if ((end_ptr == value) || (*end_ptr != '\0')) {
+		return -1l;
+	}
+
+	return position;
+}
+
 bool Formatter::compare_columns_by_name(Column* first, Column* second) {
 	return (strcmp(first->get_header(), second->get_header()) < 0);
 }
@@ -68,12 +92,16 @@ void Formatter::open_gwafile(GwaFile* gwafile) throw (FormatterException) {
 	try {
 		close_gwafile();
 		this->gwafile = gwafile;
-		reader.set_file_name(gwafile->get_descriptor()->get_full_path());
-		reader.open();
+		reader = gwafile->create_reader();
+		reader->open();
 	} catch (ReaderException& e) {
 		FormatterException new_e(e);
 		new_e.add_message("Formatter", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
 		throw new_e;
+	} catch (GwaFileException& e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
 	} catch (FormatterException& e) {
 		e.add_message("Formatter", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
 		throw;
@@ -82,7 +110,12 @@ void Formatter::open_gwafile(GwaFile* gwafile) throw (FormatterException) {
 
 void Formatter::close_gwafile() throw (FormatterException) {
 	try {
-		reader.close();
+		if (reader != NULL) {
+			reader->close();
+
+			delete reader;
+			reader = NULL;
+		}
 	} catch (ReaderException &e) {
 		FormatterException new_e(e);
 		new_e.add_message("Formatter", "close_gwafile()", __LINE__, 4, gwafile != NULL ? gwafile->get_descriptor()->get_full_path() : "NULL");
@@ -103,6 +136,8 @@ void Formatter::close_gwafile() throw (FormatterException) {
 	stderr_column = NULL;
 	n_total_column = NULL;
 	oevar_imp_column = NULL;
+	chr_column = NULL;
+	position_column = NULL;
 
 	pvalue_column_pos = numeric_limits<int>::min();
 	maf_column_pos = numeric_limits<int>::min();
@@ -125,15 +160,15 @@ void Formatter::process_header() throw (FormatterException) {
 	}
 
 	try {
-		if (reader.read_line() <= 0) {
+		if (reader->read_line() <= 0) {
 			throw FormatterException("Formatter", "process_header()", __LINE__, 5, gwafile->get_descriptor()->get_name());
 		}
 
 		descriptor = gwafile->get_descriptor();
 		header_separator = gwafile->get_header_separator();
-		header = *reader.line;
+		header = *(reader->line);
 
-		token = auxiliary::strtok(&header, header_separator);
+		token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 		while (token != NULL) {
 			column = new Column();
 
@@ -146,7 +181,9 @@ void Formatter::process_header() throw (FormatterException) {
 			if (column_name != NULL) {
 				if (strcmp(column_name, Descriptor::MARKER) == 0) {
 				} else if (strcmp(column_name, Descriptor::CHR) == 0) {
+					chr_column = column;
 				} else if (strcmp(column_name, Descriptor::POSITION) == 0) {
+					position_column = column;
 				} else if (strcmp(column_name, Descriptor::ALLELE1) == 0) {
 				} else if (strcmp(column_name, Descriptor::ALLELE2) == 0) {
 				} else if (strcmp(column_name, Descriptor::STRAND) == 0) {
@@ -177,7 +214,7 @@ void Formatter::process_header() throw (FormatterException) {
 
 			input_columns.push_back(column);
 
-			token = auxiliary::strtok(&header, header_separator);
+			token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 			column_position += 1;
 		}
 	} catch (ReaderException &e) {
@@ -205,11 +242,11 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 	bool maf_filter = false;
 	bool oevar_imp_filter = false;
 
-	char* token = NULL;
+	vector<char*> fields;
+	int fields_number = 0;
 	char* pvalue_token = NULL;
 	char* maf_token = NULL;
 	char* oevar_imp_token = NULL;
-	int column_position = 0;
 
 	char* end_ptr = NULL;
 	double d_value = 0.0;
@@ -249,26 +286,13 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 		if (maf_filter) {
 			if (oevar_imp_filter) {
 				// all filters
-				while ((line_length = reader.read_line()) > 0) {
-					line = *reader.line;
-
-					column_position = 0;
-					pvalue_token = NULL;
-					maf_token = NULL;
-					oevar_imp_token = NULL;
-					token = auxiliary::strtok(&line, data_separator);
-					while (token != NULL) {
-						if (column_position == pvalue_column_pos) {
-							pvalue_token = token;
-						} else if (column_position == maf_column_pos) {
-							maf_token = token;
-						} else if (column_position == oevar_imp_column_pos) {
-							oevar_imp_token = token;
-						}
+				while ((line_length = reader->read_line()) > 0) {
+					line = *(reader->line);
 
-						token = auxiliary::strtok(&line, data_separator);
-						column_position += 1;
-					}
+					fields_number = auxiliary::split(line, data_separator, fields, INT_MAX, gwafile->is_quoted());
+					pvalue_token = pvalue_column_pos < fields_number ? fields[pvalue_column_pos] : NULL;
+					maf_token = maf_column_pos < fields_number ? fields[maf_column_pos] : NULL;
+					oevar_imp_token = oevar_imp_column_pos < fields_number ? fields[oevar_imp_column_pos] : NULL;
 
 					if (pvalue_token == NULL) {
 						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
@@ -282,7 +306,7 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, oevar_imp_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
 					}
 
-					d_value = R_strtod(maf_token, &end_ptr);
+					d_value = auxiliary::fast_strtod(maf_token, &end_ptr);
 					if ((*end_ptr != '\0') || (ISNAN(d_value))) {
 						line_number += 1;
 						continue;
@@ -291,14 +315,14 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 					d_value = d_value > 0.5 ? 1.0 - d_value : d_value;
 
 					if (auxiliary::fcmp(d_value, maf_filter_value, EPSILON) == 1) {
-						d_value = R_strtod(oevar_imp_token, &end_ptr);
+						d_value = auxiliary::fast_strtod(oevar_imp_token, &end_ptr);
 						if ((*end_ptr != '\0') || (ISNAN(d_value))) {
 							line_number += 1;
 							continue;
 						}
 
 						if (auxiliary::fcmp(d_value, oevar_imp_filter_value, EPSILON) == 1) {
-							d_value = R_strtod(pvalue_token, &end_ptr);
+							d_value = auxiliary::fast_strtod(pvalue_token, &end_ptr);
 							if ((*end_ptr != '\0') || (ISNAN(d_value))) {
 								line_number += 1;
 								continue;
@@ -325,23 +349,12 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 				}
 			} else {
 				// only maf filter
-				while ((line_length = reader.read_line()) > 0) {
-					line = *reader.line;
-
-					column_position = 0;
-					pvalue_token = NULL;
-					maf_token = NULL;
-					token = auxiliary::strtok(&line, data_separator);
-					while (token != NULL) {
-						if (column_position == pvalue_column_pos) {
-							pvalue_token = token;
-						} else if (column_position == maf_column_pos) {
-							maf_token = token;
-						}
+				while ((line_length = reader->read_line()) > 0) {
+					line = *(reader->line);
 
-						token = auxiliary::strtok(&line, data_separator);
-						column_position += 1;
-					}
+					fields_number = auxiliary::split(line, data_separator, fields, INT_MAX, gwafile->is_quoted());
+					pvalue_token = pvalue_column_pos < fields_number ? fields[pvalue_column_pos] : NULL;
+					maf_token = maf_column_pos < fields_number ? fields[maf_column_pos] : NULL;
 
 					if (pvalue_token == NULL) {
 						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
@@ -351,7 +364,7 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, maf_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
 					}
 
-					d_value = R_strtod(maf_token, &end_ptr);
+					d_value = auxiliary::fast_strtod(maf_token, &end_ptr);
 					if ((*end_ptr != '\0') || (ISNAN(d_value))) {
 						line_number += 1;
 						continue;
@@ -360,7 +373,7 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 					d_value = d_value > 0.5 ? 1.0 - d_value : d_value;
 
 					if (auxiliary::fcmp(d_value, maf_filter_value, EPSILON) == 1) {
-						d_value = R_strtod(pvalue_token, &end_ptr);
+						d_value = auxiliary::fast_strtod(pvalue_token, &end_ptr);
 						if ((*end_ptr != '\0') || (ISNAN(d_value))) {
 							line_number += 1;
 							continue;
@@ -387,23 +400,12 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 			}
 		} else if (oevar_imp_filter) {
 			// only oevar_imp_filter
-			while ((line_length = reader.read_line()) > 0) {
-				line = *reader.line;
-
-				column_position = 0;
-				pvalue_token = NULL;
-				oevar_imp_token = NULL;
-				token = auxiliary::strtok(&line, data_separator);
-				while (token != NULL) {
-					if (column_position == pvalue_column_pos) {
-						pvalue_token = token;
-					} else if (column_position == oevar_imp_column_pos) {
-						oevar_imp_token = token;
-					}
+			while ((line_length = reader->read_line()) > 0) {
+				line = *(reader->line);
 
-					token = auxiliary::strtok(&line, data_separator);
-					column_position += 1;
-				}
+				fields_number = auxiliary::split(line, data_separator, fields, INT_MAX, gwafile->is_quoted());
+				pvalue_token = pvalue_column_pos < fields_number ? fields[pvalue_column_pos] : NULL;
+				oevar_imp_token = oevar_imp_column_pos < fields_number ? fields[oevar_imp_column_pos] : NULL;
 
 				if (pvalue_token == NULL) {
 					throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
@@ -413,14 +415,14 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 					throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, oevar_imp_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
 				}
 
-				d_value = R_strtod(oevar_imp_token, &end_ptr);
+				d_value = auxiliary::fast_strtod(oevar_imp_token, &end_ptr);
 				if ((*end_ptr != '\0') || (ISNAN(d_value))) {
 					line_number += 1;
 					continue;
 				}
 
 				if (auxiliary::fcmp(d_value, oevar_imp_filter_value, EPSILON) == 1) {
-					d_value = R_strtod(pvalue_token, &end_ptr);
+					d_value = auxiliary::fast_strtod(pvalue_token, &end_ptr);
 					if ((*end_ptr != '\0') || (ISNAN(d_value))) {
 						line_number += 1;
 						continue;
@@ -446,27 +448,17 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 			}
 		} else {
 			// no filters
-			while ((line_length = reader.read_line()) > 0) {
-				line = *reader.line;
-
-				column_position = 0;
-				pvalue_token = NULL;
-				token = auxiliary::strtok(&line, data_separator);
-				while (token != NULL) {
-					if (column_position == pvalue_column_pos) {
-						pvalue_token = token;
-						break;
-					}
+			while ((line_length = reader->read_line()) > 0) {
+				line = *(reader->line);
 
-					token = auxiliary::strtok(&line, data_separator);
-					column_position += 1;
-				}
+				fields_number = auxiliary::split(line, data_separator, fields, INT_MAX, gwafile->is_quoted());
+				pvalue_token = pvalue_column_pos < fields_number ? fields[pvalue_column_pos] : NULL;
 
 				if (pvalue_token == NULL) {
 					throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
 				}
 
-				d_value = R_strtod(pvalue_token, &end_ptr);
+				d_value = auxiliary::fast_strtod(pvalue_token, &end_ptr);
 				if ((*end_ptr != '\0') || (ISNAN(d_value))) {
 					line_number += 1;
 					continue;
@@ -498,8 +490,8 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 			throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 7, line_number, gwafile->get_descriptor()->get_name());
 		}
 
-		reader.reset();
-		if (reader.read_line() <= 0) {
+		reader->reset();
+		if (reader->read_line() <= 0) {
 			throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 5, line_number, gwafile->get_descriptor()->get_name());
 		}
 	} catch (DescriptorException &e) {
@@ -542,6 +534,10 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 	const char* output_prefix = NULL;
 	const char* file_name = NULL;
 	char* o_gwafile_name = NULL;
+	const char* index_format = NULL;
+	const char* compression = NULL;
+	int chr_output_pos = 0;
+	int position_output_pos = 0;
 
 	vector<double>* snp_hq = NULL;
 	double maf_filter_value = -numeric_limits<double>::infinity();
@@ -549,9 +545,13 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 	bool maf_filter = false;
 	bool oevar_imp_filter = false;
 
+	vector<char*> fields;
+	int fields_number = 0;
+	int column_position = 0;
+
 	Column* column = NULL;
 
-	ofstream ofile_stream;
+	Writer* writer = NULL;
 
 	double d_value = 0.0;
 
@@ -569,7 +569,13 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 		snp_hq = descriptor->get_threshold(Descriptor::SNP_HQ);
 		data_separator = gwafile->get_data_separator();
 
-		auxiliary::transform_file_name(&o_gwafile_name, output_prefix, file_name, NULL, true);
+		index_format = gwafile->get_index_format();
+		compression = gwafile->get_compression();
+		if ((compression != NULL) && ((strlen(file_name) < 3) || (strcmp(file_name + strlen(file_name) - 3, ".gz") != 0))) {
+			auxiliary::transform_file_name(&o_gwafile_name, output_prefix, file_name, ".gz", true);
+		} else {
+			auxiliary::transform_file_name(&o_gwafile_name, output_prefix, file_name, NULL, true);
+		}
 		if (o_gwafile_name == NULL) {
 			throw FormatterException("Formatter", "format( double , char , int& , int& )", __LINE__, 10);
 		}
@@ -617,32 +623,57 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 			}
 		}
 
-		ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
-		ofile_stream.precision(numeric_limits<double>::digits10);
+		if (index_format != NULL) {
+			if ((chr_column == NULL) || (position_column == NULL)) {
+				throw FormatterException("Formatter", "format( double , char , int& , int& )", __LINE__, 15, Descriptor::CHR, Descriptor::POSITION, o_gwafile_name);
+			}
+
+			if (new_separator != '\t') {
+				throw FormatterException("Formatter", "format( double , char , int& , int& )", __LINE__, 16, o_gwafile_name);
+			}
+
+			for (columns_it = output_columns.begin(), column_position = 1; columns_it != output_columns.end(); columns_it++, column_position++) {
+				if (*columns_it == chr_column) {
+					chr_output_pos = column_position;
+				} else if (*columns_it == position_column) {
+					position_output_pos = column_position;
+				}
+			}
+		}
 
 		try {
-			ofile_stream.open(o_gwafile_name);
-		} catch (ofstream::failure &e) {
+			writer = WriterFactory::create_async(compression != NULL ? compression : WriterFactory::TEXT);
+			writer->set_file_name(o_gwafile_name);
+			writer->open();
+		} catch (WriterException &e) {
 			throw FormatterException("Formatter", "format( double , char , int& , int& )", __LINE__, 11, o_gwafile_name);
 		}
 
 		try {
 			columns_it = output_columns.begin();
 			if (columns_it != output_columns.end()) {
-				ofile_stream << (*columns_it)->get_header();
+				writer->put_str((*columns_it)->get_header());
 				while (++columns_it != output_columns.end()) {
-					ofile_stream << new_separator << (*columns_it)->get_header();
+					writer->put_char(new_separator);
+					writer->put_str((*columns_it)->get_header());
 				}
-				ofile_stream << endl;
+				writer->put_char('\n');
+			}
+
+			if (index_format != NULL) {
+				writer->set_index(index_format, chr_output_pos, position_output_pos);
 			}
 
 			if (maf_filter) {
 				if (oevar_imp_filter) {
 					// all filters
-					while ((line_length = reader.read_line()) > 0) {
-						line = *reader.line;
+					while ((line_length = reader->read_line()) > 0) {
+						line = *(reader->line);
 
-						for (columns_it = input_columns.begin(); columns_it != input_columns.end(); (*columns_it)->char_value = auxiliary::strtok(&line, data_separator), columns_it++);
+						fields_number = auxiliary::split(line, data_separator, fields, INT_MAX, gwafile->is_quoted());
+						for (columns_it = input_columns.begin(), column_position = 0; columns_it != input_columns.end(); columns_it++, column_position++) {
+							(*columns_it)->char_value = column_position < fields_number ? fields[column_position] : NULL;
+						}
 
 						d_value = maf_column->get_numeric_value();
 						d_value = d_value > 0.5 ? 1.0 - d_value : d_value;
@@ -651,12 +682,16 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 							if (auxiliary::fcmp(d_value, oevar_imp_filter_value, EPSILON) == 1) {
 								columns_it = output_columns.begin();
 								if (columns_it != output_columns.end()) {
-									(*columns_it)->out(ofile_stream);
+									(*columns_it)->out(writer);
 									while (++columns_it != output_columns.end()) {
-										ofile_stream << new_separator;
-										(*columns_it)->out(ofile_stream);
+										writer->put_char(new_separator);
+										(*columns_it)->out(writer);
 									}
-									ofile_stream << endl;
+									writer->put_char('\n');
+								}
+
+								if (index_format != NULL) {
+									writer->index_record(chr_column->char_value, get_index_position(position_column->char_value));
 								}
 
 								n_filtered += 1;
@@ -667,22 +702,29 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 					}
 				} else {
 					// only maf filter
-					while ((line_length = reader.read_line()) > 0) {
-						line = *reader.line;
+					while ((line_length = reader->read_line()) > 0) {
+						line = *(reader->line);
 
-						for (columns_it = input_columns.begin(); columns_it != input_columns.end(); (*columns_it)->char_value = auxiliary::strtok(&line, data_separator), columns_it++);
+						fields_number = auxiliary::split(line, data_separator, fields, INT_MAX, gwafile->is_quoted());
+						for (columns_it = input_columns.begin(), column_position = 0; columns_it != input_columns.end(); columns_it++, column_position++) {
+							(*columns_it)->char_value = column_position < fields_number ? fields[column_position] : NULL;
+						}
 
 						d_value = maf_column->get_numeric_value();
 						d_value = d_value > 0.5 ? 1.0 - d_value : d_value;
 						if (auxiliary::fcmp(d_value, maf_filter_value, EPSILON) == 1) {
 							columns_it = output_columns.begin();
 							if (columns_it != output_columns.end()) {
-								(*columns_it)->out(ofile_stream);
+								(*columns_it)->out(writer);
 								while (++columns_it != output_columns.end()) {
-									ofile_stream << new_separator;
-									(*columns_it)->out(ofile_stream);
+									writer->put_char(new_separator);
+									(*columns_it)->out(writer);
 								}
-								ofile_stream << endl;
+								writer->put_char('\n');
+							}
+
+							if (index_format != NULL) {
+								writer->index_record(chr_column->char_value, get_index_position(position_column->char_value));
 							}
 
 							n_filtered += 1;
@@ -693,21 +735,28 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 				}
 			} else if (oevar_imp_filter) {
 				// only oevar_imp filter
-				while ((line_length = reader.read_line()) > 0) {
-					line = *reader.line;
+				while ((line_length = reader->read_line()) > 0) {
+					line = *(reader->line);
 
-					for (columns_it = input_columns.begin(); columns_it != input_columns.end(); (*columns_it)->char_value = auxiliary::strtok(&line, data_separator), columns_it++);
+					fields_number = auxiliary::split(line, data_separator, fields, INT_MAX, gwafile->is_quoted());
+					for (columns_it = input_columns.begin(), column_position = 0; columns_it != input_columns.end(); columns_it++, column_position++) {
+						(*columns_it)->char_value = column_position < fields_number ? fields[column_position] : NULL;
+					}
 
 					d_value = oevar_imp_column->get_numeric_value();
 					if (auxiliary::fcmp(d_value, oevar_imp_filter_value, EPSILON) == 1) {
 						columns_it = output_columns.begin();
 						if (columns_it != output_columns.end()) {
-							(*columns_it)->out(ofile_stream);
+							(*columns_it)->out(writer);
 							while (++columns_it != output_columns.end()) {
-								ofile_stream << new_separator;
-								(*columns_it)->out(ofile_stream);
+								writer->put_char(new_separator);
+								(*columns_it)->out(writer);
 							}
-							ofile_stream << endl;
+							writer->put_char('\n');
+						}
+
+						if (index_format != NULL) {
+							writer->index_record(chr_column->char_value, get_index_position(position_column->char_value));
 						}
 
 						n_filtered += 1;
@@ -717,19 +766,26 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 				}
 			} else {
 				// no filters
-				while ((line_length = reader.read_line()) > 0) {
-					line = *reader.line;
+				while ((line_length = reader->read_line()) > 0) {
+					line = *(reader->line);
 
-					for (columns_it = input_columns.begin(); columns_it != input_columns.end(); (*columns_it)->char_value = auxiliary::strtok(&line, data_separator), columns_it++);
+					fields_number = auxiliary::split(line, data_separator, fields, INT_MAX, gwafile->is_quoted());
+					for (columns_it = input_columns.begin(), column_position = 0; columns_it != input_columns.end(); columns_it++, column_position++) {
+						(*columns_it)->char_value = column_position < fields_number ? fields[column_position] : NULL;
+					}
 
 					columns_it = output_columns.begin();
 					if (columns_it != output_columns.end()) {
-						(*columns_it)->out(ofile_stream);
+						(*columns_it)->out(writer);
 						while (++columns_it != output_columns.end()) {
-							ofile_stream << new_separator;
-							(*columns_it)->out(ofile_stream);
+							writer->put_char(new_separator);
+							(*columns_it)->out(writer);
 						}
-						ofile_stream << endl;
+						writer->put_char('\n');
+					}
+
+					if (index_format != NULL) {
+						writer->index_record(chr_column->char_value, get_index_position(position_column->char_value));
 					}
 
 					n_filtered += 1;
@@ -737,30 +793,40 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 					line_number += 1;
 				}
 			}
-		} catch (ofstream::failure &e) {
-			throw FormatterException("Formatter", "format( double , char , int& , int& )", __LINE__, 13, o_gwafile_name);
+		} catch (WriterException &e) {
+			FormatterException new_e(e);
+			new_e.add_message("Formatter", "format( double , char , int& , int& )", __LINE__, 13, o_gwafile_name);
+			throw new_e;
 		}
 
 		try {
-			ofile_stream.close();
-		} catch (ofstream::failure &e) {
-			throw FormatterException("Formatter", "format( double , char , int& , int& )", __LINE__, 12, o_gwafile_name);
+			writer->close();
+		} catch (WriterException &e) {
+			FormatterException new_e(e);
+			new_e.add_message("Formatter", "format( double , char , int& , int& )", __LINE__, 12, o_gwafile_name);
+			throw new_e;
 		}
 
+		delete writer;
+		writer = NULL;
+
 		n_total = line_number - 2;
 
 		if (line_length == 0) {
 			throw FormatterException("Formatter", "format( double , char , int& , int& )", __LINE__, 7, line_number, gwafile->get_descriptor()->get_name());
 		}
 	} catch (DescriptorException &e) {
+		delete writer;
 		FormatterException new_e(e);
 		e.add_message("Formatter", "format( double , char , int& , int& )", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw new_e;
 	} catch (ColumnException &e) {
+		delete writer;
 		FormatterException new_e(e);
 		e.add_message("Formatter", "format( double , char , int& , int& )", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw new_e;
 	} catch (FormatterException &e) {
+		delete writer;
 		e.add_message("Formatter", "format( double , char , int& , int& )", __LINE__, 14, gwafile->get_descriptor()->get_name());
 		throw;
 	}
@@ -19,7 +19,7 @@
 
 #include "../../include/formatter/FormatterException.h"
 
-const int FormatterException::MESSAGE_TEMPLATES_NUMBER = 15;
+const int FormatterException::MESSAGE_TEMPLATES_NUMBER = 17;
 const char* FormatterException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
@@ -35,7 +35,9 @@ const char* FormatterException::MESSAGE_TEMPLATES[] = {
 /*11*/	"Error while opening '%s' output file.",
 /*12*/	"Error while closing '%s' output file.",
 /*13*/	"Error while writing '%s' output file.",
-/*14*/	"Error while changing header and column separators in '%s' GWAS file."
+/*14*/	"Error while changing header and column separators in '%s' GWAS file.",
+/*15*/	"Columns '%s' and '%s' are required to index '%s' output file.",
+/*16*/	"Output file '%s' must be tab-delimited to be indexed."
 };
 
 FormatterException::FormatterException() : Exception() {
@@ -21,6 +21,7 @@
 #define ANALYZER_H_
 
 #include <stdexcept>
+#include <new>
 
 #include "../../../GWAtoolbox.h"
 #include "../../../auxiliary/include/auxiliary.h"
@@ -44,8 +45,28 @@
 
 #include <R.h>
 
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 class Analyzer {
 private:
+	struct chunk {
+		Analyzer* analyzer;
+		vector<char> lines;
+		vector<unsigned long int> offsets;
+		vector<char> line;
+		vector<char*> fields;
+		unsigned int first_line_number;
+		vector<Meta*> metas;
+		vector<MetaFiltered*> filtered_metas;
+		vector<MetaRatio*> ratio_metas;
+		vector<MetaCrossTable*> cross_table_metas;
+		vector< pair<pair<Meta*, Meta*>, int> > dependencies;
+		AnalyzerException* error;
+	};
+
 //	TextReader reader;
 	Reader* reader;
 	GwaFile* gwafile;
@@ -60,6 +81,22 @@ private:
 	vector<MetaRatio*> ratio_metas;
 	vector<MetaCrossTable*> cross_table_metas;
 
+	unsigned int threads_number;
+	unsigned int needed_columns;
+
+	static unsigned int get_default_threads_number();
+	double get_sketch_accuracy();
+	static void* process_chunk(void* data_chunk);
+
+	void process_line(char* line, unsigned int line_number, vector<char*>& fields, vector<Meta*>& line_metas, vector<MetaFiltered*>& line_filtered_metas,
+			vector<MetaRatio*>& line_ratio_metas, vector<MetaCrossTable*>& line_cross_table_metas, vector< pair<pair<Meta*, Meta*>, int> >& line_dependencies) throw (AnalyzerException, MetaException);
+	void process_chunks(chunk* chunks, unsigned int chunks_number) throw (AnalyzerException);
+	void create_partials(chunk& data_chunk) throw (AnalyzerException);
+	void merge_partials(chunk& data_chunk) throw (AnalyzerException);
+	void delete_partials(chunk& data_chunk);
+	bool is_mergeable();
+	bool is_mergeable(chunk& data_chunk);
+
 	Qqplot* create_combined_qqplot(int column_from, int column_to) throw (PlotException);
 
 	static void print_boxplots_html(vector<const char*>& boxplot_names, const char* html_output_name, const char* resource_path) throw (AnalyzerException);
@@ -107,6 +144,9 @@ public:
 	static const char* MAIN_FILE;
 	static const char* BOXPLOTS_FILE;
 
+	static const unsigned int MAX_THREADS_NUMBER;
+	static const unsigned int CHUNK_SIZE;
+
 	Analyzer();
 	virtual ~Analyzer();
 
@@ -57,6 +57,8 @@ protected:
 	char* description;
 	char* na_marker;
 
+	virtual void copy_properties(Meta* partial) throw (MetaException);
+
 public:
 	Meta();
 	virtual ~Meta();
@@ -82,6 +84,11 @@ public:
 	virtual void print(ostream& stream) = 0;
 	virtual void print_html(ostream& stream, char path_separator) = 0;
 
+	/* partial metas process separate chunks of data, which are merged in their original order */
+	virtual Meta* create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) = 0;
+	virtual void merge(Meta* partial) throw (MetaException) = 0;
+	virtual bool is_mergeable();
+
 };
 
 #endif
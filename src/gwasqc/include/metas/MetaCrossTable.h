@@ -49,6 +49,9 @@ private:
 	double new_x_value;
 	double new_y_value;
 
+	void insert_x(double x_value);
+	void insert_y(double y_value);
+
 public:
 	MetaCrossTable(MetaNumeric* x_meta, MetaNumeric* y_meta);
 	virtual ~MetaCrossTable();
@@ -59,6 +62,8 @@ public:
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 	double get_memory_usage();
+	Meta* create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException);
+	void merge(Meta* partial) throw (MetaException);
 };
 
 #endif
@@ -46,6 +46,8 @@ private:
 
 	BitArray* bitarray;
 
+	bool shared_conditions;
+
 public:
 	MetaFiltered(MetaNumeric* source, unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
 	virtual ~MetaFiltered();
@@ -55,12 +57,17 @@ public:
 
 	MetaNumeric* get_source();
 
+	void set_sketch(double accuracy) throw (MetaException);
+
 	void put(char* value) throw (MetaException);
 	void finalize() throw (MetaException);
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 
 	double get_memory_usage();
+
+	Meta* create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException);
+	void merge(Meta* partial) throw (MetaException);
 };
 
 #endif
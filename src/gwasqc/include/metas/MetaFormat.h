@@ -25,6 +25,8 @@
 #include <iomanip>
 #include "R.h"
 
+#include "../../../auxiliary/include/auxiliary.h"
+
 using namespace std;
 
 class MetaFormat: public Meta {
@@ -42,6 +44,9 @@ public:
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 	double get_memory_usage();
+	Meta* create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException);
+	void merge(Meta* partial) throw (MetaException);
+	bool is_mergeable();
 };
 
 #endif
@@ -48,6 +48,8 @@ public:
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 	double get_memory_usage();
+	Meta* create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException);
+	void merge(Meta* partial) throw (MetaException);
 };
 
 #endif
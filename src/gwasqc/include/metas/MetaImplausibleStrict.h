@@ -37,6 +37,8 @@ public:
 	void put(char* value) throw (MetaException);
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
+	Meta* create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException);
+	void merge(Meta* partial) throw (MetaException);
 	void set_implausible(double less, double greater);
 };
 
@@ -31,6 +31,7 @@ public:
 	MetaImplausibleStrictAdjusted(double less, double greater, double threshold, unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
 	virtual ~MetaImplausibleStrictAdjusted();
 	void put(char* value) throw (MetaException);
+	Meta* create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException);
 	void set_threshold(double threshold);
 };
 
@@ -26,6 +26,7 @@
 
 #include "../../../auxiliary/include/auxiliary.h"
 #include "Meta.h"
+#include "Sketch.h"
 #include "../plots/Plottable.h"
 
 using namespace auxiliary;
@@ -55,6 +56,8 @@ protected:
 	double* new_data;
 	int current_heap_size;
 
+	Sketch* sketch;
+
 	char* color;
 
 	bool create_histogram;
@@ -66,6 +69,10 @@ protected:
 	Qqplot* qqplot;
 	Plot* plot;
 
+	void save_value(double value) throw (MetaException);
+	int calculate_statistics() throw (MetaException);
+	void copy_properties(Meta* partial) throw (MetaException);
+
 public:
 	bool print_min;
 	bool print_max;
@@ -84,6 +91,12 @@ public:
 	void print_html(ostream& stream, char path_separator);
 	double get_memory_usage();
 
+	virtual void set_sketch(double accuracy) throw (MetaException);
+
+	Meta* create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException);
+	void merge(Meta* partial) throw (MetaException);
+	bool is_mergeable();
+
 	const char* get_plot_name();
 	bool is_plottable();
 	void set_color(const char* color) throw (PlotException);
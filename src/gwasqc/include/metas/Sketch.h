@@ -0,0 +1,117 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SKETCH_H_
+#define SKETCH_H_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <new>
+
+#include "MetaException.h"
+
+#include "R.h"
+
+using namespace std;
+
+/*
+ * Streaming summary of a numeric column, which uses the memory proportional to the logarithm of the values' range, but not to their number.
+ * Values are counted in logarithmic buckets, so that every quantile is approximated with the given relative error.
+ * Count, minimum, maximum and the central moments are exact.
+ * Merging two sketches gives the same buckets as processing all values with a single sketch.
+ */
+class Sketch {
+private:
+	/* value is kept while all values in a cell are equal, e.g. in columns with few distinct values; otherwise it is NaN */
+	struct cell {
+		unsigned long int count;
+		double value;
+	};
+
+	struct bucket {
+		double lower;
+		double upper;
+		double value;
+		unsigned long int first;
+		unsigned long int count;
+	};
+
+	double accuracy;
+	double gamma;
+	double log_gamma;
+
+	/* cell k holds values from (gamma^(k-1), gamma^k], negative values are counted by their absolute value */
+	vector<cell> positive;
+	vector<cell> negative;
+	int positive_offset;
+	int negative_offset;
+	unsigned long int zeros;
+	unsigned long int negative_infinities;
+	unsigned long int positive_infinities;
+
+	unsigned long int n;
+	double min;
+	double max;
+
+	double mean;
+	double m2;
+	double m3;
+	double m4;
+
+	vector<bucket> buckets;
+	bool buckets_valid;
+
+	int get_index(double value);
+	void add(vector<cell>& cells, int& offset, int index, unsigned long int count, double value) throw (MetaException);
+	void add_bucket(double lower, double upper, double value, unsigned long int count);
+	void build_buckets();
+	vector<bucket>::iterator find_bucket(unsigned long int rank);
+	double interpolate(vector<bucket>::iterator bucket_it, unsigned long int rank);
+
+public:
+	static const double DEFAULT_ACCURACY;
+	static const unsigned int SAMPLE_SIZE;
+
+	Sketch(double accuracy = DEFAULT_ACCURACY) throw (MetaException);
+	virtual ~Sketch();
+
+	void add(double value) throw (MetaException);
+	void merge(Sketch& sketch) throw (MetaException);
+
+	double get_accuracy();
+	unsigned long int get_n();
+	double get_min();
+	double get_max();
+	double get_mean();
+	double get_sd();
+	double get_skewness();
+	double get_kurtosis();
+
+	double get_value(unsigned long int rank);
+	double get_median();
+	double get_quantile(double fraction);
+
+	void get_sample(double* data, unsigned int size);
+	void get_tail_sample(vector<double>& data, vector<double>& ranks) throw (MetaException);
+
+	unsigned long int get_memory_usage();
+};
+
+#endif
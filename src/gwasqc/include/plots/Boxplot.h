@@ -68,6 +68,7 @@ public:
 	void set_name(int group, const char* name, unsigned int) throw (PlotException);
 	void set_common_name(const char* name) throw (PlotException);
 	void set_width(int group, double) throw (PlotException);
+	void set_observations(int group, int observations) throw (PlotException);
 	void set_quantiles(double q0, double q25, double q5, double q75, double q1);
 	const double* get_tukey();
 	const int* get_observations();
@@ -61,6 +61,7 @@ public:
 	const double* get_mids();
 	const char* get_xname();
 	int get_nclass();
+	void scale_counts(double factor);
 	void set_title(const char* title) throw (PlotException);
 	const char* get_title();
 
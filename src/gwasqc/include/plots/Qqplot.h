@@ -63,6 +63,7 @@ public:
 	const double* get_lambdas();
 
 	static Qqplot* create(const char* name, const char* color, double* sorted_data, double lambda, int data_size) throw (PlotException);
+	static Qqplot* create(const char* name, const char* color, double* sorted_data, double* ranks, double lambda, int sample_size, int data_size) throw (PlotException);
 	static Qqplot* merge(Qqplot* to, Qqplot* from) throw (PlotException);
 
 	friend SEXP Qqplot2Robj(SEXP qqplot);
@@ -87,7 +87,10 @@ const char* Analyzer::MENU_FILE = "menu.html";
 const char* Analyzer::MAIN_FILE = "main.html";
 const char* Analyzer::BOXPLOTS_FILE = "boxplots.html";
 
-Analyzer::Analyzer() : reader(NULL), gwafile(NULL) {
+const unsigned int Analyzer::MAX_THREADS_NUMBER = 8u;
+const unsigned int Analyzer::CHUNK_SIZE = 65536u;
+
+Analyzer::Analyzer() : reader(NULL), gwafile(NULL), threads_number(get_default_threads_number()), needed_columns(0u) {
 
 }
 
@@ -145,11 +148,15 @@ void Analyzer::open_gwafile(GwaFile* gwafile) throw (AnalyzerException) {
 	try {
 		close_gwafile();
 
-		reader = ReaderFactory::create(gwafile->get_descriptor()->get_full_path());
+		reader = gwafile->create_reader();
 		reader->set_file_name(gwafile->get_descriptor()->get_full_path());
 		reader->open();
 
 		this->gwafile = gwafile;
+	} catch (GwaFileException& e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
 	} catch (ReaderException& e) {
 		AnalyzerException new_e(e);
 		new_e.add_message("Analyzer", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
@@ -229,7 +236,10 @@ void Analyzer::process_header() throw (AnalyzerException) {
 	Meta* meta = NULL;
 	vector<char*>::iterator vector_char_it;
 	vector<double>* thresholds;
+	vector<MetaNumeric*>::iterator numeric_metas_it;
 	unsigned int heap_size = 0;
+	unsigned int numeric_heap_size = 0;
+	double sketch_accuracy = 0.0;
 
 	if (gwafile == NULL) {
 		return;
@@ -249,6 +259,10 @@ void Analyzer::process_header() throw (AnalyzerException) {
 			heap_size = Meta::HEAP_SIZE;
 		}
 
+		/* numeric columns in the sketch mode do not keep their values */
+		sketch_accuracy = get_sketch_accuracy();
+		numeric_heap_size = sketch_accuracy > 0.0 ? 0u : heap_size;
+
 		for (int i = 0; i < MANDATORY_COLUMNS_SIZE; i++) {
 			column_name = descriptor->get_column(mandatory_columns[i]);
 			if (column_name != NULL) {
@@ -261,7 +275,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 			}
 		}
 
-		token = auxiliary::strtok(&header, header_separator);
+		token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 		while (token != NULL) {
 			column_name = descriptor->get_default_column(token, gwafile->is_case_sensitive());
 			if (column_name != NULL) {
@@ -280,7 +294,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					meta = new MetaGroup();
 				} else if (strcmp(column_name, Descriptor::PVALUE) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::PVALUE);
-					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), numeric_heap_size);
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaImplausibleStrict*)meta)->set_plots(true, false, false);
 					((MetaImplausibleStrict*)meta)->set_description("All data");
@@ -288,7 +302,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					meta->set_full_name("P-value");
 					plots.push_back((MetaImplausibleStrict*)meta);
 				} else if (strcmp(column_name, Descriptor::EFFECT) == 0) {
-					meta = new MetaNumeric(heap_size);
+					meta = new MetaNumeric(numeric_heap_size);
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaNumeric*)meta)->set_description("All data");
 					((MetaNumeric*)meta)->set_ouptut(false, false, false, true, true, true);
@@ -296,7 +310,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaNumeric*)meta);
 				} else if (strcmp(column_name, Descriptor::STDERR) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::STDERR);
-					meta = new MetaImplausible(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausible(thresholds->at(0), thresholds->at(1), numeric_heap_size);
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaImplausible*)meta)->set_description("All data");
 					((MetaImplausible*)meta)->set_ouptut(false, false, false, true, true, true);
@@ -304,7 +318,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaImplausible*)meta);
 				} else if (strcmp(column_name, Descriptor::FREQLABEL) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::FREQLABEL);
-					meta = new MetaImplausibleStrictAdjusted(thresholds->at(0), thresholds->at(1), 0.5, heap_size);
+					meta = new MetaImplausibleStrictAdjusted(thresholds->at(0), thresholds->at(1), 0.5, numeric_heap_size);
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaImplausibleStrictAdjusted*)meta)->set_description(token);
 					((MetaImplausibleStrictAdjusted*)meta)->set_ouptut(false, false, false, true, true, true);
@@ -312,7 +326,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaImplausibleStrictAdjusted*)meta);
 				} else if (strcmp(column_name, Descriptor::HWE_PVAL) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::HWE_PVAL);
-					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), numeric_heap_size);
 					if (!gwafile->is_high_verbosity()) {
 						((MetaImplausibleStrict*)meta)->set_plots(false, false, false);
 					}
@@ -323,7 +337,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaImplausibleStrict*)meta);
 				} else if (strcmp(column_name, Descriptor::CALLRATE) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::CALLRATE);
-					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), numeric_heap_size);
 					if (!gwafile->is_high_verbosity()) {
 						((MetaImplausibleStrict*)meta)->set_plots(false, false, false);
 					}
@@ -333,7 +347,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					numeric_metas.push_back((MetaNumeric*)meta);
 					plots.push_back((MetaImplausibleStrict*)meta);
 				} else if (strcmp(column_name, Descriptor::N_TOTAL) == 0) {
-					meta = new MetaNumeric(heap_size);
+					meta = new MetaNumeric(numeric_heap_size);
 					if (!gwafile->is_high_verbosity()) {
 						((MetaNumeric*)meta)->set_plots(true, false, false);
 					}
@@ -343,7 +357,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					numeric_metas.push_back((MetaNumeric*)meta);
 					plots.push_back((MetaNumeric*)meta);
 				} else if (strcmp(column_name, Descriptor::IMPUTED) == 0) {
-					meta = new MetaNumeric(heap_size);
+					meta = new MetaNumeric(numeric_heap_size);
 					if (!gwafile->is_high_verbosity()) {
 						((MetaNumeric*)meta)->set_plots(false, false, false);
 					}
@@ -351,7 +365,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					numeric_metas.push_back((MetaNumeric*)meta);
 					plots.push_back((MetaNumeric*)meta);
 				} else if (strcmp(column_name, Descriptor::USED_FOR_IMP) == 0) {
-					meta = new MetaNumeric(heap_size);
+					meta = new MetaNumeric(numeric_heap_size);
 					if (!gwafile->is_high_verbosity()) {
 						((MetaNumeric*)meta)->set_plots(false, false, false);
 					}
@@ -360,7 +374,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaNumeric*)meta);
 				} else if (strcmp(column_name, Descriptor::OEVAR_IMP) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::OEVAR_IMP);
-					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), numeric_heap_size);
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaImplausibleStrict*)meta)->set_description("All data");
 					((MetaImplausibleStrict*)meta)->set_ouptut(false, false, false, true, true, true);
@@ -375,7 +389,7 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					not_required_columns.push_back(column_name_copy);
 					metas.push_back(NULL);
 
-					token = auxiliary::strtok(&header, header_separator);
+					token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 					column_position += 1;
 
 					continue;
@@ -415,9 +429,15 @@ void Analyzer::process_header() throw (AnalyzerException) {
 				metas.push_back(NULL);
 			}
 
-			token = auxiliary::strtok(&header, header_separator);
+			token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 			column_position += 1;
 		}
+
+		if (sketch_accuracy > 0.0) {
+			for (numeric_metas_it = numeric_metas.begin(); numeric_metas_it != numeric_metas.end(); numeric_metas_it++) {
+				(*numeric_metas_it)->set_sketch(sketch_accuracy);
+			}
+		}
 	} catch (DescriptorException &e) {
 		AnalyzerException new_e(e);
 		new_e.add_message("Analyzer", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
@@ -433,14 +453,42 @@ void Analyzer::process_header() throw (AnalyzerException) {
 }
 
 
-void Analyzer::process_data() throw (AnalyzerException) {
-	char* line = NULL;
-	int line_length = 0;
-	unsigned int line_number = 1;
-	char* token = NULL;
-	char data_separator = '\0';
+unsigned int Analyzer::get_default_threads_number() {
+#ifndef WIN32
+	long int processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (processors < 1) {
+		return 1u;
+	}
+
+	if ((unsigned long int)processors > MAX_THREADS_NUMBER) {
+		return MAX_THREADS_NUMBER;
+	}
+
+	return (unsigned int)processors;
+#else
+	return 1u;
+#endif
+}
+
+/* relative accuracy of quantiles in the sketch mode, or 0 if numeric columns keep all values */
+double Analyzer::get_sketch_accuracy() {
+	const char* sketch_property = gwafile->get_descriptor()->get_property(Descriptor::SKETCH);
+
+	if ((sketch_property == NULL) || (strcmp(sketch_property, Descriptor::OFF_MODES[0]) == 0)) {
+		return 0.0;
+	}
+
+	if (strcmp(sketch_property, Descriptor::ON_MODES[0]) == 0) {
+		return Sketch::DEFAULT_ACCURACY;
+	}
+
+	return atof(sketch_property);
+}
+
+void Analyzer::process_line(char* line, unsigned int line_number, vector<char*>& fields, vector<Meta*>& line_metas, vector<MetaFiltered*>& line_filtered_metas,
+		vector<MetaRatio*>& line_ratio_metas, vector<MetaCrossTable*>& line_cross_table_metas, vector< pair<pair<Meta*, Meta*>, int> >& line_dependencies) throw (AnalyzerException, MetaException) {
 	unsigned int column_number = 0;
-	unsigned int total_columns = 0;
 
 	Meta* meta = NULL;
 
@@ -449,47 +497,395 @@ void Analyzer::process_data() throw (AnalyzerException) {
 	vector<MetaCrossTable*>::iterator cross_table_metas_it;
 	vector< pair<pair<Meta*, Meta*>, int> >::iterator dependencies_it;
 
-	if (gwafile == NULL) {
-		return;
+	try {
+		if ((unsigned int)auxiliary::split(line, gwafile->get_data_separator(), fields, needed_columns, gwafile->is_quoted()) != line_metas.size()) {
+			throw AnalyzerException("Analyzer", "process_line( char*, unsigned int, ... )", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
+		}
+
+		for (column_number = 0; column_number < needed_columns; column_number++) {
+			if ((meta = line_metas[column_number]) != NULL) {
+				meta->put(fields[column_number]);
+			}
+		}
+
+		for (filtered_metas_it = line_filtered_metas.begin(); filtered_metas_it != line_filtered_metas.end(); filtered_metas_it++) {
+			(*filtered_metas_it)->put(NULL);
+		}
+
+		for (ratio_metas_it = line_ratio_metas.begin(); ratio_metas_it != line_ratio_metas.end(); ratio_metas_it++) {
+			(*ratio_metas_it)->put(NULL);
+		}
+
+		for (cross_table_metas_it = line_cross_table_metas.begin(); cross_table_metas_it != line_cross_table_metas.end(); cross_table_metas_it++) {
+			(*cross_table_metas_it)->put(NULL);
+		}
+
+		for (dependencies_it = line_dependencies.begin(); dependencies_it != line_dependencies.end(); dependencies_it++) {
+			if (!dependencies_it->first.first->is_na() && dependencies_it->first.second->is_na()) {
+				dependencies_it->second += 1;
+			}
+		}
+	} catch (std::out_of_range &e) {
+		throw AnalyzerException("Analyzer", "process_line( char*, unsigned int, ... )", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
 	}
+}
 
-	data_separator = gwafile->get_data_separator();
-	total_columns = metas.size();
+/* runs in a worker thread: lines are split in a copy, so that the chunk can be processed again if its partial metas can't be merged */
+void* Analyzer::process_chunk(void* data_chunk) {
+	chunk* current_chunk = (chunk*)data_chunk;
+	unsigned long int line_end = 0ul;
 
 	try {
-		while ((line_length = reader->read_line()) > 0) {
-			column_number = 0;
-			line = *(reader->line);
-			while ((token = auxiliary::strtok(&line, data_separator)) != NULL) {
-				if ((meta = metas.at(column_number)) != NULL) {
-					meta->put(token);
-				}
-				column_number += 1;
+		for (unsigned int i = 0u; i < current_chunk->offsets.size(); ++i) {
+			line_end = (i + 1u < current_chunk->offsets.size()) ? current_chunk->offsets[i + 1u] : current_chunk->lines.size();
+			current_chunk->line.assign(current_chunk->lines.begin() + current_chunk->offsets[i], current_chunk->lines.begin() + line_end);
+
+			current_chunk->analyzer->process_line(&(current_chunk->line[0]), current_chunk->first_line_number + i, current_chunk->fields,
+					current_chunk->metas, current_chunk->filtered_metas, current_chunk->ratio_metas, current_chunk->cross_table_metas, current_chunk->dependencies);
+		}
+	} catch (MetaException &e) {
+		current_chunk->error = new AnalyzerException(e);
+	} catch (AnalyzerException &e) {
+		current_chunk->error = new AnalyzerException(e);
+	} catch (Exception &e) {
+		current_chunk->error = new AnalyzerException(e);
+	} catch (std::bad_alloc &e) {
+		current_chunk->error = new AnalyzerException("Analyzer", "process_chunk( void* )", __LINE__, 2, current_chunk->lines.size());
+	} catch (...) {
+		/* nothing may escape a worker thread: record the error, so that it is rethrown in chunk order */
+		current_chunk->error = new AnalyzerException("Analyzer", "process_chunk( void* )", __LINE__, 11, current_chunk->analyzer->gwafile->get_descriptor()->get_full_path());
+	}
+
+	return NULL;
+}
+
+void Analyzer::create_partials(chunk& data_chunk) throw (AnalyzerException) {
+	map<Meta*, Meta*> partials;
+	vector<Meta*>::iterator metas_it;
+	vector<MetaFiltered*>::iterator filtered_metas_it;
+	vector<MetaRatio*>::iterator ratio_metas_it;
+	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+	vector< pair<pair<Meta*, Meta*>, int> >::iterator dependencies_it;
+	Meta* partial = NULL;
+
+	data_chunk.metas.assign(metas.size(), NULL);
+
+	try {
+		for (unsigned int i = 0u; i < metas.size(); ++i) {
+			if (metas[i] != NULL) {
+				partial = metas[i]->create_partial(partials, CHUNK_SIZE);
+				data_chunk.metas[i] = partial;
+				partials[metas[i]] = partial;
 			}
+		}
+
+		for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+			partial = (*filtered_metas_it)->create_partial(partials, CHUNK_SIZE);
+			data_chunk.filtered_metas.push_back((MetaFiltered*)partial);
+			partials[*filtered_metas_it] = partial;
+		}
+
+		for (ratio_metas_it = ratio_metas.begin(); ratio_metas_it != ratio_metas.end(); ratio_metas_it++) {
+			data_chunk.ratio_metas.push_back((MetaRatio*)(*ratio_metas_it)->create_partial(partials, CHUNK_SIZE));
+		}
+
+		for (cross_table_metas_it = cross_table_metas.begin(); cross_table_metas_it != cross_table_metas.end(); cross_table_metas_it++) {
+			data_chunk.cross_table_metas.push_back((MetaCrossTable*)(*cross_table_metas_it)->create_partial(partials, CHUNK_SIZE));
+		}
+
+		for (dependencies_it = dependencies.begin(); dependencies_it != dependencies.end(); dependencies_it++) {
+			data_chunk.dependencies.push_back(pair<pair<Meta*, Meta*>, int>(pair<Meta*, Meta*>(partials[dependencies_it->first.first], partials[dependencies_it->first.second]), 0));
+		}
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		throw new_e;
+	}
+}
 
-			if (column_number != total_columns) {
-				throw AnalyzerException("Analyzer", "process_data()", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
+/* dependent metas are merged before their sources */
+void Analyzer::merge_partials(chunk& data_chunk) throw (AnalyzerException) {
+	try {
+		for (unsigned int i = 0u; i < ratio_metas.size(); ++i) {
+			ratio_metas[i]->merge(data_chunk.ratio_metas[i]);
+		}
+
+		for (unsigned int i = 0u; i < cross_table_metas.size(); ++i) {
+			cross_table_metas[i]->merge(data_chunk.cross_table_metas[i]);
+		}
+
+		for (unsigned int i = 0u; i < filtered_metas.size(); ++i) {
+			filtered_metas[i]->merge(data_chunk.filtered_metas[i]);
+		}
+
+		for (unsigned int i = 0u; i < metas.size(); ++i) {
+			if (metas[i] != NULL) {
+				metas[i]->merge(data_chunk.metas[i]);
 			}
+		}
 
-			for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
-				(*filtered_metas_it)->put(NULL);
+		for (unsigned int i = 0u; i < dependencies.size(); ++i) {
+			dependencies[i].second += data_chunk.dependencies[i].second;
+		}
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		throw new_e;
+	}
+}
+
+void Analyzer::delete_partials(chunk& data_chunk) {
+	vector<Meta*>::iterator metas_it;
+	vector<MetaFiltered*>::iterator filtered_metas_it;
+	vector<MetaRatio*>::iterator ratio_metas_it;
+	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+
+	for (ratio_metas_it = data_chunk.ratio_metas.begin(); ratio_metas_it != data_chunk.ratio_metas.end(); ratio_metas_it++) {
+		delete *ratio_metas_it;
+	}
+
+	for (cross_table_metas_it = data_chunk.cross_table_metas.begin(); cross_table_metas_it != data_chunk.cross_table_metas.end(); cross_table_metas_it++) {
+		delete *cross_table_metas_it;
+	}
+
+	for (filtered_metas_it = data_chunk.filtered_metas.begin(); filtered_metas_it != data_chunk.filtered_metas.end(); filtered_metas_it++) {
+		delete *filtered_metas_it;
+	}
+
+	for (metas_it = data_chunk.metas.begin(); metas_it != data_chunk.metas.end(); metas_it++) {
+		if ((*metas_it) != NULL) {
+			delete *metas_it;
+		}
+	}
+
+	data_chunk.metas.clear();
+	data_chunk.filtered_metas.clear();
+	data_chunk.ratio_metas.clear();
+	data_chunk.cross_table_metas.clear();
+	data_chunk.dependencies.clear();
+
+	delete data_chunk.error;
+	data_chunk.error = NULL;
+}
+
+bool Analyzer::is_mergeable() {
+	for (unsigned int i = 0u; i < metas.size(); ++i) {
+		if ((metas[i] != NULL) && !metas[i]->is_mergeable()) {
+			return false;
+		}
+	}
+
+	for (unsigned int i = 0u; i < filtered_metas.size(); ++i) {
+		if (!filtered_metas[i]->is_mergeable()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* merged results are the same as from the serial processing only if no column stopped being numeric, neither before nor inside the chunk */
+bool Analyzer::is_mergeable(chunk& data_chunk) {
+	if (!is_mergeable()) {
+		return false;
+	}
+
+	for (unsigned int i = 0u; i < data_chunk.metas.size(); ++i) {
+		if ((data_chunk.metas[i] != NULL) && !data_chunk.metas[i]->is_mergeable()) {
+			return false;
+		}
+	}
+
+	for (unsigned int i = 0u; i < data_chunk.filtered_metas.size(); ++i) {
+		if (!data_chunk.filtered_metas[i]->is_mergeable()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* the first chunk is processed by the calling thread directly into the metas; the other chunks are processed in parallel into partial metas, which are merged in order */
+void Analyzer::process_chunks(chunk* chunks, unsigned int chunks_number) throw (AnalyzerException) {
+	vector<char*> fields;
+	AnalyzerException* error = NULL;
+
+#ifndef WIN32
+	pthread_t threads[MAX_THREADS_NUMBER];
+	bool threads_started[MAX_THREADS_NUMBER];
+#endif
+
+	try {
+		if ((chunks_number == 1u) || !is_mergeable()) {
+			for (unsigned int i = 0u; i < chunks_number; ++i) {
+				for (unsigned int j = 0u; j < chunks[i].offsets.size(); ++j) {
+					process_line(&(chunks[i].lines[chunks[i].offsets[j]]), chunks[i].first_line_number + j, fields, metas, filtered_metas, ratio_metas, cross_table_metas, dependencies);
+				}
+			}
+			return;
+		}
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		throw new_e;
+	}
+
+	try {
+		for (unsigned int i = 1u; i < chunks_number; ++i) {
+			create_partials(chunks[i]);
+		}
+	} catch (AnalyzerException &e) {
+		for (unsigned int i = 1u; i < chunks_number; ++i) {
+			delete_partials(chunks[i]);
+		}
+		throw;
+	}
+
+#ifndef WIN32
+	for (unsigned int i = 1u; i < chunks_number; ++i) {
+		threads_started[i] = (pthread_create(&threads[i], NULL, process_chunk, &chunks[i]) == 0);
+	}
+#endif
+
+	try {
+		for (unsigned int j = 0u; j < chunks[0].offsets.size(); ++j) {
+			process_line(&(chunks[0].lines[chunks[0].offsets[j]]), chunks[0].first_line_number + j, fields, metas, filtered_metas, ratio_metas, cross_table_metas, dependencies);
+		}
+	} catch (MetaException &e) {
+		chunks[0].error = new AnalyzerException(e);
+	} catch (AnalyzerException &e) {
+		chunks[0].error = new AnalyzerException(e);
+	}
+
+#ifndef WIN32
+	for (unsigned int i = 1u; i < chunks_number; ++i) {
+		if (threads_started[i]) {
+			pthread_join(threads[i], NULL);
+		} else {
+			process_chunk(&chunks[i]);
+		}
+	}
+#else
+	for (unsigned int i = 1u; i < chunks_number; ++i) {
+		process_chunk(&chunks[i]);
+	}
+#endif
+
+	try {
+		for (unsigned int i = 0u; i < chunks_number; ++i) {
+			if (chunks[i].error != NULL) {
+				error = chunks[i].error;
+				chunks[i].error = NULL;
+				break;
 			}
 
-			for (ratio_metas_it = ratio_metas.begin(); ratio_metas_it != ratio_metas.end(); ratio_metas_it++) {
-				(*ratio_metas_it)->put(NULL);
+			if (i > 0u) {
+				if (is_mergeable(chunks[i])) {
+					merge_partials(chunks[i]);
+				} else {
+					for (unsigned int j = 0u; j < chunks[i].offsets.size(); ++j) {
+						process_line(&(chunks[i].lines[chunks[i].offsets[j]]), chunks[i].first_line_number + j, fields, metas, filtered_metas, ratio_metas, cross_table_metas, dependencies);
+					}
+				}
+
+				delete_partials(chunks[i]);
 			}
+		}
+	} catch (MetaException &e) {
+		error = new AnalyzerException(e);
+	} catch (AnalyzerException &e) {
+		error = new AnalyzerException(e);
+	}
+
+	for (unsigned int i = 0u; i < chunks_number; ++i) {
+		delete_partials(chunks[i]);
+	}
+
+	if (error != NULL) {
+		AnalyzerException new_e(*error);
+		delete error;
+		throw new_e;
+	}
+}
+
+void Analyzer::process_data() throw (AnalyzerException) {
+	int line_length = 0;
+	unsigned int line_number = 1;
+	vector<char*> fields;
+
+	chunk* chunks = NULL;
+	unsigned int chunks_number = 0u;
+	bool data_end = false;
+	AnalyzerException* read_error = NULL;
+
+	if (gwafile == NULL) {
+		return;
+	}
 
-			for (cross_table_metas_it = cross_table_metas.begin(); cross_table_metas_it != cross_table_metas.end(); cross_table_metas_it++) {
-				(*cross_table_metas_it)->put(NULL);
+	/* columns after the last one with a meta are only counted */
+	needed_columns = metas.size();
+	while ((needed_columns > 0) && (metas[needed_columns - 1] == NULL)) {
+		needed_columns -= 1;
+	}
+
+	try {
+		if (threads_number <= 1u) {
+			while ((line_length = reader->read_line()) > 0) {
+				process_line(*(reader->line), line_number, fields, metas, filtered_metas, ratio_metas, cross_table_metas, dependencies);
+				line_number += 1;
 			}
+		} else {
+			chunks = new chunk[threads_number];
+			for (unsigned int i = 0u; i < threads_number; ++i) {
+				chunks[i].analyzer = this;
+				chunks[i].error = NULL;
+			}
+
+			try {
+				while (!data_end) {
+					chunks_number = 0u;
+					while ((chunks_number < threads_number) && !data_end) {
+						chunks[chunks_number].first_line_number = line_number;
+						chunks[chunks_number].lines.clear();
+						chunks[chunks_number].offsets.clear();
+
+						try {
+							while ((chunks[chunks_number].offsets.size() < CHUNK_SIZE) && ((line_length = reader->read_line()) > 0)) {
+								chunks[chunks_number].offsets.push_back(chunks[chunks_number].lines.size());
+								chunks[chunks_number].lines.insert(chunks[chunks_number].lines.end(), *(reader->line), *(reader->line) + line_length + 1);
+								line_number += 1;
+							}
+						} catch (ReaderException &e) {
+							/* lines read before the error are processed first, since they may contain an earlier error */
+							read_error = new AnalyzerException(e);
+							data_end = true;
+						}
+
+						if (line_length <= 0) {
+							data_end = true;
+						}
+
+						if (!chunks[chunks_number].offsets.empty()) {
+							chunks_number += 1u;
+						}
+					}
+
+					if (chunks_number > 0u) {
+						process_chunks(chunks, chunks_number);
+					}
+				}
 
-			for (dependencies_it = dependencies.begin(); dependencies_it != dependencies.end(); dependencies_it++) {
-				if (!dependencies_it->first.first->is_na() && dependencies_it->first.second->is_na()) {
-					dependencies_it->second += 1;
+				if (read_error != NULL) {
+					AnalyzerException new_e(*read_error);
+					delete read_error;
+					read_error = NULL;
+					throw new_e;
 				}
+			} catch (AnalyzerException &e) {
+				delete read_error;
+				delete[] chunks;
+				throw;
 			}
 
-			line_number += 1;
+			delete[] chunks;
+			chunks = NULL;
 		}
 
 		if (line_length == 0) {
@@ -506,10 +902,6 @@ void Analyzer::process_data() throw (AnalyzerException) {
 	} catch (AnalyzerException &e) {
 		e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
 		throw;
-	} catch (std::out_of_range &e) {
-		AnalyzerException new_e("Analyzer", "process_data()", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
-		new_e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
-		throw new_e;
 	}
 }
 
@@ -633,8 +1025,10 @@ void Analyzer::initialize_filtered_columns() throw (AnalyzerException) {
 	MetaNumeric* used_for_imp = NULL;
 	MetaFiltered* effect_hq = NULL;
 	MetaFiltered* se_hq = NULL;
+	vector<MetaFiltered*>::iterator filtered_metas_it;
 
 	unsigned int heap_size = 0;
+	double sketch_accuracy = 0.0;
 
 	stringstream string_stream;
 
@@ -647,13 +1041,10 @@ void Analyzer::initialize_filtered_columns() throw (AnalyzerException) {
 		imp_levels = gwafile->get_descriptor()->get_threshold(Descriptor::IMP);
 		snp_hq = gwafile->get_descriptor()->get_threshold(Descriptor::SNP_HQ);
 
-		if (gwafile->get_estimated_size() > numeric_limits<unsigned int>::max()) {
-			heap_size = Meta::HEAP_SIZE / 3;
-		} else {
-			heap_size = ((unsigned int)gwafile->get_estimated_size()) / 3;
-			if (heap_size == 0) {
-				heap_size = 1;
-			}
+		/* one bit per data line, so the exact line count keeps the filters from growing */
+		if ((gwafile->get_estimated_size() > numeric_limits<unsigned int>::max()) ||
+				((heap_size = (unsigned int)gwafile->get_estimated_size()) == 0)) {
+			heap_size = Meta::HEAP_SIZE;
 		}
 
 		numeric_metas_it = numeric_metas.begin();
@@ -868,6 +1259,12 @@ void Analyzer::initialize_filtered_columns() throw (AnalyzerException) {
 			filtered_metas.push_back(filtered_meta);
 			plots.push_back(filtered_meta);
 		}
+
+		if ((sketch_accuracy = get_sketch_accuracy()) > 0.0) {
+			for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+				(*filtered_metas_it)->set_sketch(sketch_accuracy);
+			}
+		}
 	} catch (Exception &e) {
 		AnalyzerException new_e(e);
 		new_e.add_message("Analyzer", "initialize_filtered_columns()", __LINE__, 8, gwafile->get_descriptor()->get_full_path());
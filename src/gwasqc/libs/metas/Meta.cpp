@@ -162,3 +162,32 @@ const char* Meta::get_na_marker() {
 double Meta::get_memory_usage() {
 	return 0.0;
 }
+
+void Meta::copy_properties(Meta* partial) throw (MetaException) {
+	partial->set_id(id);
+
+	if (common_name != NULL) {
+		partial->set_common_name(common_name);
+	}
+
+	if (actual_name != NULL) {
+		partial->set_actual_name(actual_name);
+	}
+
+	if (full_name != NULL) {
+		partial->set_full_name(full_name);
+	}
+
+	if (description != NULL) {
+		partial->set_description(description);
+	}
+
+	if (na_marker != NULL) {
+		partial->set_na_marker(na_marker);
+	}
+}
+
+/* a new partial meta processes a chunk of data in the same way only if this meta still processes every value */
+bool Meta::is_mergeable() {
+	return true;
+}
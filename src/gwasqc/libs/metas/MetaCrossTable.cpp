@@ -133,6 +133,82 @@ void MetaCrossTable::put(char* value) throw (MetaException) {
 	}
 }
 
+void MetaCrossTable::insert_x(double x_value) {
+	if (x_total.find(x_value) == x_total.end()) {
+		x_total.insert(pair<double, int>(x_value, 0));
+
+		row = new map<double, int>();
+		for (row_it = y_total.begin(); row_it != y_total.end(); row_it++) {
+			row->insert(pair<double, int>(row_it->first, 0));
+		}
+		y_na.insert(pair<double, int>(x_value, 0));
+
+		table.insert(pair<double, map<double, int>* >(x_value, row));
+	}
+}
+
+void MetaCrossTable::insert_y(double y_value) {
+	if (y_total.find(y_value) == y_total.end()) {
+		y_total.insert(pair<double, int>(y_value, 0));
+
+		for (column_it = table.begin(); column_it != table.end(); column_it++) {
+			column_it->second->insert(pair<double, int>(y_value, 0));
+		}
+		x_na.insert(pair<double, int>(y_value, 0));
+	}
+}
+
+Meta* MetaCrossTable::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaCrossTable* partial = new MetaCrossTable((MetaNumeric*)partials[x_meta], (MetaNumeric*)partials[y_meta]);
+
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
+	}
+
+	return partial;
+}
+
+void MetaCrossTable::merge(Meta* partial) throw (MetaException) {
+	MetaCrossTable* table_partial = (MetaCrossTable*)partial;
+	map<double, map<double, int>* >::iterator partial_column_it;
+	map<double, int>::iterator partial_row_it;
+
+	for (partial_row_it = table_partial->x_total.begin(); partial_row_it != table_partial->x_total.end(); partial_row_it++) {
+		insert_x(partial_row_it->first);
+		x_total.find(partial_row_it->first)->second += partial_row_it->second;
+	}
+
+	for (partial_row_it = table_partial->y_total.begin(); partial_row_it != table_partial->y_total.end(); partial_row_it++) {
+		insert_y(partial_row_it->first);
+		y_total.find(partial_row_it->first)->second += partial_row_it->second;
+	}
+
+	for (partial_column_it = table_partial->table.begin(); partial_column_it != table_partial->table.end(); partial_column_it++) {
+		row = table.find(partial_column_it->first)->second;
+		for (partial_row_it = partial_column_it->second->begin(); partial_row_it != partial_column_it->second->end(); partial_row_it++) {
+			row->find(partial_row_it->first)->second += partial_row_it->second;
+		}
+	}
+
+	for (partial_row_it = table_partial->x_na.begin(); partial_row_it != table_partial->x_na.end(); partial_row_it++) {
+		x_na.find(partial_row_it->first)->second += partial_row_it->second;
+	}
+
+	for (partial_row_it = table_partial->y_na.begin(); partial_row_it != table_partial->y_na.end(); partial_row_it++) {
+		y_na.find(partial_row_it->first)->second += partial_row_it->second;
+	}
+
+	xy_na += table_partial->xy_na;
+	x_na_total += table_partial->x_na_total;
+	y_na_total += table_partial->y_na_total;
+	xy_total += table_partial->xy_total;
+
+	row = NULL;
+}
+
 void MetaCrossTable::finalize() throw (MetaException) {
 
 }
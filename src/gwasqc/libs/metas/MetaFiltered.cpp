@@ -19,7 +19,7 @@
 
 #include "../../include/metas/MetaFiltered.h"
 
-MetaFiltered::MetaFiltered(MetaNumeric* source, unsigned int heap_size) throw (MetaException) : MetaNumeric(0), source(source), bitarray(NULL)  {
+MetaFiltered::MetaFiltered(MetaNumeric* source, unsigned int heap_size) throw (MetaException) : MetaNumeric(0), source(source), bitarray(NULL), shared_conditions(false)  {
 	affiliate_begin = affiliates.begin();
 	affiliate_end = affiliates.end();
 	condition_begin = conditions.begin();
@@ -31,8 +31,10 @@ MetaFiltered::MetaFiltered(MetaNumeric* source, unsigned int heap_size) throw (M
 MetaFiltered::~MetaFiltered() {
 	affiliates.clear();
 
-	for (condition_it = condition_begin; condition_it != condition_end; condition_it++) {
-		delete condition_it->second;
+	if (!shared_conditions) {
+		for (condition_it = condition_begin; condition_it != condition_end; condition_it++) {
+			delete condition_it->second;
+		}
 	}
 	conditions.clear();
 
@@ -58,6 +60,16 @@ MetaNumeric* MetaFiltered::get_source() {
 	return source;
 }
 
+/* in the sketch mode values are taken from the source one by one, so the bit array of the selected source values is not needed */
+void MetaFiltered::set_sketch(double accuracy) throw (MetaException) {
+	MetaNumeric::set_sketch(accuracy);
+
+	if (bitarray != NULL) {
+		delete bitarray;
+		bitarray = NULL;
+	}
+}
+
 void MetaFiltered::put(char* value) throw (MetaException) {
 	if (numeric) {
 		if (!source->is_numeric()) {
@@ -128,13 +140,21 @@ void MetaFiltered::put(char* value) throw (MetaException) {
 			n += 1;
 
 			value_saved = true;
-			bitarray->set_bit(source->get_n() - 1);
+			if (sketch != NULL) {
+				sketch->add(source->get_value());
+			} else {
+				bitarray->set_bit(source->get_n() - 1);
+			}
 			this->value = source->get_value();
 		}
 	}
 }
 
 void MetaFiltered::finalize() throw (MetaException) {
+	int data_size = 0;
+	vector<double> tail_data;
+	vector<double> tail_ranks;
+
 	if (source->get_n() <= 0) {
 		numeric = false;
 
@@ -150,58 +170,67 @@ void MetaFiltered::finalize() throw (MetaException) {
 	if (numeric) {
 		try {
 			if (n > 0) {
-				free(data);
-				data = NULL;
-
-				data = (double*)malloc((n + 1) * sizeof(double));
-				if (data == NULL) {
-					throw MetaException("MetaFiltered", "MetaFiltered( unsigned int )", __LINE__, 2, (n + 1) * sizeof(double));
-				}
-
-				bitarray->filter(source->get_data(), data, source->get_n());
-
-				mean = auxiliary::stats_mean(data, n);
-				sd = auxiliary::stats_sd(data, n, mean);
-				skew = auxiliary::stats_skewness(data, n, mean, sd);
-				kurtosis = auxiliary::stats_kurtosis(data, n, mean, sd);
-
-				qsort(data, n, sizeof(double), auxiliary::dblcmp);
+				if (sketch == NULL) {
+					free(data);
+					data = NULL;
 
-				median = auxiliary::stats_median_from_sorted_data(data, n);
+					data = (double*)malloc((n + 1) * sizeof(double));
+					if (data == NULL) {
+						throw MetaException("MetaFiltered", "MetaFiltered( unsigned int )", __LINE__, 2, (n + 1) * sizeof(double));
+					}
 
-				for (unsigned int j = 0; j < 9; j++) {
-					quantiles[j][1] = auxiliary::stats_quantile_from_sorted_data(data, n, quantiles[j][0]);
+					bitarray->filter(source->get_data(), data, source->get_n());
 				}
 
-				min = data[0];
-				max = data[n - 1];
+				data_size = calculate_statistics();
 
 				if (create_histogram) {
-					histogram = Histogram::create(actual_name, data, n, 1000);
+					histogram = Histogram::create(actual_name, data, data_size, 1000);
 					if (histogram != NULL) {
 						histogram->set_title(get_description());
+						if (data_size < n) {
+							histogram->scale_counts(n / (double)data_size);
+						}
 					}
 				}
 
 				if (create_boxplot) {
-					boxplot = Boxplot::create(actual_name, data, n, median);
+					boxplot = Boxplot::create(actual_name, data, data_size, median);
 					if (boxplot != NULL) {
 						boxplot->set_title(get_description());
 						boxplot->set_quantiles(quantiles[0][1], quantiles[3][1], quantiles[4][1], quantiles[5][1], quantiles[8][1]);
+						if (data_size < n) {
+							boxplot->set_observations(1, n);
+						}
 					}
 				}
 
 				if (create_qqplot) {
 					double lambda = numeric_limits<double>::quiet_NaN();
 
-					qqplot = Qqplot::create(get_description(), get_color(), data, numeric_limits<double>::quiet_NaN(), n);
+					if (sketch != NULL) {
+						sketch->get_tail_sample(tail_data, tail_ranks);
 
-					for (int i = 0; i < n; i++) {
-						data[i] = pow(Rf_qnorm5(0.5 * data[i], 0.0, 1.0, 0, 0), 2.0);
-					}
+						qqplot = Qqplot::create(get_description(), get_color(), &tail_data[0], &tail_ranks[0], numeric_limits<double>::quiet_NaN(), tail_data.size(), n);
 
-					qsort(data, n, sizeof(double), auxiliary::dblcmp);
-					lambda = auxiliary::stats_median_from_sorted_data(data, n) / Rf_qchisq(0.5, 1.0, 0, 0);
+						/* the transformation is decreasing, so the median of the transformed values comes from the median P-values */
+						if (n % 2 == 0) {
+							lambda = (pow(Rf_qnorm5(0.5 * sketch->get_value(n / 2 - 1), 0.0, 1.0, 0, 0), 2.0) +
+									pow(Rf_qnorm5(0.5 * sketch->get_value(n / 2), 0.0, 1.0, 0, 0), 2.0)) / 2.0;
+						} else {
+							lambda = pow(Rf_qnorm5(0.5 * sketch->get_value((n - 1) / 2), 0.0, 1.0, 0, 0), 2.0);
+						}
+						lambda = lambda / Rf_qchisq(0.5, 1.0, 0, 0);
+					} else {
+						qqplot = Qqplot::create(get_description(), get_color(), data, numeric_limits<double>::quiet_NaN(), n);
+
+						for (int i = 0; i < n; i++) {
+							data[i] = pow(Rf_qnorm5(0.5 * data[i], 0.0, 1.0, 0, 0), 2.0);
+						}
+
+						qsort(data, n, sizeof(double), auxiliary::dblcmp);
+						lambda = auxiliary::stats_median_from_sorted_data(data, n) / Rf_qchisq(0.5, 1.0, 0, 0);
+					}
 
 					qqplot->set_lambda(1, lambda);
 				}
@@ -237,6 +266,70 @@ void MetaFiltered::print_html(ostream& stream, char path_separator) {
 
 }
 
+/* partial metas share the conditions, but depend on partial metas of the same columns */
+Meta* MetaFiltered::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaFiltered* partial = new MetaFiltered((MetaNumeric*)partials[source], heap_size);
+
+	partial->shared_conditions = true;
+
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
+	}
+
+	for (affiliate_it = affiliate_begin; affiliate_it != affiliate_end; affiliate_it++) {
+		partial->add_dependency(*((MetaNumeric*)partials[*affiliate_it]));
+	}
+
+	for (condition_it = condition_begin; condition_it != condition_end; condition_it++) {
+		partial->add_dependency(*((MetaNumeric*)partials[condition_it->first]), *(condition_it->second));
+	}
+
+	return partial;
+}
+
+/* must be called before the source is merged, because the partial bits are shifted by the number of source values */
+void MetaFiltered::merge(Meta* partial) throw (MetaException) {
+	MetaFiltered* filtered_partial = (MetaFiltered*)partial;
+
+	if (!numeric) {
+		return;
+	}
+
+	n += filtered_partial->n;
+	na += filtered_partial->na;
+	na_value = filtered_partial->na_value;
+	value_saved = filtered_partial->value_saved;
+	value = filtered_partial->value;
+
+	if (!filtered_partial->numeric) {
+		numeric = false;
+
+		free(data);
+		data = NULL;
+
+		delete bitarray;
+		bitarray = NULL;
+
+		return;
+	}
+
+	if (sketch != NULL) {
+		sketch->merge(*(filtered_partial->sketch));
+		return;
+	}
+
+	try {
+		bitarray->merge(*(filtered_partial->bitarray), source->get_n(), filtered_partial->source->get_n());
+	} catch (BitArrayException &e) {
+		MetaException new_e(e);
+		new_e.add_message("MetaFiltered", "merge( Meta* )", __LINE__, 4, actual_name != NULL ? actual_name : "NULL");
+		throw new_e;
+	}
+}
+
 double MetaFiltered::get_memory_usage() {
 	unsigned long int memory = 0;
 
@@ -244,6 +337,10 @@ double MetaFiltered::get_memory_usage() {
 		memory += bitarray->get_total_bytes() * sizeof(unsigned char);
 	}
 
+	if (sketch != NULL) {
+		memory += sketch->get_memory_usage();
+	}
+
 	return memory / 1048576.0;
 }
 
@@ -40,7 +40,7 @@ void MetaFormat::put(char* value) throw (MetaException) {
 		char* end_ptr = NULL;
 		double d_value = 0.0;
 
-		d_value = R_strtod(value, &end_ptr);
+		d_value = auxiliary::fast_strtod(value, &end_ptr);
 
 		if (*end_ptr != '\0') {
 			numeric = false;
@@ -86,6 +86,33 @@ void MetaFormat::print_html(ostream& stream, char path_separator) {
 	stream << "</div>";
 }
 
+Meta* MetaFormat::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaFormat* partial = new MetaFormat();
+
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
+	}
+
+	return partial;
+}
+
+void MetaFormat::merge(Meta* partial) throw (MetaException) {
+	MetaFormat* format_partial = (MetaFormat*)partial;
+
+	if (numeric) {
+		n += format_partial->n;
+		numeric = format_partial->numeric;
+		na_value = format_partial->na_value;
+	}
+}
+
+bool MetaFormat::is_mergeable() {
+	return numeric;
+}
+
 double MetaFormat::get_memory_usage() {
 	return 0.0;
 }
@@ -196,6 +196,43 @@ void MetaGroup::print_html(ostream& stream, char path_separator) {
 	}
 }
 
+Meta* MetaGroup::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaGroup* partial = new MetaGroup(trim_output);
+
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
+	}
+
+	return partial;
+}
+
+void MetaGroup::merge(Meta* partial) throw (MetaException) {
+	MetaGroup* group_partial = (MetaGroup*)partial;
+	map<char*, int, bool(*)(const char*, const char*)>::iterator partial_groups_it;
+
+	for (partial_groups_it = group_partial->groups.begin(); partial_groups_it != group_partial->groups.end(); partial_groups_it++) {
+		groups_it = groups.find(partial_groups_it->first);
+
+		if (groups_it != groups.end()) {
+			groups_it->second += partial_groups_it->second;
+		}
+		else {
+			new_value = (char*)malloc((strlen(partial_groups_it->first) + 1) * sizeof(char));
+			if (new_value == NULL) {
+				throw MetaException("MetaGroup", "merge( Meta* )", __LINE__, 2, (strlen(partial_groups_it->first) + 1) * sizeof(char));
+			}
+			strcpy(new_value, partial_groups_it->first);
+
+			groups.insert(pair<char*, int>(new_value, partial_groups_it->second));
+		}
+	}
+
+	na_value = group_partial->na_value;
+}
+
 double MetaGroup::get_memory_usage() {
 	unsigned long int memory = 0;
 
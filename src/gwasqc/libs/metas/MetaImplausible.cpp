@@ -48,7 +48,7 @@ void MetaImplausible::put(char* value) throw (MetaException) {
 			na_value = false;
 		}
 
-		d_value = R_strtod(value, &end_ptr);
+		d_value = auxiliary::fast_strtod(value, &end_ptr);
 
 		if (*end_ptr != '\0') {
 			numeric = false;
@@ -81,22 +81,7 @@ void MetaImplausible::put(char* value) throw (MetaException) {
 			return;
 		}
 
-		n += 1;
-
-		if (n > current_heap_size) {
-			current_heap_size += Meta::HEAP_INCREMENT;
-
-			new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-			if (new_data == NULL) {
-				free(data);
-				data = NULL;
-				throw MetaException("MetaImplausible", "put( char* )", __LINE__, 3, current_heap_size * sizeof(double));
-			}
-			data = new_data;
-		}
-
-		value_saved = true;
-		data[n - 1] = d_value;
+		save_value(d_value);
 	}
 }
 
@@ -252,6 +237,28 @@ void MetaImplausible::print_html(ostream& stream, char path_separator) {
 	}
 }
 
+Meta* MetaImplausible::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaImplausible* partial = new MetaImplausible(less, greater, heap_size);
+
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
+	}
+
+	return partial;
+}
+
+void MetaImplausible::merge(Meta* partial) throw (MetaException) {
+	if (numeric) {
+		n_less += ((MetaImplausible*)partial)->n_less;
+		n_greater += ((MetaImplausible*)partial)->n_greater;
+	}
+
+	MetaNumeric::merge(partial);
+}
+
 void MetaImplausible::set_implausible(double less, double greater) {
 	this->less = less;
 	this->greater = greater;
@@ -41,7 +41,7 @@ void MetaImplausibleStrictAdjusted::put(char* value) throw (MetaException) {
 			na_value = false;
 		}
 
-		d_value = R_strtod(value, &end_ptr);
+		d_value = auxiliary::fast_strtod(value, &end_ptr);
 
 		if (*end_ptr != '\0') {
 			numeric = false;
@@ -74,23 +74,21 @@ void MetaImplausibleStrictAdjusted::put(char* value) throw (MetaException) {
 			return;
 		}
 
-		n += 1;
+		save_value(this->value);
+	}
+}
 
-		if (n > current_heap_size) {
-			current_heap_size += Meta::HEAP_INCREMENT;
+Meta* MetaImplausibleStrictAdjusted::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaImplausibleStrictAdjusted* partial = new MetaImplausibleStrictAdjusted(less, greater, threshold, heap_size);
 
-			new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-			if (new_data == NULL) {
-				free(data);
-				data = NULL;
-				throw MetaException("MetaImplausibleStrictAdjusted", "put( char* )", __LINE__, 3, current_heap_size * sizeof(double));
-			}
-			data = new_data;
-		}
-
-		value_saved = true;
-		data[n - 1] = this->value;
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
 	}
+
+	return partial;
 }
 
 void MetaImplausibleStrictAdjusted::set_threshold(double threshold) {
@@ -27,7 +27,7 @@ MetaNumeric::MetaNumeric(unsigned int heap_size) throw (MetaException) : Meta(),
 	median(numeric_limits<double>::quiet_NaN()),
 	skew(0.0), kurtosis(0.0),
 	numeric(true), na_value(false), value_saved(false), value(numeric_limits<double>::quiet_NaN()),
-	data(NULL), new_data(NULL), current_heap_size(heap_size),
+	data(NULL), new_data(NULL), current_heap_size(heap_size), sketch(NULL),
 	color(NULL), create_histogram(true), create_boxplot(true), create_qqplot(true),
 	histogram(NULL), boxplot(NULL), qqplot(NULL), plot(NULL), print_min(true),
 	print_max(true), print_median(true), print_skewness(true), print_kurtosis(true),
@@ -56,6 +56,8 @@ MetaNumeric::~MetaNumeric() {
 	delete histogram;
 	delete qqplot;
 
+	delete sketch;
+
 	free(color);
 	free(data);
 
@@ -64,6 +66,45 @@ MetaNumeric::~MetaNumeric() {
 	qqplot = NULL;
 	color = NULL;
 	data = NULL;
+	sketch = NULL;
+}
+
+/* values are summarized in a sketch with the given relative accuracy of quantiles, instead of being kept until finalize() */
+void MetaNumeric::set_sketch(double accuracy) throw (MetaException) {
+	Sketch* new_sketch = new Sketch(accuracy);
+
+	delete sketch;
+	sketch = new_sketch;
+
+	free(data);
+	data = NULL;
+	current_heap_size = 0;
+}
+
+void MetaNumeric::save_value(double value) throw (MetaException) {
+	n += 1;
+
+	if (sketch != NULL) {
+		sketch->add(value);
+	} else {
+		if (n > current_heap_size) {
+			current_heap_size += Meta::HEAP_INCREMENT;
+
+			new_data = (double*)realloc(data, current_heap_size * sizeof(double));
+			if (new_data == NULL) {
+				free(data);
+				data = NULL;
+				throw MetaException("MetaNumeric", "save_value( double )", __LINE__, 3, current_heap_size * sizeof(double));
+			}
+
+			data = new_data;
+		}
+
+		data[n - 1] = value;
+	}
+
+	value_saved = true;
+	this->value = value;
 }
 
 void MetaNumeric::put(char* value) throw (MetaException) {
@@ -79,7 +120,7 @@ void MetaNumeric::put(char* value) throw (MetaException) {
 			na_value = false;
 		}
 
-		d_value = R_strtod(value, &end_ptr);
+		d_value = auxiliary::fast_strtod(value, &end_ptr);
 
 		if (*end_ptr != '\0') {
 			numeric = false;
@@ -98,27 +139,66 @@ void MetaNumeric::put(char* value) throw (MetaException) {
 			return;
 		}
 
-		n += 1;
+		save_value(d_value);
+	}
+}
+
+/* returns the number of sorted values in data, which is a sample of the sketch in the sketch mode */
+int MetaNumeric::calculate_statistics() throw (MetaException) {
+	int data_size = n;
 
-		if (n > current_heap_size) {
-			current_heap_size += Meta::HEAP_INCREMENT;
+	if (sketch != NULL) {
+		mean = sketch->get_mean();
+		sd = sketch->get_sd();
+		skew = sketch->get_skewness();
+		kurtosis = sketch->get_kurtosis();
 
-			new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-			if (new_data == NULL) {
-				free(data);
-				data = NULL;
-				throw MetaException("MetaNumeric", "put( char* )", __LINE__, 3, current_heap_size * sizeof(double));
-			}
+		median = sketch->get_median();
 
-			data = new_data;
+		for (unsigned int j = 0; j < 9; j++) {
+			quantiles[j][1] = sketch->get_quantile(quantiles[j][0]);
 		}
 
-		value_saved = true;
-		this->value = d_value;
-		data[n - 1] = d_value;
+		min = sketch->get_min();
+		max = sketch->get_max();
+
+		if ((unsigned int)data_size > Sketch::SAMPLE_SIZE) {
+			data_size = Sketch::SAMPLE_SIZE;
+		}
+
+		free(data);
+		data = (double*)malloc(data_size * sizeof(double));
+		if (data == NULL) {
+			throw MetaException("MetaNumeric", "calculate_statistics()", __LINE__, 2, data_size * sizeof(double));
+		}
+
+		sketch->get_sample(data, data_size);
+
+		return data_size;
 	}
+
+	mean = auxiliary::stats_mean(data, n);
+	sd = auxiliary::stats_sd(data, n, mean);
+	skew = auxiliary::stats_skewness(data, n, mean, sd);
+	kurtosis = auxiliary::stats_kurtosis(data, n, mean, sd);
+
+	qsort(data, n, sizeof(double), dblcmp);
+
+	median = auxiliary::stats_median_from_sorted_data(data, n);
+
+	for (unsigned int j = 0; j < 9; j++) {
+		quantiles[j][1] = auxiliary::stats_quantile_from_sorted_data(data, n, quantiles[j][0]);
+	}
+
+	min = data[0];
+	max = data[n - 1];
+
+	return data_size;
 }
+
 void MetaNumeric::finalize() throw (MetaException) {
+	int data_size = 0;
+
 	if (n <= 0) {
 		numeric = false;
 		free(data);
@@ -127,35 +207,27 @@ void MetaNumeric::finalize() throw (MetaException) {
 	}
 
 	if (numeric) {
-		mean = auxiliary::stats_mean(data, n);
-		sd = auxiliary::stats_sd(data, n, mean);
-		skew = auxiliary::stats_skewness(data, n, mean, sd);
-		kurtosis = auxiliary::stats_kurtosis(data, n, mean, sd);
-
-		qsort(data, n, sizeof(double), dblcmp);
-
-		median = auxiliary::stats_median_from_sorted_data(data, n);
-
-		for (unsigned int j = 0; j < 9; j++) {
-			quantiles[j][1] = auxiliary::stats_quantile_from_sorted_data(data, n, quantiles[j][0]);
-		}
-
-		min = data[0];
-		max = data[n - 1];
+		data_size = calculate_statistics();
 
 		try {
 			if (create_histogram) {
-				histogram = Histogram::create(actual_name, data, n, 1000);
+				histogram = Histogram::create(actual_name, data, data_size, 1000);
 				if (histogram != NULL) {
 					histogram->set_title(get_description());
+					if (data_size < n) {
+						histogram->scale_counts(n / (double)data_size);
+					}
 				}
 			}
 
 			if (create_boxplot) {
-				boxplot = Boxplot::create(actual_name, data, n, median);
+				boxplot = Boxplot::create(actual_name, data, data_size, median);
 				if (boxplot != NULL) {
 					boxplot->set_quantiles(quantiles[0][1], quantiles[3][1], quantiles[4][1], quantiles[5][1], quantiles[8][1]);
 					boxplot->set_title(get_description());
+					if (data_size < n) {
+						boxplot->set_observations(1, n);
+					}
 				}
 			}
 		} catch (PlotException &e) {
@@ -169,6 +241,76 @@ void MetaNumeric::finalize() throw (MetaException) {
 	data = NULL;
 }
 
+Meta* MetaNumeric::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaNumeric* partial = new MetaNumeric(heap_size);
+
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
+	}
+
+	return partial;
+}
+
+void MetaNumeric::copy_properties(Meta* partial) throw (MetaException) {
+	Meta::copy_properties(partial);
+
+	if (sketch != NULL) {
+		((MetaNumeric*)partial)->set_sketch(sketch->get_accuracy());
+	}
+}
+
+void MetaNumeric::merge(Meta* partial) throw (MetaException) {
+	MetaNumeric* numeric_partial = (MetaNumeric*)partial;
+
+	if (!numeric) {
+		return;
+	}
+
+	n += numeric_partial->n;
+	na += numeric_partial->na;
+	na_value = numeric_partial->na_value;
+	value_saved = numeric_partial->value_saved;
+	value = numeric_partial->value;
+
+	if (!numeric_partial->numeric) {
+		numeric = false;
+		free(data);
+		data = NULL;
+		return;
+	}
+
+	if (sketch != NULL) {
+		sketch->merge(*(numeric_partial->sketch));
+		return;
+	}
+
+	if (n > current_heap_size) {
+		while (n > current_heap_size) {
+			current_heap_size += Meta::HEAP_INCREMENT;
+		}
+
+		new_data = (double*)realloc(data, current_heap_size * sizeof(double));
+		if (new_data == NULL) {
+			free(data);
+			data = NULL;
+			throw MetaException("MetaNumeric", "merge( Meta* )", __LINE__, 3, current_heap_size * sizeof(double));
+		}
+
+		data = new_data;
+	}
+
+	if (numeric_partial->n > 0) {
+		memcpy(data + n - numeric_partial->n, numeric_partial->data, numeric_partial->n * sizeof(double));
+	}
+}
+
+bool MetaNumeric::is_mergeable() {
+	return numeric;
+}
+
 bool MetaNumeric::is_na() {
 	return na_value;
 }
@@ -452,6 +594,10 @@ double MetaNumeric::get_memory_usage() {
 
 	memory += current_heap_size * sizeof(double);
 
+	if (sketch != NULL) {
+		memory += sketch->get_memory_usage();
+	}
+
 	return memory / 1048576.0;
 }
 
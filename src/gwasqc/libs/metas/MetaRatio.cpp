@@ -92,15 +92,13 @@ void MetaRatio::put(char* value) throw (MetaException) {
 		return;
 	}
 
-	double ratio = source_a->get_value() / source_b->get_value();
-	double p_wald = Rf_pchisq(ratio * ratio, 1.0, 0, 0);
-
 	new_value = (double*)malloc(2 * sizeof(double));
 	if (new_value == NULL) {
 		throw MetaException("MetaRatio", "put( char* )", __LINE__, 2, (2 * sizeof(double)));
 	}
 
-	new_value[0] = p_wald;
+	/* Wald P-value is calculated in finalize(), since R functions must not be called from the worker threads */
+	new_value[0] = source_a->get_value() / source_b->get_value();
 	new_value[1] = source_a->get_value();
 
 	n += 1;
@@ -131,6 +129,10 @@ void MetaRatio::finalize() throw (MetaException) {
 		double mean = 0.0;
 		double sd = 0.0;
 
+		for (int i = 0; i < n; i++) {
+			data[i][0] = Rf_pchisq(data[i][0] * data[i][0], 1.0, 0, 0);
+		}
+
 		qsort(data, n, sizeof(double*), auxiliary::qsort_dblcmp_array);
 
 		values = (double*)malloc(n * sizeof(double));
@@ -178,6 +180,44 @@ void MetaRatio::print_html(ostream& stream, char path_separator) {
 
 }
 
+Meta* MetaRatio::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaRatio* partial = new MetaRatio((MetaNumeric*)partials[source_a], (MetaNumeric*)partials[source_b], heap_size);
+
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
+	}
+
+	return partial;
+}
+
+/* values are moved from the partial meta */
+void MetaRatio::merge(Meta* partial) throw (MetaException) {
+	MetaRatio* ratio_partial = (MetaRatio*)partial;
+
+	if (n + ratio_partial->n > current_heap_size) {
+		while (n + ratio_partial->n > current_heap_size) {
+			current_heap_size += Meta::HEAP_INCREMENT;
+		}
+
+		new_data = (double**)realloc(data, current_heap_size * sizeof(double*));
+		if (new_data == NULL) {
+			throw MetaException("MetaRatio", "merge( Meta* )", __LINE__, 3, current_heap_size * sizeof(double*));
+		}
+
+		data = new_data;
+	}
+
+	for (int i = 0; i < ratio_partial->n; i++) {
+		data[n + i] = ratio_partial->data[i];
+	}
+
+	n += ratio_partial->n;
+	ratio_partial->n = 0;
+}
+
 double MetaRatio::get_memory_usage() {
 	unsigned long int memory = 0;
 
@@ -153,6 +153,46 @@ void MetaUniqueness::print_html(ostream& stream, char path_separator) {
 	}
 }
 
+Meta* MetaUniqueness::create_partial(map<Meta*, Meta*>& partials, unsigned int heap_size) throw (MetaException) {
+	MetaUniqueness* partial = new MetaUniqueness(heap_size);
+
+	try {
+		copy_properties(partial);
+	} catch (MetaException &e) {
+		delete partial;
+		throw;
+	}
+
+	return partial;
+}
+
+/* values are moved from the partial meta */
+void MetaUniqueness::merge(Meta* partial) throw (MetaException) {
+	MetaUniqueness* uniqueness_partial = (MetaUniqueness*)partial;
+
+	if (n + uniqueness_partial->n > current_heap_size) {
+		while (n + uniqueness_partial->n > current_heap_size) {
+			current_heap_size += Meta::HEAP_INCREMENT;
+		}
+
+		new_data = (char**)realloc(data, current_heap_size * sizeof(char*));
+		if (new_data == NULL) {
+			throw MetaException("MetaUniqueness", "merge( Meta* )", __LINE__, 3, current_heap_size * sizeof(char*));
+		}
+
+		data = new_data;
+	}
+
+	for (int i = 0; i < uniqueness_partial->n; i++) {
+		data[n + i] = uniqueness_partial->data[i];
+	}
+
+	n += uniqueness_partial->n;
+	uniqueness_partial->n = 0;
+
+	na_value = uniqueness_partial->na_value;
+}
+
 double MetaUniqueness::get_memory_usage() {
 	unsigned long int memory = 0;
 
@@ -0,0 +1,406 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../include/metas/Sketch.h"
+
+const double Sketch::DEFAULT_ACCURACY = 0.01;
+const unsigned int Sketch::SAMPLE_SIZE = 100000;
+
+Sketch::Sketch(double accuracy) throw (MetaException) :
+	accuracy(accuracy), gamma(0.0), log_gamma(0.0),
+	positive_offset(0), negative_offset(0), zeros(0ul), negative_infinities(0ul), positive_infinities(0ul),
+	n(0ul), min(numeric_limits<double>::infinity()), max(-numeric_limits<double>::infinity()),
+	mean(0.0), m2(0.0), m3(0.0), m4(0.0), buckets_valid(false) {
+
+	if (!(accuracy > 0.0) || !(accuracy < 1.0)) {
+		throw MetaException("Sketch", "Sketch( double )", __LINE__, 1, "accuracy");
+	}
+
+	gamma = (1.0 + accuracy) / (1.0 - accuracy);
+	log_gamma = log(gamma);
+}
+
+Sketch::~Sketch() {
+	positive.clear();
+	negative.clear();
+	buckets.clear();
+}
+
+int Sketch::get_index(double value) {
+	return (int)ceil(log(value) / log_gamma);
+}
+
+void Sketch::add(vector<cell>& cells, int& offset, int index, unsigned long int count, double value) throw (MetaException) {
+	cell empty_cell;
+	int margin = 0;
+
+	empty_cell.count = 0ul;
+	empty_cell.value = 0.0;
+
+	try {
+		if (cells.empty()) {
+			cells.resize(1, empty_cell);
+			offset = index;
+		} else if (index < offset) {
+			/* prepend at least as many cells as there are, so that descending values do not shift the cells every time */
+			margin = offset - index > (int)cells.size() ? offset - index : (int)cells.size();
+			cells.insert(cells.begin(), margin, empty_cell);
+			offset -= margin;
+		} else if (index - offset >= (int)cells.size()) {
+			cells.resize(index - offset + 1, empty_cell);
+		}
+	} catch (bad_alloc &e) {
+		throw MetaException("Sketch", "add( vector<cell>&, int&, int, unsigned long int, double )", __LINE__, 3, (cells.size() + margin + 1) * sizeof(cell));
+	}
+
+	if (cells[index - offset].count == 0ul) {
+		cells[index - offset].value = value;
+	} else if (cells[index - offset].value != value) {
+		cells[index - offset].value = numeric_limits<double>::quiet_NaN();
+	}
+
+	cells[index - offset].count += count;
+}
+
+void Sketch::add(double value) throw (MetaException) {
+	double n1 = (double)n;
+	double delta = 0.0, delta_n = 0.0, delta_n2 = 0.0, term = 0.0;
+
+	if (value > 0.0) {
+		if (value == numeric_limits<double>::infinity()) {
+			positive_infinities += 1ul;
+		} else {
+			add(positive, positive_offset, get_index(value), 1ul, value);
+		}
+	} else if (value < 0.0) {
+		if (value == -numeric_limits<double>::infinity()) {
+			negative_infinities += 1ul;
+		} else {
+			add(negative, negative_offset, get_index(-value), 1ul, value);
+		}
+	} else {
+		zeros += 1ul;
+	}
+
+	n += 1ul;
+
+	if (value < min) {
+		min = value;
+	}
+
+	if (value > max) {
+		max = value;
+	}
+
+	/* one-pass update of the central moments (Pebay, 2008) */
+	delta = value - mean;
+	delta_n = delta / n;
+	delta_n2 = delta_n * delta_n;
+	term = delta * delta_n * n1;
+
+	mean += delta_n;
+	m4 += term * delta_n2 * ((double)n * n - 3.0 * n + 3.0) + 6.0 * delta_n2 * m2 - 4.0 * delta_n * m3;
+	m3 += term * delta_n * (n - 2.0) - 3.0 * delta_n * m2;
+	m2 += term;
+
+	buckets_valid = false;
+}
+
+void Sketch::merge(Sketch& sketch) throw (MetaException) {
+	double n_a = (double)n, n_b = (double)sketch.n, n_ab = 0.0;
+	double delta = 0.0, delta2 = 0.0;
+	double new_mean = 0.0, new_m2 = 0.0, new_m3 = 0.0, new_m4 = 0.0;
+
+	if (sketch.accuracy != accuracy) {
+		throw MetaException("Sketch", "merge( Sketch& )", __LINE__, 1, "sketch");
+	}
+
+	if (sketch.n == 0ul) {
+		return;
+	}
+
+	for (unsigned int i = 0u; i < sketch.positive.size(); i++) {
+		if (sketch.positive[i].count > 0ul) {
+			add(positive, positive_offset, sketch.positive_offset + (int)i, sketch.positive[i].count, sketch.positive[i].value);
+		}
+	}
+
+	for (unsigned int i = 0u; i < sketch.negative.size(); i++) {
+		if (sketch.negative[i].count > 0ul) {
+			add(negative, negative_offset, sketch.negative_offset + (int)i, sketch.negative[i].count, sketch.negative[i].value);
+		}
+	}
+
+	zeros += sketch.zeros;
+	negative_infinities += sketch.negative_infinities;
+	positive_infinities += sketch.positive_infinities;
+
+	if (sketch.min < min) {
+		min = sketch.min;
+	}
+
+	if (sketch.max > max) {
+		max = sketch.max;
+	}
+
+	/* pairwise combination of the central moments (Pebay, 2008) */
+	if (n == 0ul) {
+		new_mean = sketch.mean;
+		new_m2 = sketch.m2;
+		new_m3 = sketch.m3;
+		new_m4 = sketch.m4;
+	} else {
+		n_ab = n_a + n_b;
+		delta = sketch.mean - mean;
+		delta2 = delta * delta;
+
+		new_mean = mean + delta * n_b / n_ab;
+		new_m2 = m2 + sketch.m2 + delta2 * n_a * n_b / n_ab;
+		new_m3 = m3 + sketch.m3 + delta2 * delta * n_a * n_b * (n_a - n_b) / (n_ab * n_ab) +
+				3.0 * delta * (n_a * sketch.m2 - n_b * m2) / n_ab;
+		new_m4 = m4 + sketch.m4 + delta2 * delta2 * n_a * n_b * (n_a * n_a - n_a * n_b + n_b * n_b) / (n_ab * n_ab * n_ab) +
+				6.0 * delta2 * (n_a * n_a * sketch.m2 + n_b * n_b * m2) / (n_ab * n_ab) +
+				4.0 * delta * (n_a * sketch.m3 - n_b * m3) / n_ab;
+	}
+
+	mean = new_mean;
+	m2 = new_m2;
+	m3 = new_m3;
+	m4 = new_m4;
+
+	n += sketch.n;
+
+	buckets_valid = false;
+}
+
+/* bucket bounds are clipped to the exact minimum and maximum */
+void Sketch::add_bucket(double lower, double upper, double value, unsigned long int count) {
+	bucket new_bucket;
+
+	new_bucket.lower = lower < min ? min : (lower > max ? max : lower);
+	new_bucket.upper = upper < min ? min : (upper > max ? max : upper);
+	new_bucket.value = value < min ? min : (value > max ? max : value);
+	new_bucket.first = buckets.empty() ? 0ul : buckets.back().first + buckets.back().count;
+	new_bucket.count = count;
+
+	buckets.push_back(new_bucket);
+}
+
+/* the value representing cell k is gamma^k * (1 - accuracy), which is within the relative accuracy from any value in the cell */
+void Sketch::build_buckets() {
+	double upper = 0.0;
+
+	buckets.clear();
+
+	if (negative_infinities > 0ul) {
+		add_bucket(-numeric_limits<double>::infinity(), -numeric_limits<double>::infinity(), -numeric_limits<double>::infinity(), negative_infinities);
+	}
+
+	for (unsigned int i = negative.size(); i > 0u; i--) {
+		if (negative[i - 1u].count > 0ul) {
+			if (ISNAN(negative[i - 1u].value)) {
+				upper = pow(gamma, negative_offset + (int)i - 1);
+				add_bucket(-upper, -upper / gamma, -upper * (1.0 - accuracy), negative[i - 1u].count);
+			} else {
+				add_bucket(negative[i - 1u].value, negative[i - 1u].value, negative[i - 1u].value, negative[i - 1u].count);
+			}
+		}
+	}
+
+	if (zeros > 0ul) {
+		add_bucket(0.0, 0.0, 0.0, zeros);
+	}
+
+	for (unsigned int i = 0u; i < positive.size(); i++) {
+		if (positive[i].count > 0ul) {
+			if (ISNAN(positive[i].value)) {
+				upper = pow(gamma, positive_offset + (int)i);
+				add_bucket(upper / gamma, upper, upper * (1.0 - accuracy), positive[i].count);
+			} else {
+				add_bucket(positive[i].value, positive[i].value, positive[i].value, positive[i].count);
+			}
+		}
+	}
+
+	if (positive_infinities > 0ul) {
+		add_bucket(numeric_limits<double>::infinity(), numeric_limits<double>::infinity(), numeric_limits<double>::infinity(), positive_infinities);
+	}
+
+	buckets_valid = true;
+}
+
+vector<Sketch::bucket>::iterator Sketch::find_bucket(unsigned long int rank) {
+	unsigned int lower = 0u, upper = 0u, middle = 0u;
+
+	if (!buckets_valid) {
+		build_buckets();
+	}
+
+	upper = buckets.size() - 1u;
+	while (lower < upper) {
+		middle = (lower + upper + 1u) / 2u;
+		if (buckets[middle].first <= rank) {
+			lower = middle;
+		} else {
+			upper = middle - 1u;
+		}
+	}
+
+	return buckets.begin() + lower;
+}
+
+/* spreads the values of a bucket uniformly between its bounds */
+double Sketch::interpolate(vector<bucket>::iterator bucket_it, unsigned long int rank) {
+	if (rank == 0ul) {
+		return min;
+	}
+
+	if (rank >= n - 1ul) {
+		return max;
+	}
+
+	if (bucket_it->lower == bucket_it->upper) {
+		return bucket_it->lower;
+	}
+
+	return bucket_it->lower + (bucket_it->upper - bucket_it->lower) * ((rank - bucket_it->first) + 0.5) / bucket_it->count;
+}
+
+double Sketch::get_accuracy() {
+	return accuracy;
+}
+
+unsigned long int Sketch::get_n() {
+	return n;
+}
+
+double Sketch::get_min() {
+	return min;
+}
+
+double Sketch::get_max() {
+	return max;
+}
+
+double Sketch::get_mean() {
+	return n > 0ul ? mean : numeric_limits<double>::quiet_NaN();
+}
+
+double Sketch::get_sd() {
+	return sqrt(m2 / (n - 1.0));
+}
+
+double Sketch::get_skewness() {
+	return (m3 / n) / pow(get_sd(), 3.0);
+}
+
+double Sketch::get_kurtosis() {
+	return (m4 / n) / pow(get_sd(), 4.0) - 3.0;
+}
+
+/* value of the given rank (starting from 0) in the sorted data */
+double Sketch::get_value(unsigned long int rank) {
+	if (n == 0ul) {
+		return numeric_limits<double>::quiet_NaN();
+	}
+
+	if (rank == 0ul) {
+		return min;
+	}
+
+	if (rank >= n - 1ul) {
+		return max;
+	}
+
+	return find_bucket(rank)->value;
+}
+
+/* same definition as auxiliary::stats_median_from_sorted_data() */
+double Sketch::get_median() {
+	if (n % 2ul == 0ul) {
+		return (get_value(n / 2ul - 1ul) + get_value(n / 2ul)) / 2.0;
+	} else {
+		return get_value((n - 1ul) / 2ul);
+	}
+}
+
+/* same definition as auxiliary::stats_quantile_from_sorted_data() */
+double Sketch::get_quantile(double fraction) {
+	unsigned long int i = (unsigned long int)floor((n - 1ul) * fraction);
+	double delta = (n - 1ul) * fraction - i;
+
+	if (delta == 0) {
+		return get_value(i);
+	} else if (delta == 1) {
+		return get_value(i + 1ul);
+	}
+
+	return (1 - delta) * get_value(i) + delta * get_value(i + 1ul);
+}
+
+/* sorted values at evenly spaced ranks, which keep the shape of the distribution in histograms and boxplots */
+void Sketch::get_sample(double* data, unsigned int size) {
+	unsigned long int rank = 0ul;
+
+	if ((n == 0ul) || (size == 0u)) {
+		return;
+	}
+
+	data[0] = min;
+	for (unsigned int i = 1u; i < size; i++) {
+		rank = (unsigned long int)floor(i * ((n - 1ul) / (double)(size - 1u)) + 0.5);
+		data[i] = interpolate(find_bucket(rank), rank);
+	}
+}
+
+/* sorted values at ranks (starting from 1) that grow geometrically, so that every one of the smallest ranks is sampled for QQ-plots; only the minimum is exact, other values are within the relative error */
+void Sketch::get_tail_sample(vector<double>& data, vector<double>& ranks) throw (MetaException) {
+	unsigned long int rank = 1ul;
+	unsigned long int next_rank = 0ul;
+
+	data.clear();
+	ranks.clear();
+
+	if (n == 0ul) {
+		return;
+	}
+
+	try {
+		while (true) {
+			data.push_back(interpolate(find_bucket(rank - 1ul), rank - 1ul));
+			ranks.push_back((double)rank);
+
+			if (rank >= n) {
+				break;
+			}
+
+			next_rank = (unsigned long int)ceil(rank * gamma);
+			if (next_rank <= rank) {
+				next_rank = rank + 1ul;
+			}
+			rank = next_rank < n ? next_rank : n;
+		}
+	} catch (bad_alloc &e) {
+		throw MetaException("Sketch", "get_tail_sample( vector<double>&, vector<double>& )", __LINE__, 3, (data.size() + 1u) * sizeof(double));
+	}
+}
+
+unsigned long int Sketch::get_memory_usage() {
+	return (positive.capacity() + negative.capacity()) * sizeof(cell) + buckets.capacity() * sizeof(bucket);
+}
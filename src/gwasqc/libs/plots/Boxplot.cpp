@@ -423,6 +423,15 @@ void Boxplot::set_width(int group, double width) throw (PlotException) {
 	widths[group] = width;
 }
 
+void Boxplot::set_observations(int group, int observations) throw (PlotException) {
+	if ((group <= 0) || (group > groups_cnt)) {
+		throw PlotException("Boxplot", "set_observations( int, int )", __LINE__, 1, "group");
+	}
+
+	group -= 1;
+	this->observations[group] = observations;
+}
+
 void Boxplot::set_quantiles(double q0, double q25, double q5, double q75, double q1) {
 	quantiles[0] = q0;
 	quantiles[1] = q25;
@@ -198,6 +198,13 @@ int Histogram::get_nclass() {
 	return nclass;
 }
 
+/* counts of a histogram created from a sample are scaled to the number of all values; densities do not change */
+void Histogram::scale_counts(double factor) {
+	for (int j = 0; j < nclass; j++) {
+		counts[j] = (int)floor(counts[j] * factor + 0.5);
+	}
+}
+
 void Histogram::set_title(const char* title) throw (PlotException) {
 	if (title == NULL) {
 		throw PlotException("Histogram", "set_title( const char* )", __LINE__, 0, "title");
@@ -48,24 +48,33 @@ Qqplot::~Qqplot() {
 }
 
 Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data, double lambda, int data_size) throw (PlotException) {
+	return create(name, color, sorted_data, NULL, lambda, data_size, data_size);
+}
+
+/* ranks (starting from 1) of the sorted values in the data of the given size; NULL if all values are present */
+Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data, double* ranks, double lambda, int sample_size, int data_size) throw (PlotException) {
 	if (name == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 0, "name");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 0, "name");
 	}
 
 	if (strlen(name) <= 0) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 1, "name");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 1, "name");
 	}
 
 	if (color == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 0, "color");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 0, "color");
 	}
 
 	if (strlen(color) <= 0) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 1, "color");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 1, "color");
 	}
 
 	if (data_size < 0) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 1, "data_size");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 1, "data_size");
+	}
+
+	if ((sample_size < 0) || (sample_size > data_size) || ((sample_size == 0) && (data_size > 0)) || ((ranks == NULL) && (sample_size != data_size))) {
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 1, "sample_size");
 	}
 
 	Qqplot* qqplot = new Qqplot();
@@ -73,21 +82,21 @@ Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data,
 
 	if (data_size > 0) {
 		if (sorted_data == NULL) {
-			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 0, "sorted_data");
+			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 0, "sorted_data");
 		}
 
 		int i = 0, j = 0;
 
 		double x_delta = (-log10(1 / (double)data_size)) / 500;
-		double y_delta = (-log10(sorted_data[0]) + log10(sorted_data[data_size - 1])) / 500;
+		double y_delta = (-log10(sorted_data[0]) + log10(sorted_data[sample_size - 1])) / 500;
 
 		double x_previous_value = numeric_limits<double>::infinity();
 		double y_previous_value = numeric_limits<double>::infinity();
 
 		double x_value = 0.0, y_value = 0.0;
 
-		while (i < data_size) {
-			x_value = -log10((i + 1) / (double)data_size);
+		while (i < sample_size) {
+			x_value = -log10((ranks != NULL ? ranks[i] : i + 1) / (double)data_size);
 			y_value = -log10(sorted_data[i]);
 
 			if ((x_value < x_previous_value - x_delta) || (y_value < y_previous_value - y_delta)) {
@@ -100,11 +109,11 @@ Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data,
 		}
 
 		if ((qqplot->x = (double*)malloc(new_data_size * sizeof(double))) == NULL) {
-			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, new_data_size * sizeof(double));
+			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, new_data_size * sizeof(double));
 		}
 
 		if ((qqplot->y = (double*)malloc(new_data_size * sizeof(double))) == NULL) {
-			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, new_data_size * sizeof(double));
+			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, new_data_size * sizeof(double));
 		}
 
 		x_previous_value = numeric_limits<double>::infinity();
@@ -113,8 +122,8 @@ Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data,
 		y_value = 0.0;
 		i = 0;
 
-		while (i < data_size) {
-			x_value = -log10((i + 1) / (double)data_size);
+		while (i < sample_size) {
+			x_value = -log10((ranks != NULL ? ranks[i] : i + 1) / (double)data_size);
 			y_value = -log10(sorted_data[i]);
 
 			if ((x_value < x_previous_value - x_delta) || (y_value < y_previous_value - y_delta)) {
@@ -130,32 +139,32 @@ Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data,
 	}
 
 	if ((qqplot->size = (int*)malloc(sizeof(int))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(int));
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, sizeof(int));
 	}
 
 	if ((qqplot->points = (int*)malloc(sizeof(int))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(int));
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, sizeof(int));
 	}
 
 	if ((qqplot->names = (char**)malloc(sizeof(char*))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(char*));
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, sizeof(char*));
 	}
 
 	if ((qqplot->colors = (char**)malloc(sizeof(char*))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(char*));
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, sizeof(char*));
 	}
 
 	if ((qqplot->lambdas = (double*)malloc(sizeof(double))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(double));
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, sizeof(double));
 	}
 
 	if ((qqplot->names[0] = (char*)malloc((strlen(name) + 1) * sizeof(char))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
 	}
 	strcpy(qqplot->names[0], name);
 
 	if ((qqplot->colors[0] = (char*)malloc((strlen(color) + 1) * sizeof(char))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, (strlen(color) + 1) * sizeof(char));
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double*, double, int, int )", __LINE__, 2, (strlen(color) + 1) * sizeof(char));
 	}
 	strcpy(qqplot->colors[0], color);
 
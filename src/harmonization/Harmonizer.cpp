@@ -252,6 +252,7 @@ void Harmonizer::process_map_file_data() throw (HarmonizerException) {
 
 	char* token = NULL;
 	char** tokens = NULL;
+	vector<char*> fields;
 
 	if ((map_file == NULL) || (map_reader == NULL)) {
 		return;
@@ -282,14 +283,8 @@ void Harmonizer::process_map_file_data() throw (HarmonizerException) {
 		while ((line_length = map_reader->read_line()) > 0) {
 			++map_file_line_number;
 			line = *(map_reader->line);
-			column_number = 0;
-
-			while ((token = auxiliary::strtok(&line, VCF_FIELD_SEPARATOR)) != NULL) {
-				if (column_number < VCF_MANDATORY_COLUMNS_SIZE) {
-					tokens[column_number] = token;
-				}
-				++column_number;
-			}
+			column_number = auxiliary::split(line, VCF_FIELD_SEPARATOR, fields, VCF_MANDATORY_COLUMNS_SIZE);
+			copy(fields.begin(), fields.end(), tokens);
 
 			if (column_number < map_file_column_number) {
 				throw HarmonizerException("Harmonizer", "process_map_file_data()", __LINE__, 14, map_file_line_number, map_file, column_number, map_file_column_number);
@@ -663,7 +658,7 @@ void Harmonizer::harmonize_without_alleles(const char* output_file_name, bool gz
 			throw HarmonizerException("Harmonizer", "harmonize_without_alleles( const char*, bool )", __LINE__, 2, 16777216 * sizeof(char));
 		}
 
-		writer = WriterFactory::create(gzip ? WriterFactory::GZIP : WriterFactory::TEXT);
+		writer = WriterFactory::create_async(gzip ? WriterFactory::BGZF : WriterFactory::TEXT);
 		writer->set_file_name(output_file_name);
 		writer->open();
 
@@ -746,27 +741,37 @@ void Harmonizer::harmonize_without_alleles(const char* output_file_name, bool gz
 			if (id_column_pos == 0) {
 				if (found_map != NULL) {
 					if (found_map->type == 'S') {
-						writer->write("%s:%u:%s", found_map->chromosome, found_map->position, VCF_SNP_TYPE);
+						writer->put_str(found_map->chromosome);
+						writer->put_char(':');
+						writer->put_uint(found_map->position);
+						writer->put_char(':');
+						writer->put_str(VCF_SNP_TYPE);
 
 						if ((variant_type != '\0') && (variant_type != 'S')) {
 							log_writer->write("Line %u: Variant type of variant %s doesn't match the variant type in the map file.\n", line_number, tokens[0]);
 						}
 					} else if (found_map->type == 'I') {
-						writer->write("%s:%u:%s", found_map->chromosome, found_map->position, VCF_INDEL_TYPE_01);
+						writer->put_str(found_map->chromosome);
+						writer->put_char(':');
+						writer->put_uint(found_map->position);
+						writer->put_char(':');
+						writer->put_str(VCF_INDEL_TYPE_01);
 
 						if ((variant_type != '\0') && (variant_type != 'I')) {
 							log_writer->write("Line %u: Variant type of variant %s doesn't match the variant type in the map file.\n", line_number, tokens[0]);
 						}
 					} else {
-						writer->write("%s:%u:%s", found_map->chromosome, found_map->position);
+						writer->put_str(found_map->chromosome);
+						writer->put_char(':');
+						writer->put_uint(found_map->position);
 						log_writer->write("Line %u: Variant type of variant %s was not found in the map file.", line_number, tokens[0]);
 					}
 				} else {
-					writer->write("%s", tokens[0]);
+					writer->put_str(tokens[0]);
 					log_writer->write("Line %u: Variant %s was not found in the map file.\n", line_number, tokens[0]);
 				}
 			} else {
-				writer->write("%s", tokens[0]);
+				writer->put_str(tokens[0]);
 			}
 
 			column_number = 1;
@@ -774,32 +779,47 @@ void Harmonizer::harmonize_without_alleles(const char* output_file_name, bool gz
 				if (column_number == id_column_pos) {
 					if (found_map != NULL) {
 						if (found_map->type == 'S') {
-							writer->write("\t%s:%u:%s", found_map->chromosome, found_map->position, VCF_SNP_TYPE);
+							writer->put_char('\t');
+							writer->put_str(found_map->chromosome);
+							writer->put_char(':');
+							writer->put_uint(found_map->position);
+							writer->put_char(':');
+							writer->put_str(VCF_SNP_TYPE);
 
 							if ((variant_type != '\0') && (variant_type != 'S')) {
 								log_writer->write("Line %u: Variant type of variant %s doesn't match the variant type in the map file.\n", line_number, tokens[column_number]);
 							}
 						} else if (found_map->type == 'I') {
-							writer->write("\t%s:%u:%s", found_map->chromosome, found_map->position, VCF_INDEL_TYPE_01);
+							writer->put_char('\t');
+							writer->put_str(found_map->chromosome);
+							writer->put_char(':');
+							writer->put_uint(found_map->position);
+							writer->put_char(':');
+							writer->put_str(VCF_INDEL_TYPE_01);
 
 							if ((variant_type != '\0') && (variant_type != 'I')) {
 								log_writer->write("Line %u: Variant type of variant %s doesn't match the variant type in the map file.\n", line_number, tokens[column_number]);
 							}
 						} else {
-							writer->write("\t%s:%u:%s", found_map->chromosome, found_map->position);
+							writer->put_char('\t');
+							writer->put_str(found_map->chromosome);
+							writer->put_char(':');
+							writer->put_uint(found_map->position);
 							log_writer->write("Line %u: Variant type of variant %s was not found in the map file.", line_number, tokens[column_number]);
 						}
 					} else {
-						writer->write("\t%s", tokens[column_number]);
+						writer->put_char('\t');
+						writer->put_str(tokens[column_number]);
 						log_writer->write("Line %u: Variant %s was not found in the map file.\n", line_number, tokens[column_number]);
 					}
 				} else {
-					writer->write("\t%s", tokens[column_number]);
+					writer->put_char('\t');
+					writer->put_str(tokens[column_number]);
 				}
 				++column_number;
 			}
 
-			writer->write("\n");
+			writer->put_char('\n');
 			/* END: output new columns. */
 
 			++line_number;
@@ -903,7 +923,7 @@ void Harmonizer::harmonize_with_alleles(const char* output_file_name, bool drop,
 			throw HarmonizerException("Harmonizer", "harmonize_with_alleles( const char*, bool )", __LINE__, 2, 16777216 * sizeof(char));
 		}
 
-		writer = WriterFactory::create(gzip ? WriterFactory::GZIP : WriterFactory::TEXT);
+		writer = WriterFactory::create_async(gzip ? WriterFactory::BGZF : WriterFactory::TEXT);
 		writer->set_file_name(output_file_name);
 		writer->open();
 
@@ -1107,24 +1127,26 @@ void Harmonizer::harmonize_with_alleles(const char* output_file_name, bool drop,
 			/* BEGIN: output new columns. */
 			if (drop) {
 				if (!unresolved) {
-					writer->write("%s", tokens[0]);
+					writer->put_str(tokens[0]);
 					column_number = 1;
 					while (column_number < file_column_number) {
-						writer->write("\t%s", tokens[column_number]);
+						writer->put_char('\t');
+						writer->put_str(tokens[column_number]);
 						++column_number;
 					}
-					writer->write("\n");
+					writer->put_char('\n');
 
 					unresolved = true;
 				}
 			} else {
-				writer->write("%s", tokens[0]);
+				writer->put_str(tokens[0]);
 				column_number = 1;
 				while (column_number < file_column_number) {
-					writer->write("\t%s", tokens[column_number]);
+					writer->put_char('\t');
+					writer->put_str(tokens[column_number]);
 					++column_number;
 				}
-				writer->write("\n");
+				writer->put_char('\n');
 			}
 			/* END: output new columns. */
 
@@ -21,6 +21,7 @@
 #define HARMONIZER_H_
 
 #include <cstdio>
+#include <algorithm>
 
 #include "HarmonizerException.h"
 #include "../../reader/include/ReaderFactory.h"
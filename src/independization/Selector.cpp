@@ -21,7 +21,7 @@
 
 const double Selector::EPSILON = 0.00000001;
 
-Selector::Selector() : gwafile(NULL), reader(NULL), /*header_backup(NULL),*/
+Selector::Selector() : gwafile(NULL), reader(NULL), line_index(NULL), indexing(false), /*header_backup(NULL),*/
 	total_columns(numeric_limits<int>::min()),
 	marker_column_pos(numeric_limits<int>::min()),
 	chr_column_pos(numeric_limits<int>::min()),
@@ -38,6 +38,11 @@ Selector::~Selector() {
 		reader = NULL;
 	}
 
+	if (line_index != NULL) {
+		delete line_index;
+		line_index = NULL;
+	}
+
 //	if (header_backup != NULL) {
 //		free(header_backup);
 //		header_backup = NULL;
@@ -70,6 +75,42 @@ Selector::~Selector() {
 	gwafile = NULL;
 }
 
+/* lines of the first pass are added to the line index, unless it was loaded */
+int Selector::read_line() throw (ReaderException) {
+	uint64_t offset = 0u;
+	int line_length = 0;
+
+	if (!indexing) {
+		return reader->read_line();
+	}
+
+	offset = reader->tell();
+	if ((line_length = reader->read_line()) >= 0) {
+		line_index->add_line(offset);
+	}
+
+	return line_length;
+}
+
+/* the index is complete once the first pass reached the end of the file; only files long enough to have more than one checkpoint get a sidecar, and read-only input directories are not an error */
+void Selector::save_line_index() {
+	if (!indexing) {
+		return;
+	}
+
+	indexing = false;
+
+	if (line_index->get_checkpoints_number() <= 1ul) {
+		return;
+	}
+
+	try {
+		line_index->save();
+		reader->save_checkpoints();
+	} catch (ReaderException &e) {
+	}
+}
+
 void Selector::open_gwafile(GwaFile* gwafile) throw (SelectorException) {
 	if (gwafile == NULL) {
 		throw SelectorException("Selector", "open_gwafile( GwaFile* )", __LINE__, 0, "gwafile");
@@ -80,12 +121,25 @@ void Selector::open_gwafile(GwaFile* gwafile) throw (SelectorException) {
 
 		this->gwafile = gwafile;
 
-		reader = ReaderFactory::create(gwafile->get_descriptor()->get_full_path());
+		reader = gwafile->create_reader();
 		reader->open();
+
+		/* the index is taken from an earlier run, or built while the markers are read */
+		if (reader->is_seekable()) {
+			line_index = new LineIndex();
+			if (!line_index->load(gwafile->get_descriptor()->get_full_path())) {
+				line_index->start(gwafile->get_descriptor()->get_full_path());
+				indexing = true;
+			}
+		}
 	} catch (DescriptorException& e) {
 		SelectorException new_e(e);
 		new_e.add_message("Selector", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
 		throw new_e;
+	} catch (GwaFileException& e) {
+		SelectorException new_e(e);
+		new_e.add_message("Selector", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
 	} catch (ReaderException& e) {
 		SelectorException new_e(e);
 		new_e.add_message("Selector", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
@@ -103,6 +157,12 @@ void Selector::close_gwafile() throw (SelectorException) {
 			delete reader;
 			reader = NULL;
 		}
+
+		if (line_index != NULL) {
+			delete line_index;
+			line_index = NULL;
+		}
+		indexing = false;
 	} catch (ReaderException &e) {
 		SelectorException new_e(e);
 		new_e.add_message("Selector", "close_gwafile()", __LINE__, 4, (gwafile != NULL) ? gwafile->get_descriptor()->get_full_path() : "NULL");
@@ -157,7 +217,7 @@ void Selector::process_header() throw (SelectorException) {
 		descriptor = gwafile->get_descriptor();
 		header_separator = gwafile->get_header_separator();
 
-		if (reader->read_line() <= 0) {
+		if (read_line() <= 0) {
 			throw SelectorException("Selector", "process_header()", __LINE__, 5, 1, gwafile->get_descriptor()->get_name());
 		}
 
@@ -174,7 +234,7 @@ void Selector::process_header() throw (SelectorException) {
 		chr_column_pos = numeric_limits<int>::min();
 		pvalue_column_pos = numeric_limits<int>::min();
 
-		token = auxiliary::strtok(&header, header_separator);
+		token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 		while (token != NULL) {
 			column_name = descriptor->get_default_column(token, gwafile->is_case_sensitive());
 			if (column_name != NULL) {
@@ -186,7 +246,7 @@ void Selector::process_header() throw (SelectorException) {
 					pvalue_column_pos = column_position;
 				}
 			}
-			token = auxiliary::strtok(&header, header_separator);
+			token = auxiliary::strtok(&header, header_separator, gwafile->is_quoted());
 			++column_position;
 		}
 
@@ -224,10 +284,11 @@ void Selector::process_data() throw (SelectorException) {
 	char data_separator = '\0';
 	const char* missing_value = NULL;
 
-	char* token = NULL;
+	vector<char*> fields;
 	char* end_ptr = NULL;
 
 	int column_position = 0;
+	int needed_columns = 0;
 
 	const char* column_name = NULL;
 
@@ -248,25 +309,12 @@ void Selector::process_data() throw (SelectorException) {
 		data_separator = gwafile->get_data_separator();
 		missing_value = descriptor->get_property(Descriptor::MISSING);
 
-		while ((line_length = reader->read_line()) > 0) {
+		needed_columns = max(max(marker_column_pos, chr_column_pos), pvalue_column_pos) + 1;
+
+		while ((line_length = read_line()) > 0) {
 			line = *(reader->line);
 
-			column_position = 0;
-			marker_token = NULL;
-			chr_token = NULL;
-			pvalue_token = NULL;
-			token = auxiliary::strtok(&line, data_separator);
-			while (token != NULL) {
-				if (column_position == marker_column_pos) {
-					marker_token = token;
-				} else if (column_position == chr_column_pos) {
-					chr_token = token;
-				} else if (column_position == pvalue_column_pos) {
-					pvalue_token = token;
-				}
-				token = auxiliary::strtok(&line, data_separator);
-				++column_position;
-			}
+			column_position = auxiliary::split(line, data_separator, fields, needed_columns, gwafile->is_quoted());
 
 			if (column_position < total_columns) {
 				throw SelectorException("Selector", "process_data()", __LINE__, 8, line_number, descriptor->get_name(), column_position, total_columns);
@@ -274,12 +322,16 @@ void Selector::process_data() throw (SelectorException) {
 				throw SelectorException("Selector", "process_data()", __LINE__, 9, line_number, descriptor->get_name(), column_position, total_columns);
 			}
 
+			marker_token = fields[marker_column_pos];
+			chr_token = fields[chr_column_pos];
+			pvalue_token = fields[pvalue_column_pos];
+
 			if (strcmp(missing_value, pvalue_token) == 0) {
 				++line_number;
 				continue;
 			}
 
-			pvalue = strtod(pvalue_token, &end_ptr);
+			pvalue = auxiliary::fast_strtod(pvalue_token, &end_ptr);
 			if (*end_ptr != '\0') {
 				throw SelectorException("Selector", "process_data()",  __LINE__, 10, pvalue_token, ((column_name = descriptor->get_column(Descriptor::PVALUE)) != NULL) ? column_name : Descriptor::PVALUE, line_number);
 			}
@@ -291,7 +343,7 @@ void Selector::process_data() throw (SelectorException) {
 
 			markers_by_chr_it = markers_by_chr.find(chr_token);
 			if (markers_by_chr_it == markers_by_chr.end()) {
-				markers = new map<const char*, double, bool(*)(const char*, const char*)>(auxiliary::bool_strcmp);
+				markers = new map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>(auxiliary::bool_strcmp);
 
 				chr = (char*)malloc((strlen(chr_token) + 1u) * sizeof(char));
 				if (chr == NULL) {
@@ -299,7 +351,7 @@ void Selector::process_data() throw (SelectorException) {
 				}
 				strcpy(chr, chr_token);
 
-				markers_by_chr.insert(pair<char*, map<const char*, double, bool(*)(const char*, const char*)>*>(chr, markers));
+				markers_by_chr.insert(pair<char*, map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>*>(chr, markers));
 			} else {
 				markers = markers_by_chr_it->second;
 			}
@@ -314,7 +366,7 @@ void Selector::process_data() throw (SelectorException) {
 
 				all_marker_names.push_back(marker);
 
-				markers->insert(pair<char*, double>(marker, pvalue));
+				markers->insert(pair<char*, pair<double, unsigned int> >(marker, pair<double, unsigned int>(pvalue, line_number)));
 			} else {
 				/* trhow error about duplicates */
 				throw SelectorException("Selector", "process_data()",  __LINE__);
@@ -326,6 +378,8 @@ void Selector::process_data() throw (SelectorException) {
 		if (line_length == 0) {
 			throw SelectorException("Selector", "process_data()", __LINE__, 11, line_number, descriptor->get_name());
 		}
+
+		save_line_index();
 	} catch (DescriptorException &e) {
 		SelectorException new_e(e);
 		new_e.add_message("Selector", "process_data()", __LINE__, 12, gwafile->get_descriptor()->get_name());
@@ -488,10 +542,11 @@ void Selector::process_ld_data() throw (SelectorException) {
 
 	char data_separator = '\0';
 
-	char* token = NULL;
+	vector<char*> fields;
 	char* end_ptr = NULL;
 
 	int column_position = 0;
+	int needed_columns = 0;
 
 	const char* column_name = NULL;
 
@@ -521,31 +576,22 @@ void Selector::process_ld_data() throw (SelectorException) {
 			line_number = 2u;
 		}
 
+		needed_columns = max(max(ld_marker1_column_pos, ld_marker2_column_pos), ld_value_column_pos) + 1;
+
 		while ((line_length = ld_reader->read_line()) > 0) {
 			line = *(ld_reader->line);
 
-			column_position = 0;
-			ld_marker1_token = NULL;
-			ld_marker2_token = NULL;
-			ld_value_token = NULL;
-			token = auxiliary::strtok(&line, data_separator);
-			while (token != NULL) {
-				if (column_position == ld_marker1_column_pos) {
-					ld_marker1_token = token;
-				} else if (column_position == ld_marker2_column_pos) {
-					ld_marker2_token = token;
-				} else if (column_position == ld_value_column_pos) {
-					ld_value_token = token;
-				}
-				token = auxiliary::strtok(&line, data_separator);
-				++column_position;
-			}
+			column_position = auxiliary::split(line, data_separator, fields, needed_columns);
 
 			if (column_position < ld_total_columns) {
 				throw SelectorException("Selector", "process_ld_data()", __LINE__, 8, line_number, ld_file_path, column_position, ld_total_columns);
 			}
 
-			ld_value = strtod(ld_value_token, &end_ptr);
+			ld_marker1_token = fields[ld_marker1_column_pos];
+			ld_marker2_token = fields[ld_marker2_column_pos];
+			ld_value_token = fields[ld_value_column_pos];
+
+			ld_value = auxiliary::fast_strtod(ld_value_token, &end_ptr);
 			if (*end_ptr != '\0') {
 				throw SelectorException("Selector", "process_ld_data()",  __LINE__, 10, ld_value_token, ((column_name = descriptor->get_column(Descriptor::LD_VALUE)) != NULL) ? column_name : Descriptor::LD_VALUE, line_number);
 			}
@@ -630,10 +676,10 @@ void Selector::drop_correlated_markers() throw (SelectorException) {
 	const char* ld_file_name = NULL;
 	const char* ld_file_path = NULL;
 
-	map<const char*, double, bool(*)(const char*, const char*)>* independent_markers = NULL;
-	map<const char*, double, bool(*)(const char*, const char*)>::iterator independent_markers_it;
+	map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>* independent_markers = NULL;
+	map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>::iterator independent_markers_it;
 
-	map<const char*, double, bool(*)(const char*, const char*)>::iterator min_pvalue_it;
+	map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>::iterator min_pvalue_it;
 
 	vector<const char*>* marker_neighbours = NULL;
 	vector<const char*>::iterator marker_neighbours_it;
@@ -662,18 +708,18 @@ void Selector::drop_correlated_markers() throw (SelectorException) {
 
 				index_ld(ld_file_path);
 
-				independent_markers = new map<const char*, double, bool(*)(const char*, const char*)>(auxiliary::bool_strcmp);
+				independent_markers = new map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>(auxiliary::bool_strcmp);
 
 				while (markers->size() > 0) {
 					markers_it = markers->begin();
 					min_pvalue_it = markers_it;
 					while (++markers_it != markers->end()) {
-						if (auxiliary::fcmp(markers_it->second, min_pvalue_it->second, EPSILON) < 0) {
+						if (auxiliary::fcmp(markers_it->second.first, min_pvalue_it->second.first, EPSILON) < 0) {
 							min_pvalue_it = markers_it;
 						}
 					}
 
-					independent_markers->insert(pair<const char*, double>(min_pvalue_it->first, min_pvalue_it->second));
+					independent_markers->insert(pair<const char*, pair<double, unsigned int> >(min_pvalue_it->first, min_pvalue_it->second));
 
 					markers_ld_it = markers_ld.find(min_pvalue_it->first);
 
@@ -715,22 +761,29 @@ void Selector::write_remaining_markers() throw (SelectorException) {
 	const char* output_prefix = NULL;
 	const char* file_name = NULL;
 	char* output_file_name = NULL;
+	const char* compression = NULL;
 
 	char* line = NULL;
 	int line_length = 0;
 	unsigned int line_number = 2u;
 	char* line_backup = NULL;
+	char* new_line_backup = NULL;
+	int line_backup_size = 0;
 
 	char header_separator = '\0';
 	char data_separator = '\0';
 
-	char* token = NULL;
+	vector<char*> fields;
 
 	int column_position = 0;
+	int needed_columns = 0;
 
 	char* marker_token = NULL;
 	char* chr_token = NULL;
 
+	unsigned int first_line = 0u;
+	unsigned int last_line = 1u;
+
 	if (gwafile == NULL) {
 		return;
 	}
@@ -741,18 +794,24 @@ void Selector::write_remaining_markers() throw (SelectorException) {
 		file_name = descriptor->get_name();
 		header_separator = gwafile->get_header_separator();
 		data_separator = gwafile->get_data_separator();
+		compression = gwafile->get_compression();
 
-		auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, NULL, true);
+		if ((compression != NULL) && ((strlen(file_name) < 3) || (strcmp(file_name + strlen(file_name) - 3, ".gz") != 0))) {
+			auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, ".gz", true);
+		} else {
+			auxiliary::transform_file_name(&output_file_name, output_prefix, file_name, NULL, true);
+		}
 		if (output_file_name == NULL) {
 			throw SelectorException("Selector", "independize()", __LINE__/*, Selector exception: 16 */);
 		}
 
-		line_backup = (char*)malloc(reader->get_buffer_size() * sizeof(char));
+		line_backup_size = reader->get_buffer_size() + 1;
+		line_backup = (char*)malloc(line_backup_size * sizeof(char));
 		if (line_backup == NULL) {
-			throw SelectorException("Selector", "independize()", __LINE__, 2, (reader->get_buffer_size() * sizeof(char)));
+			throw SelectorException("Selector", "independize()", __LINE__, 2, (line_backup_size * sizeof(char)));
 		}
 
-		writer = WriterFactory::create(WriterFactory::TEXT);
+		writer = WriterFactory::create_async(compression != NULL ? compression : WriterFactory::TEXT);
 		writer->set_file_name(output_file_name);
 		writer->open();
 
@@ -761,39 +820,60 @@ void Selector::write_remaining_markers() throw (SelectorException) {
 		if (reader->read_line() <= 0) {
 			throw SelectorException("Selector", "independize()", __LINE__, 5, 1, gwafile->get_descriptor()->get_name());
 		} else {
-			writer->write("%s\n", *(reader->line));
+			writer->put_str(*(reader->line));
+			writer->put_char('\n');
 		}
 
-		while ((line_length = reader->read_line()) > 0) {
-			line = *(reader->line);
+		/* only the lines from the first to the last remaining marker are read again */
+		for (markers_by_chr_it = markers_by_chr.begin(); markers_by_chr_it != markers_by_chr.end(); markers_by_chr_it++) {
+			for (markers_it = markers_by_chr_it->second->begin(); markers_it != markers_by_chr_it->second->end(); markers_it++) {
+				if ((first_line == 0u) || (markers_it->second.second < first_line)) {
+					first_line = markers_it->second.second;
+				}
+				if (markers_it->second.second > last_line) {
+					last_line = markers_it->second.second;
+				}
+			}
+		}
 
-			strcpy(line_backup, line);
+		if ((line_index != NULL) && !indexing && (first_line > line_number)) {
+			line_index->seek_line(reader, first_line - 1u);
+			line_number = first_line;
+		}
+
+		needed_columns = max(marker_column_pos, chr_column_pos) + 1;
 
-			column_position = 0;
-			marker_token = NULL;
-			chr_token = NULL;
-			token = auxiliary::strtok(&line, data_separator);
-			while (token != NULL) {
-				if (column_position == marker_column_pos) {
-					marker_token = token;
-				} else if (column_position == chr_column_pos) {
-					chr_token = token;
+		while ((line_number <= last_line) && ((line_length = reader->read_line()) > 0)) {
+			line = *(reader->line);
+
+			if (line_length >= line_backup_size) {
+				line_backup_size = reader->get_buffer_size() + 1;
+				new_line_backup = (char*)realloc(line_backup, line_backup_size * sizeof(char));
+				if (new_line_backup == NULL) {
+					throw SelectorException("Selector", "independize()", __LINE__, 2, (line_backup_size * sizeof(char)));
 				}
-				token = auxiliary::strtok(&line, data_separator);
-				++column_position;
+				line_backup = new_line_backup;
 			}
 
+			strcpy(line_backup, line);
+
+			column_position = auxiliary::split(line, data_separator, fields, needed_columns, gwafile->is_quoted());
+
 			if (column_position < total_columns) {
 				throw SelectorException("Selector", "process_data()", __LINE__, 8, line_number, descriptor->get_name(), column_position, total_columns);
 			} else if (column_position > total_columns) {
 				throw SelectorException("Selector", "process_data()", __LINE__, 9, line_number, descriptor->get_name(), column_position, total_columns);
 			}
 
+			marker_token = fields[marker_column_pos];
+			chr_token = fields[chr_column_pos];
+
 			markers_by_chr_it = markers_by_chr.find(chr_token);
 			if (markers_by_chr_it != markers_by_chr.end()) {
 				markers = markers_by_chr_it->second;
 				if (markers->count(marker_token) > 0) {
-					writer->write("%s\n", line_backup);
+					writer->put_str(line_backup);
+					writer->put_char('\n');
 				}
 			}
 
@@ -810,7 +890,7 @@ void Selector::write_remaining_markers() throw (SelectorException) {
 		delete writer;
 		writer = NULL;
 
-		if (line_length == 0) {
+		if ((line_length == 0) && (line_number <= last_line)) {
 			throw SelectorException("Selector", "independize()", __LINE__, 11, line_number, descriptor->get_name());
 		}
 	} catch (DescriptorException &e) {
@@ -26,6 +26,7 @@
 
 #include "SelectorException.h"
 #include "../../gwafile/include/GwaFile.h"
+#include "../../reader/include/LineIndex.h"
 #include "../../writer/include/WriterFactory.h"
 
 #include <R.h>
@@ -38,6 +39,9 @@ private:
 
 	Reader* reader;
 
+	LineIndex* line_index;
+	bool indexing;
+
 	Reader* ld_reader;
 	const char* ld_file_path;
 
@@ -56,14 +60,17 @@ private:
 	vector<char*> all_marker_names;
 	vector<char*>::iterator all_marker_names_it;
 
-	map<char*, map<const char*, double, bool(*)(const char*, const char*)>*, bool(*)(const char*, const char*)> markers_by_chr;
-	map<char*, map<const char*, double, bool(*)(const char*, const char*)>*, bool(*)(const char*, const char*)>::iterator markers_by_chr_it;
-	map<const char*, double, bool(*)(const char*, const char*)>* markers;
-	map<const char*, double, bool(*)(const char*, const char*)>::iterator markers_it;
+	map<char*, map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>*, bool(*)(const char*, const char*)> markers_by_chr;
+	map<char*, map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>*, bool(*)(const char*, const char*)>::iterator markers_by_chr_it;
+	map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>* markers;
+	map<const char*, pair<double, unsigned int>, bool(*)(const char*, const char*)>::iterator markers_it;
 
 	map<const char*, vector<const char*>*> markers_ld;
 	map<const char*, vector<const char*>*>::iterator markers_ld_it;
 
+	int read_line() throw (ReaderException);
+	void save_line_index();
+
 	void open_ld_file(const char* file_path) throw (SelectorException);
 	void close_ld_file() throw (SelectorException);
 	void process_ld_header() throw (SelectorException);
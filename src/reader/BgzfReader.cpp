@@ -0,0 +1,456 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/BgzfReader.h"
+
+#ifndef WIN32
+
+const unsigned int BgzfReader::DEFAULT_BUFFER_SIZE = 65536;
+const unsigned int BgzfReader::MAX_BLOCK_SIZE = 65536;
+const unsigned int BgzfReader::SLOTS_PER_THREAD = 4;
+const unsigned int BgzfReader::MAX_THREADS_NUMBER = 16;
+
+BgzfReader::BgzfReader(unsigned int buffer_size, unsigned int threads_number) throw (ReaderException) : BlockReader(buffer_size),
+	opened(false), input_end(false), threads_number(threads_number), threads(NULL), running_threads_number(0u), threads_stop(false),
+	slots_number(0u), slots(NULL), loaded(0ul), claimed(0ul), inflated(0ul), consumed(0ul) {
+
+	if (this->threads_number == 0u) {
+		this->threads_number = get_default_threads_number();
+	}
+
+	slots_number = this->threads_number * SLOTS_PER_THREAD;
+
+	threads = (pthread_t*)malloc(this->threads_number * sizeof(pthread_t));
+	if (threads == NULL) {
+		throw ReaderException("BgzfReader", "BgzfReader( unsigned int, unsigned int )", __LINE__, 2, this->threads_number * sizeof(pthread_t));
+	}
+
+	slots = (bgzf_block*)malloc(slots_number * sizeof(bgzf_block));
+	if (slots == NULL) {
+		throw ReaderException("BgzfReader", "BgzfReader( unsigned int, unsigned int )", __LINE__, 2, slots_number * sizeof(bgzf_block));
+	}
+
+	for (unsigned int i = 0u; i < slots_number; ++i) {
+		slots[i].compressed = (char*)malloc(MAX_BLOCK_SIZE * sizeof(char));
+		slots[i].uncompressed = (char*)malloc(MAX_BLOCK_SIZE * sizeof(char));
+		if ((slots[i].compressed == NULL) || (slots[i].uncompressed == NULL)) {
+			throw ReaderException("BgzfReader", "BgzfReader( unsigned int, unsigned int )", __LINE__, 2, MAX_BLOCK_SIZE * sizeof(char));
+		}
+		slots[i].compressed_length = 0u;
+		slots[i].data_offset = 0u;
+		slots[i].uncompressed_length = 0u;
+		slots[i].offset = 0u;
+		slots[i].inflated = false;
+		slots[i].failed = false;
+	}
+
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&blocks_loaded, NULL);
+	pthread_cond_init(&blocks_inflated, NULL);
+}
+
+BgzfReader::~BgzfReader() {
+	clear_block();
+	stop_threads();
+
+	if (ifile_stream.is_open()) {
+		ifile_stream.close();
+	}
+	opened = false;
+
+	pthread_cond_destroy(&blocks_inflated);
+	pthread_cond_destroy(&blocks_loaded);
+	pthread_mutex_destroy(&mutex);
+
+	if (slots != NULL) {
+		for (unsigned int i = 0u; i < slots_number; ++i) {
+			free(slots[i].compressed);
+			free(slots[i].uncompressed);
+		}
+		free(slots);
+		slots = NULL;
+	}
+
+	free(threads);
+	threads = NULL;
+}
+
+unsigned int BgzfReader::get_default_threads_number() {
+	long int processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (processors < 1) {
+		return 1u;
+	}
+
+	if ((unsigned long int)processors > MAX_THREADS_NUMBER) {
+		return MAX_THREADS_NUMBER;
+	}
+
+	return (unsigned int)processors;
+}
+
+bool BgzfReader::is_bgzf_header(const unsigned char* header, unsigned int length) {
+	if (length < 18u) {
+		return false;
+	}
+
+	return (header[0] == 0x1F) && (header[1] == 0x8B) && (header[2] == 0x08) && ((header[3] & 0x04) != 0) &&
+			((header[10] | (header[11] << 8)) >= 6) &&
+			(header[12] == 'B') && (header[13] == 'C') && (header[14] == 2) && (header[15] == 0);
+}
+
+void BgzfReader::start_threads() throw (ReaderException) {
+	threads_stop = false;
+	running_threads_number = 0u;
+
+	while (running_threads_number < threads_number) {
+		if (pthread_create(&threads[running_threads_number], NULL, inflate_blocks, this) != 0) {
+			stop_threads();
+			throw ReaderException("BgzfReader", "start_threads()", __LINE__, 10, file_name);
+		}
+		running_threads_number += 1u;
+	}
+}
+
+void BgzfReader::stop_threads() {
+	pthread_mutex_lock(&mutex);
+	threads_stop = true;
+	pthread_cond_broadcast(&blocks_loaded);
+	pthread_mutex_unlock(&mutex);
+
+	for (unsigned int i = 0u; i < running_threads_number; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+	running_threads_number = 0u;
+}
+
+void BgzfReader::drain_threads() {
+	pthread_mutex_lock(&mutex);
+	loaded = claimed;
+	while (inflated < claimed) {
+		pthread_cond_wait(&blocks_inflated, &mutex);
+	}
+	loaded = 0ul;
+	claimed = 0ul;
+	inflated = 0ul;
+	consumed = 0ul;
+	pthread_mutex_unlock(&mutex);
+
+	input_end = false;
+}
+
+bool BgzfReader::load_block(bgzf_block* slot) throw (ReaderException) {
+	unsigned char* header = (unsigned char*)slot->compressed;
+	unsigned int extra_length = 0u;
+	unsigned int extra_position = 0u;
+	unsigned int subfield_length = 0u;
+	unsigned int block_length = 0u;
+
+	slot->compressed_length = 0u;
+	slot->data_offset = 0u;
+	slot->uncompressed_length = 0u;
+	slot->offset = 0u;
+	slot->inflated = false;
+	slot->failed = false;
+
+	ifile_stream.read(slot->compressed, 12);
+	if (ifile_stream.gcount() == 0) {
+		if (ifile_stream.eof()) {
+			return false;
+		}
+		throw ReaderException("BgzfReader", "load_block( bgzf_block* )", __LINE__, 4, file_name);
+	}
+
+	if ((ifile_stream.gcount() < 12) || (header[0] != 0x1F) || (header[1] != 0x8B) || (header[2] != 0x08) || ((header[3] & 0x04) == 0)) {
+		throw ReaderException("BgzfReader", "load_block( bgzf_block* )", __LINE__, 4, file_name);
+	}
+
+	extra_length = header[10] | (header[11] << 8);
+	if (12u + extra_length + 8u > MAX_BLOCK_SIZE) {
+		throw ReaderException("BgzfReader", "load_block( bgzf_block* )", __LINE__, 4, file_name);
+	}
+
+	ifile_stream.read(slot->compressed + 12, extra_length);
+	if ((unsigned int)ifile_stream.gcount() < extra_length) {
+		throw ReaderException("BgzfReader", "load_block( bgzf_block* )", __LINE__, 4, file_name);
+	}
+
+	extra_position = 12u;
+	while (extra_position + 4u <= 12u + extra_length) {
+		subfield_length = header[extra_position + 2] | (header[extra_position + 3] << 8);
+		if ((header[extra_position] == 'B') && (header[extra_position + 1] == 'C') && (subfield_length == 2u)) {
+			block_length = (header[extra_position + 4] | (header[extra_position + 5] << 8)) + 1u;
+			break;
+		}
+		extra_position += 4u + subfield_length;
+	}
+
+	if ((block_length < 12u + extra_length + 8u) || (block_length > MAX_BLOCK_SIZE)) {
+		throw ReaderException("BgzfReader", "load_block( bgzf_block* )", __LINE__, 4, file_name);
+	}
+
+	ifile_stream.read(slot->compressed + 12 + extra_length, block_length - 12u - extra_length);
+	if ((unsigned int)ifile_stream.gcount() < block_length - 12u - extra_length) {
+		throw ReaderException("BgzfReader", "load_block( bgzf_block* )", __LINE__, 4, file_name);
+	}
+
+	slot->compressed_length = block_length;
+	slot->data_offset = 12u + extra_length;
+
+	return true;
+}
+
+bool BgzfReader::inflate_block(z_stream* stream, bgzf_block* slot) {
+	unsigned char* trailer = (unsigned char*)slot->compressed + slot->compressed_length - 8u;
+	unsigned long int crc = 0ul;
+	unsigned long int size = 0ul;
+
+	crc = (unsigned long int)trailer[0] | ((unsigned long int)trailer[1] << 8) | ((unsigned long int)trailer[2] << 16) | ((unsigned long int)trailer[3] << 24);
+	size = (unsigned long int)trailer[4] | ((unsigned long int)trailer[5] << 8) | ((unsigned long int)trailer[6] << 16) | ((unsigned long int)trailer[7] << 24);
+
+	if (size > MAX_BLOCK_SIZE) {
+		return false;
+	}
+
+	if (inflateReset(stream) != Z_OK) {
+		return false;
+	}
+
+	stream->next_in = (Bytef*)(slot->compressed + slot->data_offset);
+	stream->avail_in = slot->compressed_length - slot->data_offset - 8u;
+	stream->next_out = (Bytef*)slot->uncompressed;
+	stream->avail_out = MAX_BLOCK_SIZE;
+
+	if (inflate(stream, Z_FINISH) != Z_STREAM_END) {
+		return false;
+	}
+
+	if (stream->total_out != size) {
+		return false;
+	}
+
+	if (crc32(crc32(0L, Z_NULL, 0), (Bytef*)slot->uncompressed, size) != crc) {
+		return false;
+	}
+
+	slot->uncompressed_length = size;
+
+	return true;
+}
+
+void* BgzfReader::inflate_blocks(void* reader) {
+	BgzfReader* bgzf_reader = (BgzfReader*)reader;
+	bgzf_block* slot = NULL;
+	z_stream stream;
+	bool stream_ready = false;
+	bool success = false;
+
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	stream.next_in = Z_NULL;
+	stream.avail_in = 0;
+	stream_ready = (inflateInit2(&stream, -MAX_WBITS) == Z_OK);
+
+	pthread_mutex_lock(&bgzf_reader->mutex);
+	while (true) {
+		while (!bgzf_reader->threads_stop && (bgzf_reader->claimed >= bgzf_reader->loaded)) {
+			pthread_cond_wait(&bgzf_reader->blocks_loaded, &bgzf_reader->mutex);
+		}
+
+		if (bgzf_reader->threads_stop) {
+			break;
+		}
+
+		slot = &bgzf_reader->slots[bgzf_reader->claimed % bgzf_reader->slots_number];
+		bgzf_reader->claimed += 1ul;
+		pthread_mutex_unlock(&bgzf_reader->mutex);
+
+		success = stream_ready && inflate_block(&stream, slot);
+
+		pthread_mutex_lock(&bgzf_reader->mutex);
+		slot->failed = !success;
+		slot->inflated = true;
+		bgzf_reader->inflated += 1ul;
+		pthread_cond_broadcast(&bgzf_reader->blocks_inflated);
+	}
+	pthread_mutex_unlock(&bgzf_reader->mutex);
+
+	if (stream_ready) {
+		inflateEnd(&stream);
+	}
+
+	return NULL;
+}
+
+unsigned int BgzfReader::read_block(char* destination, unsigned int size) throw (ReaderException) {
+	bgzf_block* slot = NULL;
+	unsigned int copied = 0u;
+	unsigned int length = 0u;
+
+	while (copied < size) {
+		while (!input_end && (loaded - consumed < slots_number)) {
+			slot = &slots[loaded % slots_number];
+			if (!load_block(slot)) {
+				input_end = true;
+				break;
+			}
+
+			pthread_mutex_lock(&mutex);
+			loaded += 1ul;
+			pthread_cond_signal(&blocks_loaded);
+			pthread_mutex_unlock(&mutex);
+		}
+
+		if (consumed >= loaded) {
+			break;
+		}
+
+		slot = &slots[consumed % slots_number];
+
+		pthread_mutex_lock(&mutex);
+		while (!slot->inflated) {
+			pthread_cond_wait(&blocks_inflated, &mutex);
+		}
+		pthread_mutex_unlock(&mutex);
+
+		if (slot->failed) {
+			throw ReaderException("BgzfReader", "unsigned int read_block( char*, unsigned int )", __LINE__, 4, file_name);
+		}
+
+		length = slot->uncompressed_length - slot->offset;
+		if (length > size - copied) {
+			length = size - copied;
+		}
+
+		memcpy(destination + copied, slot->uncompressed + slot->offset, length);
+		slot->offset += length;
+		copied += length;
+
+		if (slot->offset >= slot->uncompressed_length) {
+			consumed += 1ul;
+		}
+	}
+
+	return copied;
+}
+
+void BgzfReader::open() throw (ReaderException) {
+	close();
+
+	ifile_stream.clear();
+	ifile_stream.open(file_name, ios::binary);
+	if (ifile_stream.fail()) {
+		throw ReaderException("BgzfReader", "open()", __LINE__, 3, file_name);
+	}
+
+	loaded = 0ul;
+	claimed = 0ul;
+	inflated = 0ul;
+	consumed = 0ul;
+	input_end = false;
+
+	start_threads();
+
+	opened = true;
+}
+
+void BgzfReader::close() throw (ReaderException) {
+	clear_block();
+
+	if (opened) {
+		stop_threads();
+
+		ifile_stream.clear();
+		ifile_stream.close();
+		if (ifile_stream.fail()) {
+			throw ReaderException("BgzfReader", "close()", __LINE__, 5, file_name);
+		}
+
+		opened = false;
+	}
+}
+
+void BgzfReader::reset() throw (ReaderException) {
+	if (opened) {
+		clear_block();
+		drain_threads();
+
+		ifile_stream.clear();
+		ifile_stream.seekg((streampos)0, ifstream::beg);
+		if (ifile_stream.fail()) {
+			throw ReaderException("BgzfReader", "reset()", __LINE__, 6, file_name);
+		}
+	}
+}
+
+void BgzfReader::seek_virtual(uint64_t offset) throw (ReaderException) {
+	char skipped[4096];
+	unsigned int within = (unsigned int)(offset & 0xffffu);
+	unsigned int length = 0u;
+
+	if (!opened) {
+		throw ReaderException("BgzfReader", "seek_virtual( uint64_t )", __LINE__, 6, file_name);
+	}
+
+	clear_block();
+	drain_threads();
+
+	ifile_stream.clear();
+	ifile_stream.seekg((streampos)(offset >> 16), ifstream::beg);
+	if (ifile_stream.fail()) {
+		throw ReaderException("BgzfReader", "seek_virtual( uint64_t )", __LINE__, 6, file_name);
+	}
+
+	while (within > 0u) {
+		length = within < sizeof(skipped) ? within : sizeof(skipped);
+		if (read_block(skipped, length) != length) {
+			throw ReaderException("BgzfReader", "seek_virtual( uint64_t )", __LINE__, 6, file_name);
+		}
+		within -= length;
+	}
+}
+
+bool BgzfReader::eof() {
+	return is_block_end();
+}
+
+bool BgzfReader::sof() {
+	return opened && is_block_start();
+}
+
+bool BgzfReader::is_open() {
+	return opened;
+}
+
+bool BgzfReader::is_compressed() {
+	return true;
+}
+
+unsigned long int BgzfReader::estimate_lines_count() throw (ReaderException) {
+	GzipReader reader(buffer_size);
+
+	close();
+
+	reader.set_file_name(file_name);
+
+	return reader.estimate_lines_count();
+}
+
+#endif
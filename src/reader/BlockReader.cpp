@@ -0,0 +1,433 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/BlockReader.h"
+
+const unsigned int BlockReader::READ_AHEAD_BUFFERS_NUMBER = 3;
+const unsigned int BlockReader::READ_AHEAD_BUFFER_SIZE = 1048576;
+
+BlockReader::BlockReader(unsigned int buffer_size) throw (ReaderException) : Reader(&buffer),
+	block_size(0u), block(NULL), block_start(NULL), block_end(NULL), next_lf(NULL), next_cr(NULL),
+	held_position(NULL), held_char('\0'), block_offset(0u), input_eof(false), read_ahead(false),
+#ifndef WIN32
+	read_ahead_buffers(NULL), read_ahead_buffers_number(READ_AHEAD_BUFFERS_NUMBER), read_ahead_produced(0ul), read_ahead_consumed(0ul), read_ahead_offset(0u),
+	read_ahead_running(false), read_ahead_stop(false), read_ahead_end(false), read_ahead_exception(NULL),
+#endif
+	buffer_size(buffer_size), buffer(NULL) {
+	if (buffer_size <= 0) {
+		throw ReaderException("BlockReader", "BlockReader( int )", __LINE__, 1, "buffer_size");
+	}
+
+	/* One extra character is needed to look past a '\r' at the buffer boundary. */
+	block_size = buffer_size + 1;
+
+	block = (char*)malloc((block_size + 1) * sizeof(char));
+	if (block == NULL) {
+		throw ReaderException("BlockReader", "BlockReader( int )", __LINE__, 2, (block_size + 1) * sizeof(char));
+	}
+
+#ifndef WIN32
+	pthread_mutex_init(&read_ahead_mutex, NULL);
+	pthread_cond_init(&read_ahead_filled, NULL);
+	pthread_cond_init(&read_ahead_drained, NULL);
+#endif
+
+	clear_block();
+}
+
+BlockReader::~BlockReader() {
+#ifndef WIN32
+	stop_read_ahead();
+	free_read_ahead_buffers();
+
+	pthread_cond_destroy(&read_ahead_drained);
+	pthread_cond_destroy(&read_ahead_filled);
+	pthread_mutex_destroy(&read_ahead_mutex);
+#endif
+
+	buffer_size = 0;
+	block_size = 0u;
+
+	free(block);
+	block = NULL;
+	buffer = NULL;
+}
+
+void BlockReader::clear_block() {
+#ifndef WIN32
+	stop_read_ahead();
+#endif
+
+	block_start = block;
+	block_end = block;
+	next_lf = NULL;
+	next_cr = NULL;
+	held_position = NULL;
+	block_offset = 0u;
+	input_eof = false;
+
+	block[0] = '\0';
+	buffer = block;
+}
+
+bool BlockReader::is_block_start() {
+	return (block_offset + (block_start - block)) == 0u;
+}
+
+bool BlockReader::is_block_end() {
+	return input_eof && (block_start >= block_end);
+}
+
+bool BlockReader::fill_block() throw (ReaderException) {
+	unsigned int available = block_end - block_start;
+	unsigned int read_size = 0u;
+
+	if ((block_start > block) && (available > 0u)) {
+		memmove(block, block_start, available);
+	}
+
+	block_offset += block_start - block;
+	block_start = block;
+	block_end = block + available;
+	next_lf = NULL;
+	next_cr = NULL;
+
+	if (input_eof) {
+		return false;
+	}
+
+#ifndef WIN32
+	if (read_ahead && !read_ahead_running) {
+		start_read_ahead();
+	}
+
+	if (read_ahead_running) {
+		read_size = take_block(block_end, block_size - available);
+	} else {
+		read_size = read_block(block_end, block_size - available);
+	}
+#else
+	read_size = read_block(block_end, block_size - available);
+#endif
+
+	if (read_size == 0u) {
+		input_eof = true;
+		return false;
+	}
+
+	block_end += read_size;
+
+	return true;
+}
+
+/* doubles the buffer, so that a long line costs a logarithmic number of refills */
+bool BlockReader::grow_block() throw (ReaderException) {
+	unsigned int new_buffer_size = 0u;
+	char* new_block = NULL;
+
+	if ((unsigned int)buffer_size >= MAX_BUFFER_SIZE) {
+		return false;
+	}
+
+	new_buffer_size = ((unsigned int)buffer_size > MAX_BUFFER_SIZE / 2u) ? MAX_BUFFER_SIZE : 2u * buffer_size;
+
+	new_block = (char*)realloc(block, (new_buffer_size + 2u) * sizeof(char));
+	if (new_block == NULL) {
+		throw ReaderException("BlockReader", "grow_block()", __LINE__, 2, (new_buffer_size + 2u) * sizeof(char));
+	}
+
+	block_start = new_block + (block_start - block);
+	block_end = new_block + (block_end - block);
+	block = new_block;
+	buffer = block_start;
+	next_lf = NULL;
+	next_cr = NULL;
+
+	buffer_size = new_buffer_size;
+	block_size = new_buffer_size + 1u;
+
+	return true;
+}
+
+int BlockReader::read_line() throw (ReaderException) {
+	char* search_end = NULL;
+	char* line_end = NULL;
+	int length = 0;
+
+	if (held_position != NULL) {
+		*held_position = held_char;
+		held_position = NULL;
+	}
+
+	while (true) {
+		search_end = ((block_end - block_start) > buffer_size) ? block_start + buffer_size : block_end;
+
+		if ((next_lf == NULL) || (next_lf < block_start)) {
+			if ((next_lf = (char*)memchr(block_start, '\n', block_end - block_start)) == NULL) {
+				next_lf = block_end;
+			}
+		}
+
+		if ((next_cr == NULL) || (next_cr < block_start)) {
+			if ((next_cr = (char*)memchr(block_start, '\r', block_end - block_start)) == NULL) {
+				next_cr = block_end;
+			}
+		}
+
+		line_end = (next_lf < next_cr) ? next_lf : next_cr;
+
+		if (line_end < search_end) {
+			if ((*line_end == '\r') && (line_end + 1 == block_end) && !input_eof) {
+				fill_block();
+				continue;
+			}
+
+			length = line_end - block_start;
+			buffer = block_start;
+			block_start = line_end + 1;
+
+			if ((*line_end == '\r') && (block_start < block_end) && (*block_start == '\n')) {
+				block_start += 1;
+			}
+
+			*line_end = '\0';
+			return length;
+		}
+
+		if ((search_end - block_start) >= buffer_size) {
+			if (grow_block()) {
+				fill_block();
+				continue;
+			}
+
+			/* Line is longer than MAX_BUFFER_SIZE: return its head and keep the rest for the next call. */
+			buffer = block_start;
+			block_start = search_end;
+
+			held_position = search_end;
+			held_char = *search_end;
+			*search_end = '\0';
+			return buffer_size;
+		}
+
+		if (input_eof) {
+			length = block_end - block_start;
+			buffer = block_start;
+			block_start = block_end;
+
+			*block_end = '\0';
+			return (length == 0 ? -1 : length);
+		}
+
+		fill_block();
+	}
+
+	return -1;
+}
+
+int BlockReader::get_buffer_size() {
+	return buffer_size;
+}
+
+/* position of the first character not yet returned by read_line() */
+uint64_t BlockReader::tell() throw (ReaderException) {
+	return block_offset + (block_start - block);
+}
+
+void BlockReader::seek(uint64_t position) throw (ReaderException) {
+	if (!is_seekable()) {
+		throw ReaderException("BlockReader", "seek( uint64_t )", __LINE__, 12, file_name);
+	}
+
+	clear_block();
+	seek_block(position);
+	block_offset = position;
+}
+
+void BlockReader::seek_block(uint64_t position) throw (ReaderException) {
+	throw ReaderException("BlockReader", "seek_block( uint64_t )", __LINE__, 12, file_name);
+}
+
+void BlockReader::set_read_ahead(bool read_ahead) {
+	this->read_ahead = read_ahead;
+}
+
+/* number of READ_AHEAD_BUFFER_SIZE buffers the read-ahead thread may fill in advance; applies from the next start */
+void BlockReader::set_read_ahead_depth(unsigned int buffers_number) {
+#ifndef WIN32
+	if ((buffers_number <= 0u) || read_ahead_running || (buffers_number == read_ahead_buffers_number)) {
+		return;
+	}
+
+	free_read_ahead_buffers();
+	read_ahead_buffers_number = buffers_number;
+#endif
+}
+
+#ifndef WIN32
+void BlockReader::start_read_ahead() throw (ReaderException) {
+	if (read_ahead_buffers == NULL) {
+		read_ahead_buffers = (read_ahead_buffer*)malloc(read_ahead_buffers_number * sizeof(read_ahead_buffer));
+		if (read_ahead_buffers == NULL) {
+			throw ReaderException("BlockReader", "start_read_ahead()", __LINE__, 2, read_ahead_buffers_number * sizeof(read_ahead_buffer));
+		}
+
+		for (unsigned int i = 0u; i < read_ahead_buffers_number; ++i) {
+			read_ahead_buffers[i].length = 0u;
+			read_ahead_buffers[i].data = NULL;
+		}
+
+		for (unsigned int i = 0u; i < read_ahead_buffers_number; ++i) {
+			read_ahead_buffers[i].data = (char*)malloc(READ_AHEAD_BUFFER_SIZE * sizeof(char));
+			if (read_ahead_buffers[i].data == NULL) {
+				throw ReaderException("BlockReader", "start_read_ahead()", __LINE__, 2, READ_AHEAD_BUFFER_SIZE * sizeof(char));
+			}
+		}
+	}
+
+	read_ahead_produced = 0ul;
+	read_ahead_consumed = 0ul;
+	read_ahead_offset = 0u;
+	read_ahead_stop = false;
+	read_ahead_end = false;
+
+	if (pthread_create(&read_ahead_thread, NULL, read_ahead_blocks, this) != 0) {
+		throw ReaderException("BlockReader", "start_read_ahead()", __LINE__, 10, file_name);
+	}
+
+	read_ahead_running = true;
+}
+
+void BlockReader::stop_read_ahead() {
+	if (read_ahead_running) {
+		pthread_mutex_lock(&read_ahead_mutex);
+		read_ahead_stop = true;
+		pthread_cond_broadcast(&read_ahead_drained);
+		pthread_mutex_unlock(&read_ahead_mutex);
+
+		pthread_join(read_ahead_thread, NULL);
+		read_ahead_running = false;
+	}
+
+	if (read_ahead_exception != NULL) {
+		delete read_ahead_exception;
+		read_ahead_exception = NULL;
+	}
+}
+
+void BlockReader::free_read_ahead_buffers() {
+	if (read_ahead_buffers != NULL) {
+		for (unsigned int i = 0u; i < read_ahead_buffers_number; ++i) {
+			free(read_ahead_buffers[i].data);
+		}
+		free(read_ahead_buffers);
+		read_ahead_buffers = NULL;
+	}
+}
+
+unsigned int BlockReader::take_block(char* destination, unsigned int size) throw (ReaderException) {
+	read_ahead_buffer* ready_buffer = NULL;
+	unsigned int copied = 0u;
+	unsigned int length = 0u;
+
+	while (copied < size) {
+		pthread_mutex_lock(&read_ahead_mutex);
+		while ((copied == 0u) && (read_ahead_consumed >= read_ahead_produced) && !read_ahead_end) {
+			pthread_cond_wait(&read_ahead_filled, &read_ahead_mutex);
+		}
+
+		if (read_ahead_consumed >= read_ahead_produced) {
+			pthread_mutex_unlock(&read_ahead_mutex);
+
+			if ((copied == 0u) && (read_ahead_exception != NULL)) {
+				throw ReaderException(*read_ahead_exception);
+			}
+
+			break;
+		}
+		pthread_mutex_unlock(&read_ahead_mutex);
+
+		ready_buffer = &read_ahead_buffers[read_ahead_consumed % read_ahead_buffers_number];
+
+		length = ready_buffer->length - read_ahead_offset;
+		if (length > size - copied) {
+			length = size - copied;
+		}
+
+		memcpy(destination + copied, ready_buffer->data + read_ahead_offset, length);
+		read_ahead_offset += length;
+		copied += length;
+
+		if (read_ahead_offset >= ready_buffer->length) {
+			read_ahead_offset = 0u;
+
+			pthread_mutex_lock(&read_ahead_mutex);
+			read_ahead_consumed += 1ul;
+			pthread_cond_signal(&read_ahead_drained);
+			pthread_mutex_unlock(&read_ahead_mutex);
+		}
+	}
+
+	return copied;
+}
+
+void* BlockReader::read_ahead_blocks(void* reader) {
+	BlockReader* block_reader = (BlockReader*)reader;
+	read_ahead_buffer* free_buffer = NULL;
+	ReaderException* exception = NULL;
+	unsigned int length = 0u;
+
+	pthread_mutex_lock(&block_reader->read_ahead_mutex);
+	while (true) {
+		while (!block_reader->read_ahead_stop &&
+				(block_reader->read_ahead_produced - block_reader->read_ahead_consumed >= block_reader->read_ahead_buffers_number)) {
+			pthread_cond_wait(&block_reader->read_ahead_drained, &block_reader->read_ahead_mutex);
+		}
+
+		if (block_reader->read_ahead_stop) {
+			break;
+		}
+
+		free_buffer = &block_reader->read_ahead_buffers[block_reader->read_ahead_produced % block_reader->read_ahead_buffers_number];
+		pthread_mutex_unlock(&block_reader->read_ahead_mutex);
+
+		length = 0u;
+		try {
+			length = block_reader->read_block(free_buffer->data, READ_AHEAD_BUFFER_SIZE);
+		} catch (ReaderException &e) {
+			exception = new ReaderException(e);
+		}
+
+		pthread_mutex_lock(&block_reader->read_ahead_mutex);
+		if ((exception != NULL) || (length == 0u)) {
+			block_reader->read_ahead_exception = exception;
+			block_reader->read_ahead_end = true;
+			pthread_cond_broadcast(&block_reader->read_ahead_filled);
+			break;
+		}
+
+		free_buffer->length = length;
+		block_reader->read_ahead_produced += 1ul;
+		pthread_cond_broadcast(&block_reader->read_ahead_filled);
+	}
+	pthread_mutex_unlock(&block_reader->read_ahead_mutex);
+
+	return NULL;
+}
+#endif
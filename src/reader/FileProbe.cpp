@@ -0,0 +1,449 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "include/FileProbe.h"
+
+const unsigned int FileProbe::CHUNK_SIZE = 4194304;
+
+FileProbe::FileProbe() : file_name(NULL), header(NULL), chunk(NULL), sample(NULL)
+#ifndef WIN32
+	, stream_reader(NULL)
+#endif
+{
+	clear();
+}
+
+FileProbe::~FileProbe() {
+	clear();
+}
+
+void FileProbe::clear() {
+	free(file_name);
+	file_name = NULL;
+
+	free(header);
+	header = NULL;
+
+	free(chunk);
+	chunk = NULL;
+
+	free(sample);
+	sample = NULL;
+
+#ifndef WIN32
+	if (stream_reader != NULL) {
+		delete stream_reader;
+		stream_reader = NULL;
+	}
+#endif
+
+	compressed = false;
+	bgzf = false;
+	regular = false;
+	stream = false;
+	file_size = 0ul;
+	modification_time = 0l;
+
+	header_found = false;
+	separators_found = false;
+	header_separator = '\0';
+	data_separator = '\0';
+	quoted = false;
+
+	estimated_lines_count = 0ul;
+}
+
+/* the same rules as in Reader::detect_field_separators(), applied to the lines already in memory */
+void FileProbe::inspect_lines(const char* data, unsigned long int length, bool complete) throw (ReaderException) {
+	int header_tokens_number[Reader::SEPARATORS_NUMBER];
+	int row_tokens_number[Reader::SEPARATORS_NUMBER];
+	int tokens_number[Reader::SEPARATORS_NUMBER];
+
+	bool data_was_read = false;
+	bool malformed = false;
+	unsigned int rows_read = 0u;
+
+	const char* end = data + length;
+	const char* line_end = NULL;
+	int line_length = 0;
+
+	for (int i = 0; i < Reader::SEPARATORS_NUMBER; i++) {
+		header_tokens_number[i] = 0;
+		row_tokens_number[i] = 0;
+	}
+
+	while ((data < end) && (rows_read < Reader::TOP_ROWS_NUMBER)) {
+		line_end = data;
+		while ((line_end < end) && (*line_end != '\n') && (*line_end != '\r')) {
+			line_end += 1;
+		}
+
+		if ((line_end >= end) && (!complete)) {
+			break;
+		}
+
+		if ((line_length = line_end - data) > 0) {
+			if (!header_found) {
+				header = (char*)malloc((line_length + 1) * sizeof(char));
+				if (header == NULL) {
+					throw ReaderException("FileProbe", "inspect_lines( const char*, unsigned long int, bool )", __LINE__, 2, (line_length + 1) * sizeof(char));
+				}
+				memcpy(header, data, line_length);
+				header[line_length] = '\0';
+
+				quoted |= Reader::count_separators(data, line_length, header_tokens_number, &malformed);
+				header_found = true;
+			} else if (!data_was_read) {
+				quoted |= Reader::count_separators(data, line_length, row_tokens_number, &malformed);
+				data_was_read = true;
+			} else {
+				quoted |= Reader::count_separators(data, line_length, tokens_number, &malformed);
+				for (int i = 0; i < Reader::SEPARATORS_NUMBER; i++) {
+					if (row_tokens_number[i] != tokens_number[i]) {
+						row_tokens_number[i] = numeric_limits<int>::min();
+					}
+				}
+				rows_read += 1u;
+			}
+		}
+
+		data = line_end;
+		if ((data < end) && (*data == '\r')) {
+			data += 1;
+			if ((data < end) && (*data == '\n')) {
+				data += 1;
+			}
+		} else if (data < end) {
+			data += 1;
+		}
+	}
+
+	quoted = quoted && !malformed;
+
+	if (header_found) {
+		separators_found = Reader::choose_separators(header_tokens_number, row_tokens_number, data_was_read, &header_separator, &data_separator);
+	}
+}
+
+void FileProbe::probe_text(ifstream& ifile_stream, unsigned long int chunk_length) throw (ReaderException) {
+	unsigned long int lines_count = 0ul;
+	bool pending_cr = false;
+	char last_char = '\n';
+
+	inspect_lines(chunk, chunk_length, ifile_stream.eof());
+
+	while (chunk_length > 0ul) {
+		lines_count += Reader::count_line_ends(chunk, chunk_length, &pending_cr);
+		last_char = chunk[chunk_length - 1ul];
+
+		if (ifile_stream.eof()) {
+			break;
+		}
+
+		ifile_stream.read(chunk, CHUNK_SIZE);
+		if (!ifile_stream.eof() && ifile_stream.fail()) {
+			throw ReaderException("FileProbe", "probe_text( ifstream&, unsigned long int )", __LINE__, 4, file_name);
+		}
+		chunk_length = (unsigned long int)ifile_stream.gcount();
+	}
+
+	if ((last_char != '\n') && (last_char != '\r')) {
+		lines_count += 1ul;
+	}
+
+	estimated_lines_count = lines_count > 0ul ? lines_count - 1ul : 0ul;
+}
+
+/* members are inflated from the bytes already read; the ISIZE trailer is read through the same stream */
+void FileProbe::probe_gzip(ifstream& ifile_stream, unsigned long int chunk_length) throw (ReaderException) {
+	z_stream stream;
+	int status = Z_OK;
+	bool member_end = false;
+	bool complete = false;
+
+	unsigned long int input_length = chunk_length;
+	unsigned long int sample_length = 0ul;
+	unsigned long int lines_count = 0ul;
+	bool pending_cr = false;
+	unsigned char trailer[4];
+
+	sample = (char*)malloc(GzipReader::ESTIMATE_SAMPLE_SIZE * sizeof(char));
+	if (sample == NULL) {
+		throw ReaderException("FileProbe", "probe_gzip( ifstream&, unsigned long int )", __LINE__, 2, GzipReader::ESTIMATE_SAMPLE_SIZE * sizeof(char));
+	}
+
+	memset(&stream, 0, sizeof(z_stream));
+	if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+		throw ReaderException("FileProbe", "probe_gzip( ifstream&, unsigned long int )", __LINE__, 10, file_name);
+	}
+
+	stream.next_in = (Bytef*)chunk;
+	stream.avail_in = chunk_length;
+	stream.next_out = (Bytef*)sample;
+	stream.avail_out = GzipReader::ESTIMATE_SAMPLE_SIZE;
+
+	while (stream.avail_out > 0u) {
+		if (stream.avail_in == 0u) {
+			if (ifile_stream.eof()) {
+				break;
+			}
+
+			ifile_stream.read(chunk, CHUNK_SIZE);
+			if (!ifile_stream.eof() && ifile_stream.fail()) {
+				inflateEnd(&stream);
+				throw ReaderException("FileProbe", "probe_gzip( ifstream&, unsigned long int )", __LINE__, 4, file_name);
+			}
+
+			if ((chunk_length = (unsigned long int)ifile_stream.gcount()) == 0ul) {
+				break;
+			}
+
+			input_length += chunk_length;
+			stream.next_in = (Bytef*)chunk;
+			stream.avail_in = chunk_length;
+		}
+
+		if (member_end) {
+			inflateReset(&stream);
+			member_end = false;
+		}
+
+		status = inflate(&stream, Z_NO_FLUSH);
+		if (status == Z_STREAM_END) {
+			member_end = true;
+		} else if ((status != Z_OK) && ((status != Z_BUF_ERROR) || (stream.avail_in > 0u))) {
+			inflateEnd(&stream);
+			throw ReaderException("FileProbe", "probe_gzip( ifstream&, unsigned long int )", __LINE__, 4, file_name);
+		}
+	}
+
+	complete = stream.avail_out > 0u;
+	sample_length = GzipReader::ESTIMATE_SAMPLE_SIZE - stream.avail_out;
+	input_length -= stream.avail_in;
+
+	inflateEnd(&stream);
+
+	inspect_lines(sample, sample_length, complete);
+
+	if (sample_length > 0ul) {
+		lines_count = Reader::count_line_ends(sample, sample_length, &pending_cr);
+		if ((sample[sample_length - 1ul] != '\n') && (sample[sample_length - 1ul] != '\r') && (complete)) {
+			lines_count += 1ul;
+		}
+	}
+
+	if ((complete) || (lines_count == 0ul) || (input_length == 0ul)) {
+		estimated_lines_count = lines_count > 0ul ? lines_count - 1ul : 0ul;
+		return;
+	}
+
+	ifile_stream.clear();
+	ifile_stream.seekg((streamoff)-4, ifstream::end);
+	if (ifile_stream.fail()) {
+		throw ReaderException("FileProbe", "probe_gzip( ifstream&, unsigned long int )", __LINE__, 6, file_name);
+	}
+
+	ifile_stream.read((char*)trailer, 4);
+	if (ifile_stream.fail()) {
+		throw ReaderException("FileProbe", "probe_gzip( ifstream&, unsigned long int )", __LINE__, 4, file_name);
+	}
+
+	estimated_lines_count = GzipReader::scale_lines_count(lines_count, sample_length, input_length, (double)file_size, trailer);
+}
+
+#ifndef WIN32
+/* a stream can't be reopened: the reader that inspected its prefix is kept and handed over to the first consumer */
+void FileProbe::probe_stream() throw (ReaderException) {
+	stream_reader = new StreamReader();
+	stream_reader->set_file_name(file_name);
+	stream_reader->open();
+
+	compressed = stream_reader->is_compressed();
+
+	inspect_lines(stream_reader->get_prefix(), stream_reader->get_prefix_length(), stream_reader->is_prefix_complete());
+	estimated_lines_count = stream_reader->estimate_lines_count();
+}
+
+#endif
+void FileProbe::probe(const char* file_name) throw (ReaderException) {
+	ifstream ifile_stream;
+	struct stat file_stat;
+	unsigned long int chunk_length = 0ul;
+
+	if (file_name == NULL) {
+		throw ReaderException("FileProbe", "probe( const char* )", __LINE__, 0, "file_name");
+	}
+
+	if (strlen(file_name) <= 0) {
+		throw ReaderException("FileProbe", "probe( const char* )", __LINE__, 1, "file_name");
+	}
+
+	clear();
+
+	this->file_name = (char*)malloc((strlen(file_name) + 1) * sizeof(char));
+	if (this->file_name == NULL) {
+		throw ReaderException("FileProbe", "probe( const char* )", __LINE__, 2, (strlen(file_name) + 1) * sizeof(char));
+	}
+	strcpy(this->file_name, file_name);
+
+#ifndef WIN32
+	if (StreamReader::is_stream(file_name)) {
+		stream = true;
+		probe_stream();
+		return;
+	}
+#endif
+
+	if (stat(file_name, &file_stat) != 0) {
+		throw ReaderException("FileProbe", "probe( const char* )", __LINE__, 3, file_name);
+	}
+
+	regular = S_ISREG(file_stat.st_mode);
+	file_size = (unsigned long int)file_stat.st_size;
+	modification_time = (long int)file_stat.st_mtime;
+
+	chunk = (char*)malloc(CHUNK_SIZE * sizeof(char));
+	if (chunk == NULL) {
+		throw ReaderException("FileProbe", "probe( const char* )", __LINE__, 2, CHUNK_SIZE * sizeof(char));
+	}
+
+	ifile_stream.open(file_name, ios::binary);
+	if (ifile_stream.fail()) {
+		throw ReaderException("FileProbe", "probe( const char* )", __LINE__, 3, file_name);
+	}
+
+	ifile_stream.read(chunk, CHUNK_SIZE);
+	if (!ifile_stream.eof() && ifile_stream.fail()) {
+		throw ReaderException("FileProbe", "probe( const char* )", __LINE__, 4, file_name);
+	}
+	chunk_length = (unsigned long int)ifile_stream.gcount();
+
+	compressed = GzipReader::is_gzip_header((const unsigned char*)chunk, chunk_length);
+#ifndef WIN32
+	bgzf = BgzfReader::is_bgzf_header((const unsigned char*)chunk, chunk_length);
+#endif
+
+	if (compressed) {
+		probe_gzip(ifile_stream, chunk_length);
+	} else {
+		probe_text(ifile_stream, chunk_length);
+	}
+
+	ifile_stream.clear();
+	ifile_stream.close();
+	if (ifile_stream.fail()) {
+		throw ReaderException("FileProbe", "probe( const char* )", __LINE__, 5, file_name);
+	}
+
+	free(chunk);
+	chunk = NULL;
+
+	free(sample);
+	sample = NULL;
+}
+
+bool FileProbe::is_current(const char* file_name) {
+	struct stat file_stat;
+
+	if ((this->file_name == NULL) || (file_name == NULL) || (strcmp(this->file_name, file_name) != 0)) {
+		return false;
+	}
+
+	if (stream) {
+		return true;
+	}
+
+	if (stat(file_name, &file_stat) != 0) {
+		return false;
+	}
+
+	return ((unsigned long int)file_stat.st_size == file_size) && ((long int)file_stat.st_mtime == modification_time);
+}
+
+const char* FileProbe::get_file_name() {
+	return file_name;
+}
+
+bool FileProbe::is_compressed() {
+	return compressed;
+}
+
+bool FileProbe::is_bgzf() {
+	return bgzf;
+}
+
+bool FileProbe::is_regular() {
+	return regular;
+}
+
+bool FileProbe::is_stream() {
+	return stream;
+}
+
+unsigned long int FileProbe::get_file_size() {
+	return file_size;
+}
+
+long int FileProbe::get_modification_time() {
+	return modification_time;
+}
+
+const char* FileProbe::get_header() {
+	return header;
+}
+
+void FileProbe::get_field_separators(char* header_separator, char* data_separator) throw (ReaderException) {
+	if (header_separator == NULL) {
+		throw ReaderException("FileProbe", "get_field_separators( char*, char* )", __LINE__, 0, "header_separator");
+	}
+
+	if (data_separator == NULL) {
+		throw ReaderException("FileProbe", "get_field_separators( char*, char* )", __LINE__, 0, "data_separator");
+	}
+
+	if (header_found) {
+		if (!separators_found) {
+			throw ReaderException("FileProbe", "get_field_separators( char*, char* )", __LINE__, 8, file_name);
+		}
+
+		if (this->header_separator != '\0') {
+			*header_separator = this->header_separator;
+			*data_separator = this->data_separator;
+		}
+	}
+}
+
+/* true if quotes were seen in the top rows */
+bool FileProbe::is_quoted() {
+	return quoted;
+}
+
+unsigned long int FileProbe::get_estimated_lines_count() {
+	return estimated_lines_count;
+}
+
+#ifndef WIN32
+/* NULL once the stream was taken */
+StreamReader* FileProbe::take_stream_reader() {
+	StreamReader* reader = stream_reader;
+
+	stream_reader = NULL;
+
+	return reader;
+}
+#endif
@@ -19,95 +19,372 @@
 
 #include "include/GzipReader.h"
 
-const unsigned int GzipReader::DEFAULT_BUFFER_SIZE = 16777216;
-const unsigned int GzipReader::TOP_ROWS_NUMBER = 10;
+const unsigned int GzipReader::DEFAULT_BUFFER_SIZE = 65536;
+const unsigned int GzipReader::GZIP_BUFFER_SIZE = 131072;
+const unsigned int GzipReader::ESTIMATE_SAMPLE_SIZE = 4194304;
 
-GzipReader::GzipReader(unsigned int buffer_size) throw (ReaderException) : Reader(&buffer),
-	opened(false), buffer_size(buffer_size), buffer(NULL) {
+GzipReader::GzipReader(unsigned int buffer_size) throw (ReaderException) : BlockReader(buffer_size),
+	input(NULL), input_position(0u), output_position(0u), input_eof(false), stream_end(false), transparent(false), raw(false),
+	window(NULL), window_next(0u), window_length(0u), checkpoint_span(InflateIndex::DEFAULT_SPAN), opened(false) {
 
-	buffer = (char*)malloc((buffer_size + 1) * sizeof(char));
-	if (buffer == NULL) {
-		throw ReaderException("GzipReader", "GzipReader( int )", __LINE__, 2, (buffer_size + 1) * sizeof(char));
+	memset(&stream, 0, sizeof(z_stream));
+}
+
+GzipReader::~GzipReader() {
+	clear_block();
+
+	if (opened) {
+		inflateEnd(&stream);
+		ifile_stream.close();
+		opened = false;
 	}
 
-	buffer[0] = '\0';
+	free(input);
+	input = NULL;
+
+	free(window);
+	window = NULL;
 }
 
-GzipReader::~GzipReader() {
-	buffer_size = 0;
+bool GzipReader::is_gzip_header(const unsigned char* header, unsigned int length) {
+	return (length >= 2u) && (header[0] == 0x1F) && (header[1] == 0x8B);
+}
+
+/* moves the unconsumed input to the front of the buffer and appends as much of the file as fits */
+unsigned int GzipReader::fill_input() throw (ReaderException) {
+	unsigned int read_size = 0u;
 
-	free(buffer);
-	buffer = NULL;
+	if (input_eof) {
+		return 0u;
+	}
+
+	if ((stream.avail_in > 0u) && (stream.next_in != input)) {
+		memmove(input, stream.next_in, stream.avail_in);
+	}
+	stream.next_in = input;
+
+	ifile_stream.read((char*)input + stream.avail_in, GZIP_BUFFER_SIZE - stream.avail_in);
+	if (!ifile_stream.eof() && ifile_stream.fail()) {
+		throw ReaderException("GzipReader", "unsigned int fill_input()", __LINE__, 4, file_name);
+	}
+
+	read_size = (unsigned int)ifile_stream.gcount();
+	input_eof = ifile_stream.eof();
+
+	stream.avail_in += read_size;
+	input_position += read_size;
+
+	return read_size;
 }
 
-void GzipReader::open() throw (ReaderException) {
-	close();
+/* inflating restarts at the beginning of the file (checkpoint < 0) or, as raw deflate data, at one of the checkpoints */
+void GzipReader::start_inflate(long int checkpoint) throw (ReaderException) {
+	uint64_t input_offset = 0u;
+	unsigned int bits = 0u;
+	int value = Z_OK;
+
+	if (checkpoint >= 0l) {
+		input_offset = inflate_index.get_input_offset(checkpoint);
+		bits = inflate_index.get_bits(checkpoint);
+		if (bits > 0u) {
+			input_offset -= 1u;
+		}
+	}
 
-	infile = gzopen(file_name, "rb");
-	if (infile == NULL) {
-		throw ReaderException("GzipReader", "open()", __LINE__, 3, file_name);
+	ifile_stream.clear();
+	ifile_stream.seekg((streampos)input_offset, ifstream::beg);
+	if (ifile_stream.fail()) {
+		throw ReaderException("GzipReader", "start_inflate( long int )", __LINE__, 6, file_name);
 	}
 
-	opened = true;
+	stream.next_in = input;
+	stream.avail_in = 0u;
+	input_position = input_offset;
+	input_eof = false;
+	stream_end = false;
+
+	window_next = 0u;
+	window_length = 0u;
+
+	if (checkpoint < 0l) {
+		value = inflateReset2(&stream, 15 + 16);
+		output_position = 0u;
+		raw = false;
+	} else {
+		value = inflateReset2(&stream, -15);
+		output_position = inflate_index.get_output_offset(checkpoint);
+		raw = true;
+
+		if ((value == Z_OK) && (bits > 0u)) {
+			if (fill_input() == 0u) {
+				throw ReaderException("GzipReader", "start_inflate( long int )", __LINE__, 4, file_name);
+			}
+			value = inflatePrime(&stream, bits, stream.next_in[0] >> (8u - bits));
+			stream.next_in += 1;
+			stream.avail_in -= 1u;
+		}
+
+		if (value == Z_OK) {
+			value = inflateSetDictionary(&stream, inflate_index.get_window(checkpoint), inflate_index.get_window_length(checkpoint));
+		}
+	}
+
+	if (value != Z_OK) {
+		throw ReaderException("GzipReader", "start_inflate( long int )", __LINE__, 10, file_name);
+	}
 }
 
-void GzipReader::close() throw (ReaderException) {
-	if (opened) {
-		int gzerrno = 0;
+/* a member resumed from a checkpoint ends without its 8-byte trailer being consumed; anything after the last member that is not another gzip header is ignored, as in gzread() */
+void GzipReader::next_member() throw (ReaderException) {
+	unsigned int skip = raw ? 8u : 0u;
+	unsigned int length = 0u;
 
-		gzerrno = gzclose(infile);
-		if (gzerrno != Z_OK) {
-			throw ReaderException("GzipReader", "open()", __LINE__, 5, file_name);
+	while (skip > 0u) {
+		if ((stream.avail_in == 0u) && (fill_input() == 0u)) {
+			stream_end = true;
+			return;
 		}
 
-		opened = false;
+		length = stream.avail_in < skip ? stream.avail_in : skip;
+		stream.next_in += length;
+		stream.avail_in -= length;
+		skip -= length;
+	}
+
+	if (stream.avail_in < 2u) {
+		fill_input();
+	}
+
+	if (!is_gzip_header(stream.next_in, stream.avail_in)) {
+		stream_end = true;
+		return;
+	}
+
+	if (inflateReset2(&stream, 15 + 16) != Z_OK) {
+		throw ReaderException("GzipReader", "next_member()", __LINE__, 10, file_name);
+	}
+	raw = false;
+}
+
+/* the window is a ring holding the last WINDOW_SIZE inflated bytes */
+void GzipReader::update_window(const unsigned char* data, unsigned int length) {
+	unsigned int first_length = 0u;
+
+	if (length >= InflateIndex::WINDOW_SIZE) {
+		memcpy(window, data + length - InflateIndex::WINDOW_SIZE, InflateIndex::WINDOW_SIZE);
+		window_next = 0u;
+		window_length = InflateIndex::WINDOW_SIZE;
+		return;
+	}
+
+	first_length = InflateIndex::WINDOW_SIZE - window_next;
+	if (first_length > length) {
+		first_length = length;
+	}
+
+	memcpy(window + window_next, data, first_length);
+	memcpy(window, data + first_length, length - first_length);
+
+	window_next = (window_next + length) % InflateIndex::WINDOW_SIZE;
+	window_length = (window_length + length < InflateIndex::WINDOW_SIZE) ? window_length + length : InflateIndex::WINDOW_SIZE;
+}
+
+void GzipReader::add_checkpoint() throw (ReaderException) {
+	if ((window_length == InflateIndex::WINDOW_SIZE) && (window_next > 0u)) {
+		rotate(window, window + window_next, window + InflateIndex::WINDOW_SIZE);
+		window_next = 0u;
 	}
+
+	inflate_index.add_checkpoint(output_position, input_position - stream.avail_in, (unsigned int)(stream.data_type & 7), window, window_length);
 }
 
-int GzipReader::read_line() throw (ReaderException) {
-	int i = 0;
-	int c = 0;
-
-	while ((i < buffer_size) && ((c = gzgetc(infile)) >= 0)) {
-		buffer[i] = (char)c;
-
-		if (buffer[i] == '\n') {
-			buffer[i] = '\0';
-			return i;
-		} else if (buffer[i] == '\r') {
-			buffer[i] = '\0';
-			if ((c = gzgetc(infile)) >= 0) {
-				if ((char)c != '\n') {
-					c = gzungetc(c, infile);
+/* inflate stops at every deflate block boundary, where a checkpoint is added once the last one is at least a span behind */
+unsigned int GzipReader::read_block(char* destination, unsigned int size) throw (ReaderException) {
+	unsigned int produced = 0u;
+	unsigned int length = 0u;
+	uint64_t frontier = 0u;
+	int value = Z_OK;
+
+	if (transparent) {
+		ifile_stream.read(destination, size);
+		if (!ifile_stream.eof() && ifile_stream.fail()) {
+			throw ReaderException("GzipReader", "unsigned int read_block( char*, unsigned int )", __LINE__, 4, file_name);
+		}
+
+		output_position += (uint64_t)ifile_stream.gcount();
+
+		return (unsigned int)ifile_stream.gcount();
+	}
+
+	while ((produced < size) && !stream_end) {
+		if (stream.avail_in == 0u) {
+			fill_input();
+		}
+
+		stream.next_out = (Bytef*)(destination + produced);
+		stream.avail_out = size - produced;
+
+		value = inflate(&stream, Z_BLOCK);
+		if ((value != Z_OK) && (value != Z_STREAM_END) && (value != Z_BUF_ERROR)) {
+			throw ReaderException("GzipReader", "unsigned int read_block( char*, unsigned int )", __LINE__, 4, file_name);
+		}
+
+		frontier = inflate_index.get_checkpoints_number() > 0ul ? inflate_index.get_output_offset(inflate_index.get_checkpoints_number() - 1ul) : 0u;
+
+		length = (size - produced) - stream.avail_out;
+		if (output_position + length > frontier) {
+			update_window((const unsigned char*)destination + produced, length);
+		}
+		produced += length;
+		output_position += length;
+
+		if (value == Z_STREAM_END) {
+			next_member();
+		} else if (value == Z_BUF_ERROR) {
+			/* no progress without more input: the file is truncated */
+			if (input_eof && (stream.avail_in == 0u)) {
+				throw ReaderException("GzipReader", "unsigned int read_block( char*, unsigned int )", __LINE__, 4, file_name);
+			}
+		} else if (((stream.data_type & 128) != 0) && ((stream.data_type & 64) == 0) && (output_position >= frontier + inflate_index.get_span())) {
+			add_checkpoint();
+		}
+	}
+
+	return produced;
+}
+
+/* inflating resumes from the nearest checkpoint at or before the position, unless the current one is closer */
+void GzipReader::seek_block(uint64_t position) throw (ReaderException) {
+	char* skip_buffer = NULL;
+	uint64_t skip_size = 0u;
+	long int checkpoint = -1l;
+
+	if (transparent) {
+		ifile_stream.clear();
+		ifile_stream.seekg((streampos)position, ifstream::beg);
+		if (ifile_stream.fail()) {
+			throw ReaderException("GzipReader", "seek_block( uint64_t )", __LINE__, 6, file_name);
+		}
+		output_position = position;
+		return;
+	}
+
+	checkpoint = inflate_index.find_checkpoint(position);
+	if ((position < output_position) || ((checkpoint >= 0l) && (inflate_index.get_output_offset(checkpoint) > output_position))) {
+		start_inflate(checkpoint);
+	}
+
+	if (position > output_position) {
+		skip_buffer = (char*)malloc(GZIP_BUFFER_SIZE * sizeof(char));
+		if (skip_buffer == NULL) {
+			throw ReaderException("GzipReader", "seek_block( uint64_t )", __LINE__, 2, GZIP_BUFFER_SIZE * sizeof(char));
+		}
+
+		try {
+			while (position > output_position) {
+				skip_size = position - output_position;
+				if (skip_size > GZIP_BUFFER_SIZE) {
+					skip_size = GZIP_BUFFER_SIZE;
+				}
+
+				if (read_block(skip_buffer, (unsigned int)skip_size) == 0u) {
+					break;
 				}
 			}
-			return i;
+		} catch (ReaderException &e) {
+			free(skip_buffer);
+			throw;
+		}
+
+		free(skip_buffer);
+	}
+}
+
+/* checkpoints saved next to the file by an earlier run are picked up here */
+void GzipReader::open() throw (ReaderException) {
+	close();
+
+	if (input == NULL) {
+		input = (unsigned char*)malloc(GZIP_BUFFER_SIZE * sizeof(unsigned char));
+		if (input == NULL) {
+			throw ReaderException("GzipReader", "open()", __LINE__, 2, GZIP_BUFFER_SIZE * sizeof(unsigned char));
+		}
+	}
+
+	if (window == NULL) {
+		window = (unsigned char*)malloc(InflateIndex::WINDOW_SIZE * sizeof(unsigned char));
+		if (window == NULL) {
+			throw ReaderException("GzipReader", "open()", __LINE__, 2, InflateIndex::WINDOW_SIZE * sizeof(unsigned char));
 		}
+	}
+
+	ifile_stream.clear();
+	ifile_stream.open(file_name, ios::binary);
+	if (ifile_stream.fail()) {
+		throw ReaderException("GzipReader", "open()", __LINE__, 3, file_name);
+	}
 
-		i += 1;
+	memset(&stream, 0, sizeof(z_stream));
+	if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+		ifile_stream.close();
+		throw ReaderException("GzipReader", "open()", __LINE__, 10, file_name);
 	}
 
-	buffer[i] = '\0';
+	opened = true;
+
+	start_inflate(-1l);
 
-	if ((c < 0) && (gzeof(infile) < 1)) {
-		throw ReaderException("GzipReader", "int read_line()", __LINE__, 4, file_name);
+	/* like gzopen(), files without a gzip header are read as they are */
+	fill_input();
+	transparent = !is_gzip_header(stream.next_in, stream.avail_in);
+	if (transparent) {
+		ifile_stream.clear();
+		ifile_stream.seekg((streampos)0, ifstream::beg);
+		if (ifile_stream.fail()) {
+			throw ReaderException("GzipReader", "open()", __LINE__, 6, file_name);
+		}
+		stream.avail_in = 0u;
+		input_eof = false;
+		return;
 	}
 
-	return (i == 0 ? -1 : i);
+	if (!inflate_index.is_current(file_name) && !inflate_index.load(file_name)) {
+		inflate_index.start(file_name, checkpoint_span);
+	}
+}
+
+void GzipReader::close() throw (ReaderException) {
+	clear_block();
+
+	if (opened) {
+		inflateEnd(&stream);
+
+		ifile_stream.clear();
+		ifile_stream.close();
+		opened = false;
+
+		if (ifile_stream.fail()) {
+			throw ReaderException("GzipReader", "close()", __LINE__, 5, file_name);
+		}
+	}
 }
 
 void GzipReader::reset() throw (ReaderException) {
-	if (gzseek(infile, 0L, SEEK_SET) < 0) {
-		throw ReaderException("GzipReader", "reset()", __LINE__, 6, file_name);
+	clear_block();
+
+	if (transparent) {
+		seek_block(0u);
+	} else {
+		start_inflate(-1l);
 	}
 }
 
 bool GzipReader::eof() {
-	return gzeof(infile) > 0;
+	return is_block_end();
 }
 
 bool GzipReader::sof() {
-	return gztell(infile) == 0;
+	return opened && is_block_start();
 }
 
 bool GzipReader::is_open() {
@@ -118,170 +395,121 @@ bool GzipReader::is_compressed() {
 	return true;
 }
 
-int GzipReader::get_buffer_size() {
-	return buffer_size;
+bool GzipReader::is_seekable() {
+	return true;
 }
 
-void GzipReader::detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException) {
-	const unsigned int separators_number = 4;
-	char separators[separators_number] = {',', '\t', ' ' , ';'};
+/* only files long enough to have checkpoints get a sidecar */
+void GzipReader::save_checkpoints() throw (ReaderException) {
+	if (!transparent && (inflate_index.get_checkpoints_number() > 0ul)) {
+		inflate_index.save();
+	}
+}
 
-	int header_tokens_number[separators_number];
-	int row_tokens_number[separators_number];
+/* applies to files whose checkpoints are not built or loaded yet */
+void GzipReader::set_checkpoint_span(unsigned long int span) {
+	if (span >= InflateIndex::WINDOW_SIZE) {
+		checkpoint_span = span;
+	}
+}
+
+unsigned long int GzipReader::get_checkpoints_number() {
+	return inflate_index.get_checkpoints_number();
+}
 
-	bool header_was_read = false;
-	bool data_was_read = false;
-	unsigned int rows_read = 0;
+/* lines are counted in an inflated prefix and scaled by the uncompressed size, taken from the ISIZE trailer when it agrees with the compression ratio of the prefix */
+unsigned long int GzipReader::estimate_lines_count() throw (ReaderException) {
+	gzFile sample_file = NULL;
+	char* sample = NULL;
+	int sample_length = 0;
+	z_off_t sample_offset = 0;
+	unsigned long int lines_count = 0ul;
+	bool pending_cr = false;
 
-	int line_length = 0;
-	int tokens_number = 0;
-	int char_position = 0;
-	unsigned int i = 0, j = 0;
-	int header_separator_index = -1;
-	int data_separator_index = -1;
-	unsigned int matches = 0;
+	ifstream ifile_stream;
+	unsigned char trailer[4];
+	double file_length = 0.0;
 
-	if (header_separator == NULL) {
-		throw ReaderException("GzipReader", "detect_field_separators( char*, char* )", __LINE__, 0, "header_separator");
+	close();
+
+	sample = (char*)malloc(ESTIMATE_SAMPLE_SIZE * sizeof(char));
+	if (sample == NULL) {
+		throw ReaderException("GzipReader", "unsigned int estimate_lines_count()", __LINE__, 2, ESTIMATE_SAMPLE_SIZE * sizeof(char));
 	}
 
-	if (data_separator == NULL) {
-		throw ReaderException("GzipReader", "detect_field_separators( char*, char* )", __LINE__, 0, "data_separator");
+	sample_file = gzopen(file_name, "rb");
+	if (sample_file == NULL) {
+		free(sample);
+		throw ReaderException("GzipReader", "unsigned int estimate_lines_count()", __LINE__, 3, file_name);
 	}
 
-	if (opened) {
-		if (gzclose(infile) != Z_OK) {
-			throw ReaderException("GzipReader", "detect_field_separators( char*, char* )", __LINE__, 5, file_name);
+	if ((sample_length = gzread(sample_file, sample, ESTIMATE_SAMPLE_SIZE)) < 0) {
+		gzclose(sample_file);
+		free(sample);
+		throw ReaderException("GzipReader", "unsigned int estimate_lines_count()", __LINE__, 4, file_name);
+	}
+
+	sample_offset = gzoffset(sample_file);
+
+	if (sample_length > 0) {
+		lines_count = count_line_ends(sample, sample_length, &pending_cr);
+		if ((sample[sample_length - 1] != '\n') && (sample[sample_length - 1] != '\r') && ((unsigned int)sample_length < ESTIMATE_SAMPLE_SIZE)) {
+			lines_count += 1ul;
 		}
-		opened = false;
 	}
 
-	if ((infile = gzopen(file_name, "rb")) == NULL) {
-		throw ReaderException("GzipReader", "detect_field_separators( char*, char* )", __LINE__, 3, file_name);
+	free(sample);
+
+	if (gzclose(sample_file) != Z_OK) {
+		throw ReaderException("GzipReader", "unsigned int estimate_lines_count()", __LINE__, 5, file_name);
 	}
-	opened = true;
 
-	i = 0;
-	while (i < separators_number) {
-		header_tokens_number[i] = 0;
-		row_tokens_number[i] = 0;
-		i += 1;
-	}
-
-	try {
-		while ((!header_was_read) && ((line_length = read_line()) >= 0)) {
-			if (line_length > 0) {
-				header_was_read = true;
-
-				i = 0;
-				while (i < separators_number) {
-					tokens_number = 0;
-					char_position = 0;
-					while (char_position < line_length) {
-						if ((*line)[char_position] == separators[i]) {
-							tokens_number += 1;
-						}
-						char_position += 1;
-					}
-					header_tokens_number[i] = tokens_number;
-					i += 1;
-				}
-			}
-		}
+	if (((unsigned int)sample_length < ESTIMATE_SAMPLE_SIZE) || (lines_count == 0ul) || (sample_offset <= 0)) {
+		return lines_count > 0ul ? lines_count - 1ul : 0ul;
+	}
 
-		while ((!data_was_read) && ((line_length = read_line()) >= 0)) {
-			if (line_length > 0) {
-				data_was_read = true;
-
-				i = 0;
-				while (i < separators_number) {
-					tokens_number = 0;
-					char_position = 0;
-					while (char_position < line_length) {
-						if ((*line)[char_position] == separators[i]) {
-							tokens_number += 1;
-						}
-						char_position += 1;
-					}
-					row_tokens_number[i] = tokens_number;
-					i += 1;
-				}
-			}
-		}
+	ifile_stream.open(file_name, ios::binary);
+	if (ifile_stream.fail()) {
+		throw ReaderException("GzipReader", "unsigned int estimate_lines_count()", __LINE__, 3, file_name);
+	}
 
-		while ((rows_read < TOP_ROWS_NUMBER) && ((line_length = read_line()) >= 0)) {
-			if (line_length > 0) {
-				i = 0;
-				while (i < separators_number) {
-					tokens_number = 0;
-					char_position = 0;
-					while (char_position < line_length) {
-						if ((*line)[char_position] == separators[i]) {
-							tokens_number += 1;
-						}
-						char_position += 1;
-					}
-
-					if ((row_tokens_number[i] != tokens_number) && (row_tokens_number[i] != numeric_limits<int>::min())) {
-						row_tokens_number[i] = numeric_limits<int>::min();
-					}
-					i += 1;
-				}
-				rows_read += 1;
-			}
-		}
-	} catch (ReaderException &e) {
-		e.add_message("GzipReader", "detect_field_separators( char*, char* )", __LINE__, 7, (const char*)file_name);
-		throw;
-	}
-
-	if (gzclose(infile) != Z_OK) {
-		throw ReaderException("GzipReader", "detect_field_separators( char*, char* )", __LINE__, 5, file_name);
-	}
-	opened = false;
-
-	buffer[0] = '\0';
-
-	if (header_was_read) {
-		if (data_was_read) {
-			i = 0;
-			while (i < separators_number) {
-				j = 0;
-				while (j < separators_number) {
-					if ((header_tokens_number[i] == row_tokens_number[j]) && (header_tokens_number[i] > 0)) {
-						header_separator_index = i;
-						data_separator_index = j;
-						matches += 1;
-					}
-					j += 1;
-				}
-				i += 1;
-			}
-		} else {
-			i = 0;
-			while (i < separators_number) {
-				if (header_tokens_number[i] > 0) {
-					header_separator_index = i;
-					data_separator_index = i;
-					matches += 1;
-				}
-				i += 1;
-			}
-		}
+	ifile_stream.seekg((streamoff)-4, ifstream::end);
+	if (ifile_stream.fail()) {
+		throw ReaderException("GzipReader", "unsigned int estimate_lines_count()", __LINE__, 6, file_name);
+	}
 
-		if (matches < 1) {
-			i = 0;
-			while (i < separators_number) {
-				if ((header_tokens_number[i] != 0) || (row_tokens_number[i] != 0)) {
-					throw ReaderException("GzipReader", "detect_field_separators( char*, char* )", __LINE__, 8, file_name);
-				}
-				i += 1;
-			}
-		} else if (matches > 1) {
-			throw ReaderException("GzipReader", "detect_field_separators( char*, char* )", __LINE__, 8, file_name);
-		} else {
-			*header_separator = separators[header_separator_index];
-			*data_separator = separators[data_separator_index];
+	file_length = (double)ifile_stream.tellg() + 4.0;
+
+	ifile_stream.read((char*)trailer, 4);
+	if (ifile_stream.fail()) {
+		throw ReaderException("GzipReader", "unsigned int estimate_lines_count()", __LINE__, 4, file_name);
+	}
+
+	ifile_stream.close();
+	if (ifile_stream.fail()) {
+		throw ReaderException("GzipReader", "unsigned int estimate_lines_count()", __LINE__, 5, file_name);
+	}
+
+	return scale_lines_count(lines_count, sample_length, sample_offset, file_length, trailer);
+}
+
+/* ISIZE holds the length of the last member modulo 2^32 */
+unsigned long int GzipReader::scale_lines_count(unsigned long int lines_count, unsigned long int sample_length, unsigned long int sample_offset, double file_length, const unsigned char* trailer) {
+	double uncompressed_length = file_length * sample_length / (double)sample_offset;
+	double trailer_length = 0.0;
+	double wraps = 0.0;
+
+	trailer_length = (double)(trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((unsigned long int)trailer[3] << 24));
+	if (trailer_length > 0.0) {
+		wraps = floor((uncompressed_length - trailer_length) / 4294967296.0 + 0.5);
+		trailer_length += (wraps > 0.0 ? wraps : 0.0) * 4294967296.0;
+
+		if ((trailer_length >= sample_length) && (trailer_length >= uncompressed_length / 2.0) && (trailer_length <= uncompressed_length * 2.0)) {
+			uncompressed_length = trailer_length;
 		}
 	}
+
+	lines_count = (unsigned long int)ceil(uncompressed_length * lines_count / sample_length);
+
+	return lines_count > 0ul ? lines_count - 1ul : 0ul;
 }
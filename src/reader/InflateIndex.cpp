@@ -0,0 +1,374 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/InflateIndex.h"
+
+const char* InflateIndex::FILE_EXTENSION = ".gwz";
+const char InflateIndex::MAGIC[] = {'G', 'W', 'Z', '\0'};
+const unsigned long int InflateIndex::FORMAT_VERSION = 1ul;
+const unsigned long int InflateIndex::DEFAULT_SPAN = 16777216ul;
+const unsigned int InflateIndex::WINDOW_SIZE = 32768u;
+
+InflateIndex::InflateIndex() : file_name(NULL) {
+	clear();
+}
+
+InflateIndex::~InflateIndex() {
+	clear();
+}
+
+void InflateIndex::clear() {
+	free(file_name);
+	file_name = NULL;
+
+	file_size = 0ul;
+	modification_time = 0l;
+
+	span = DEFAULT_SPAN;
+
+	for (vector<checkpoint>::iterator checkpoints_it = checkpoints.begin(); checkpoints_it != checkpoints.end(); checkpoints_it++) {
+		free(checkpoints_it->window);
+	}
+	checkpoints.clear();
+}
+
+void InflateIndex::set_file(const char* file_name) throw (ReaderException) {
+	this->file_name = (char*)malloc((strlen(file_name) + 1u) * sizeof(char));
+	if (this->file_name == NULL) {
+		throw ReaderException("InflateIndex", "set_file( const char* )", __LINE__, 2, (strlen(file_name) + 1u) * sizeof(char));
+	}
+	strcpy(this->file_name, file_name);
+}
+
+char* InflateIndex::get_index_file_name() throw (ReaderException) {
+	char* index_file_name = NULL;
+
+	index_file_name = (char*)malloc((strlen(file_name) + strlen(FILE_EXTENSION) + 1u) * sizeof(char));
+	if (index_file_name == NULL) {
+		throw ReaderException("InflateIndex", "get_index_file_name()", __LINE__, 2, (strlen(file_name) + strlen(FILE_EXTENSION) + 1u) * sizeof(char));
+	}
+
+	strcpy(index_file_name, file_name);
+	strcat(index_file_name, FILE_EXTENSION);
+
+	return index_file_name;
+}
+
+/* the same 8-byte little-endian encoding as in LineIndex */
+void InflateIndex::write_number(ofstream& ofile_stream, uint64_t value) {
+	unsigned char bytes[8];
+
+	for (unsigned int i = 0u; i < 8u; i++) {
+		bytes[i] = (unsigned char)(value & 0xffu);
+		value >>= 8;
+	}
+
+	ofile_stream.write((const char*)bytes, 8);
+}
+
+bool InflateIndex::read_number(ifstream& ifile_stream, uint64_t* value) {
+	unsigned char bytes[8];
+
+	ifile_stream.read((char*)bytes, 8);
+	if (ifile_stream.gcount() != 8) {
+		return false;
+	}
+
+	*value = 0u;
+	for (int i = 7; i >= 0; i--) {
+		*value = (*value << 8) | (uint64_t)bytes[i];
+	}
+
+	return true;
+}
+
+/* drops all checkpoints; new ones are appended while the file is inflated */
+void InflateIndex::start(const char* file_name, unsigned long int span) throw (ReaderException) {
+	struct stat file_stat;
+
+	if (file_name == NULL) {
+		throw ReaderException("InflateIndex", "start( const char*, unsigned long int )", __LINE__, 0, "file_name");
+	}
+
+	if (strlen(file_name) <= 0) {
+		throw ReaderException("InflateIndex", "start( const char*, unsigned long int )", __LINE__, 1, "file_name");
+	}
+
+	if (span < WINDOW_SIZE) {
+		throw ReaderException("InflateIndex", "start( const char*, unsigned long int )", __LINE__, 1, "span");
+	}
+
+	clear();
+	set_file(file_name);
+
+	if (stat(file_name, &file_stat) != 0) {
+		throw ReaderException("InflateIndex", "start( const char*, unsigned long int )", __LINE__, 3, file_name);
+	}
+
+	file_size = (uint64_t)file_stat.st_size;
+	modification_time = (long int)file_stat.st_mtime;
+
+	this->span = span;
+}
+
+/* checkpoints must come in increasing order of output_offset; window holds the last window_length (at most WINDOW_SIZE) inflated bytes */
+void InflateIndex::add_checkpoint(uint64_t output_offset, uint64_t input_offset, unsigned int bits, const unsigned char* window, unsigned int window_length) throw (ReaderException) {
+	checkpoint new_checkpoint;
+
+	if ((window == NULL) && (window_length > 0u)) {
+		throw ReaderException("InflateIndex", "add_checkpoint( uint64_t, uint64_t, unsigned int, const unsigned char*, unsigned int )", __LINE__, 0, "window");
+	}
+
+	if ((window_length > WINDOW_SIZE) || (bits > 7u)) {
+		throw ReaderException("InflateIndex", "add_checkpoint( uint64_t, uint64_t, unsigned int, const unsigned char*, unsigned int )", __LINE__, 1, "checkpoint");
+	}
+
+	if ((checkpoints.size() > 0u) && (output_offset <= checkpoints.back().output_offset)) {
+		throw ReaderException("InflateIndex", "add_checkpoint( uint64_t, uint64_t, unsigned int, const unsigned char*, unsigned int )", __LINE__, 1, "output_offset");
+	}
+
+	new_checkpoint.output_offset = output_offset;
+	new_checkpoint.input_offset = input_offset;
+	new_checkpoint.bits = bits;
+	new_checkpoint.window_length = window_length;
+	new_checkpoint.window = (unsigned char*)malloc((window_length > 0u ? window_length : 1u) * sizeof(unsigned char));
+	if (new_checkpoint.window == NULL) {
+		throw ReaderException("InflateIndex", "add_checkpoint( uint64_t, uint64_t, unsigned int, const unsigned char*, unsigned int )", __LINE__, 2, window_length * sizeof(unsigned char));
+	}
+
+	if (window_length > 0u) {
+		memcpy(new_checkpoint.window, window, window_length);
+	}
+
+	checkpoints.push_back(new_checkpoint);
+}
+
+/* returns false when there is no index next to the file or when the file was modified after the index was built */
+bool InflateIndex::load(const char* file_name) throw (ReaderException) {
+	ifstream ifile_stream;
+	char* index_file_name = NULL;
+	char magic[sizeof(MAGIC)];
+	uint64_t version = 0u;
+	uint64_t checkpoints_number = 0u;
+	uint64_t value = 0u;
+	checkpoint new_checkpoint;
+	bool loaded = true;
+
+	if (file_name == NULL) {
+		throw ReaderException("InflateIndex", "load( const char* )", __LINE__, 0, "file_name");
+	}
+
+	if (strlen(file_name) <= 0) {
+		throw ReaderException("InflateIndex", "load( const char* )", __LINE__, 1, "file_name");
+	}
+
+	clear();
+	set_file(file_name);
+
+	index_file_name = get_index_file_name();
+
+	ifile_stream.open(index_file_name, ios::binary);
+	free(index_file_name);
+
+	if (ifile_stream.fail()) {
+		clear();
+		return false;
+	}
+
+	ifile_stream.read(magic, sizeof(MAGIC));
+	if ((ifile_stream.gcount() != (streamsize)sizeof(MAGIC)) || (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)) {
+		loaded = false;
+	}
+
+	loaded = loaded && read_number(ifile_stream, &version) && (version == FORMAT_VERSION);
+	loaded = loaded && read_number(ifile_stream, &file_size);
+	loaded = loaded && read_number(ifile_stream, &value);
+	loaded = loaded && read_number(ifile_stream, &value) && ((span = (unsigned long int)value) >= WINDOW_SIZE);
+	loaded = loaded && read_number(ifile_stream, &checkpoints_number);
+
+	if (loaded) {
+		modification_time = (long int)value;
+		for (uint64_t i = 0u; i < checkpoints_number; i++) {
+			loaded = read_number(ifile_stream, &new_checkpoint.output_offset);
+			loaded = loaded && read_number(ifile_stream, &new_checkpoint.input_offset);
+			loaded = loaded && read_number(ifile_stream, &value) && (value <= 7u);
+			new_checkpoint.bits = (unsigned int)value;
+			loaded = loaded && read_number(ifile_stream, &value) && (value <= WINDOW_SIZE);
+			new_checkpoint.window_length = (unsigned int)value;
+			loaded = loaded && ((checkpoints.size() == 0u) || (new_checkpoint.output_offset > checkpoints.back().output_offset));
+			if (!loaded) {
+				break;
+			}
+
+			new_checkpoint.window = (unsigned char*)malloc((new_checkpoint.window_length > 0u ? new_checkpoint.window_length : 1u) * sizeof(unsigned char));
+			if (new_checkpoint.window == NULL) {
+				ifile_stream.close();
+				clear();
+				throw ReaderException("InflateIndex", "load( const char* )", __LINE__, 2, new_checkpoint.window_length * sizeof(unsigned char));
+			}
+			checkpoints.push_back(new_checkpoint);
+
+			ifile_stream.read((char*)new_checkpoint.window, new_checkpoint.window_length);
+			if (ifile_stream.gcount() != (streamsize)new_checkpoint.window_length) {
+				loaded = false;
+				break;
+			}
+		}
+	}
+
+	ifile_stream.close();
+
+	if (!loaded || !is_current(file_name)) {
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+void InflateIndex::save() throw (ReaderException) {
+	ofstream ofile_stream;
+	char* index_file_name = NULL;
+
+	if (file_name == NULL) {
+		throw ReaderException("InflateIndex", "save()", __LINE__, 0, "file_name");
+	}
+
+	index_file_name = get_index_file_name();
+
+	ofile_stream.open(index_file_name, ios::binary | ios::trunc);
+	if (ofile_stream.fail()) {
+		ReaderException e("InflateIndex", "save()", __LINE__, 3, index_file_name);
+		free(index_file_name);
+		throw e;
+	}
+
+	ofile_stream.write(MAGIC, sizeof(MAGIC));
+	write_number(ofile_stream, FORMAT_VERSION);
+	write_number(ofile_stream, file_size);
+	write_number(ofile_stream, (uint64_t)modification_time);
+	write_number(ofile_stream, span);
+	write_number(ofile_stream, checkpoints.size());
+
+	for (vector<checkpoint>::iterator checkpoints_it = checkpoints.begin(); checkpoints_it != checkpoints.end(); checkpoints_it++) {
+		write_number(ofile_stream, checkpoints_it->output_offset);
+		write_number(ofile_stream, checkpoints_it->input_offset);
+		write_number(ofile_stream, checkpoints_it->bits);
+		write_number(ofile_stream, checkpoints_it->window_length);
+		ofile_stream.write((const char*)checkpoints_it->window, checkpoints_it->window_length);
+	}
+
+	ofile_stream.close();
+
+	if (ofile_stream.fail()) {
+		ReaderException e("InflateIndex", "save()", __LINE__, 11, index_file_name);
+		free(index_file_name);
+		throw e;
+	}
+
+	free(index_file_name);
+}
+
+bool InflateIndex::is_current(const char* file_name) {
+	struct stat file_stat;
+
+	if ((this->file_name == NULL) || (file_name == NULL) || (strcmp(this->file_name, file_name) != 0)) {
+		return false;
+	}
+
+	if (stat(file_name, &file_stat) != 0) {
+		return false;
+	}
+
+	return ((uint64_t)file_stat.st_size == file_size) && ((long int)file_stat.st_mtime == modification_time);
+}
+
+/* the last checkpoint at or before the uncompressed position, or -1 when inflating has to start from the beginning */
+long int InflateIndex::find_checkpoint(uint64_t position) {
+	long int low = 0l;
+	long int high = (long int)checkpoints.size() - 1l;
+	long int middle = 0l;
+	long int found = -1l;
+
+	while (low <= high) {
+		middle = low + (high - low) / 2l;
+		if (checkpoints[middle].output_offset <= position) {
+			found = middle;
+			low = middle + 1l;
+		} else {
+			high = middle - 1l;
+		}
+	}
+
+	return found;
+}
+
+const char* InflateIndex::get_file_name() {
+	return file_name;
+}
+
+unsigned long int InflateIndex::get_span() {
+	return span;
+}
+
+unsigned long int InflateIndex::get_checkpoints_number() {
+	return checkpoints.size();
+}
+
+uint64_t InflateIndex::get_output_offset(unsigned long int checkpoint) throw (ReaderException) {
+	if (checkpoint >= checkpoints.size()) {
+		throw ReaderException("InflateIndex", "get_output_offset( unsigned long int )", __LINE__, 1, "checkpoint");
+	}
+
+	return checkpoints[checkpoint].output_offset;
+}
+
+/* compressed offset of the first byte that inflate did not consume before the checkpoint */
+uint64_t InflateIndex::get_input_offset(unsigned long int checkpoint) throw (ReaderException) {
+	if (checkpoint >= checkpoints.size()) {
+		throw ReaderException("InflateIndex", "get_input_offset( unsigned long int )", __LINE__, 1, "checkpoint");
+	}
+
+	return checkpoints[checkpoint].input_offset;
+}
+
+/* number of unused bits left in the byte just before the input offset */
+unsigned int InflateIndex::get_bits(unsigned long int checkpoint) throw (ReaderException) {
+	if (checkpoint >= checkpoints.size()) {
+		throw ReaderException("InflateIndex", "get_bits( unsigned long int )", __LINE__, 1, "checkpoint");
+	}
+
+	return checkpoints[checkpoint].bits;
+}
+
+const unsigned char* InflateIndex::get_window(unsigned long int checkpoint) throw (ReaderException) {
+	if (checkpoint >= checkpoints.size()) {
+		throw ReaderException("InflateIndex", "get_window( unsigned long int )", __LINE__, 1, "checkpoint");
+	}
+
+	return checkpoints[checkpoint].window;
+}
+
+unsigned int InflateIndex::get_window_length(unsigned long int checkpoint) throw (ReaderException) {
+	if (checkpoint >= checkpoints.size()) {
+		throw ReaderException("InflateIndex", "get_window_length( unsigned long int )", __LINE__, 1, "checkpoint");
+	}
+
+	return checkpoints[checkpoint].window_length;
+}
@@ -0,0 +1,336 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "include/LineIndex.h"
+
+const char* LineIndex::FILE_EXTENSION = ".gwi";
+const char LineIndex::MAGIC[] = {'G', 'W', 'I', '\0'};
+const unsigned long int LineIndex::FORMAT_VERSION = 1ul;
+const unsigned long int LineIndex::DEFAULT_INTERVAL = 16384ul;
+
+LineIndex::LineIndex() : file_name(NULL) {
+	clear();
+}
+
+LineIndex::~LineIndex() {
+	clear();
+}
+
+void LineIndex::clear() {
+	free(file_name);
+	file_name = NULL;
+
+	file_size = 0u;
+	modification_time = 0l;
+
+	interval = DEFAULT_INTERVAL;
+	lines_count = 0ul;
+	offsets.clear();
+}
+
+char* LineIndex::get_index_file_name() throw (ReaderException) {
+	char* index_file_name = NULL;
+
+	index_file_name = (char*)malloc((strlen(file_name) + strlen(FILE_EXTENSION) + 1u) * sizeof(char));
+	if (index_file_name == NULL) {
+		throw ReaderException("LineIndex", "get_index_file_name()", __LINE__, 2, (strlen(file_name) + strlen(FILE_EXTENSION) + 1u) * sizeof(char));
+	}
+
+	strcpy(index_file_name, file_name);
+	strcat(index_file_name, FILE_EXTENSION);
+
+	return index_file_name;
+}
+
+/* numbers are stored as 8 bytes in little-endian order, independently of the platform */
+void LineIndex::write_number(ofstream& ofile_stream, uint64_t value) {
+	unsigned char bytes[8];
+
+	for (unsigned int i = 0u; i < 8u; i++) {
+		bytes[i] = (unsigned char)(value & 0xffu);
+		value >>= 8;
+	}
+
+	ofile_stream.write((const char*)bytes, 8);
+}
+
+bool LineIndex::read_number(ifstream& ifile_stream, uint64_t* value) {
+	unsigned char bytes[8];
+
+	ifile_stream.read((char*)bytes, 8);
+	if (ifile_stream.gcount() != 8) {
+		return false;
+	}
+
+	*value = 0u;
+	for (int i = 7; i >= 0; i--) {
+		*value = (*value << 8) | (uint64_t)bytes[i];
+	}
+
+	return true;
+}
+
+/* starts an empty index, which is then filled by add_line() during a pass through the file */
+void LineIndex::start(const char* file_name, unsigned long int interval) throw (ReaderException) {
+	struct stat file_stat;
+
+	if (file_name == NULL) {
+		throw ReaderException("LineIndex", "start( const char*, unsigned long int )", __LINE__, 0, "file_name");
+	}
+
+	if (strlen(file_name) <= 0) {
+		throw ReaderException("LineIndex", "start( const char*, unsigned long int )", __LINE__, 1, "file_name");
+	}
+
+	if (interval <= 0ul) {
+		throw ReaderException("LineIndex", "start( const char*, unsigned long int )", __LINE__, 1, "interval");
+	}
+
+	clear();
+
+	this->file_name = (char*)malloc((strlen(file_name) + 1u) * sizeof(char));
+	if (this->file_name == NULL) {
+		throw ReaderException("LineIndex", "start( const char*, unsigned long int )", __LINE__, 2, (strlen(file_name) + 1u) * sizeof(char));
+	}
+	strcpy(this->file_name, file_name);
+
+	if (stat(file_name, &file_stat) != 0) {
+		throw ReaderException("LineIndex", "start( const char*, unsigned long int )", __LINE__, 3, file_name);
+	}
+
+	file_size = (uint64_t)file_stat.st_size;
+	modification_time = (long int)file_stat.st_mtime;
+
+	this->interval = interval;
+}
+
+/* offset of the line that was just read; lines must be added in order, starting from the first one */
+void LineIndex::add_line(uint64_t offset) {
+	if (lines_count % interval == 0ul) {
+		offsets.push_back(offset);
+	}
+
+	lines_count += 1ul;
+}
+
+/* reader must be opened on the same file; it is left positioned at the first line */
+void LineIndex::build(const char* file_name, Reader* reader, unsigned long int interval) throw (ReaderException) {
+	uint64_t position = 0u;
+
+	if (reader == NULL) {
+		throw ReaderException("LineIndex", "build( const char*, Reader*, unsigned long int )", __LINE__, 0, "reader");
+	}
+
+	start(file_name, interval);
+
+	if (!reader->is_seekable()) {
+		throw ReaderException("LineIndex", "build( const char*, Reader*, unsigned long int )", __LINE__, 12, file_name);
+	}
+
+	reader->seek(0u);
+
+	while (true) {
+		position = reader->tell();
+
+		if (reader->read_line() < 0) {
+			break;
+		}
+
+		add_line(position);
+	}
+
+	reader->seek(0u);
+}
+
+/* returns false when there is no index next to the file or when the file was modified after the index was built */
+bool LineIndex::load(const char* file_name) throw (ReaderException) {
+	ifstream ifile_stream;
+	char* index_file_name = NULL;
+	char magic[sizeof(MAGIC)];
+	uint64_t version = 0u;
+	uint64_t checkpoints_number = 0u;
+	uint64_t value = 0u;
+	uint64_t offset = 0u;
+	bool loaded = true;
+
+	if (file_name == NULL) {
+		throw ReaderException("LineIndex", "load( const char* )", __LINE__, 0, "file_name");
+	}
+
+	if (strlen(file_name) <= 0) {
+		throw ReaderException("LineIndex", "load( const char* )", __LINE__, 1, "file_name");
+	}
+
+	clear();
+
+	this->file_name = (char*)malloc((strlen(file_name) + 1u) * sizeof(char));
+	if (this->file_name == NULL) {
+		throw ReaderException("LineIndex", "load( const char* )", __LINE__, 2, (strlen(file_name) + 1u) * sizeof(char));
+	}
+	strcpy(this->file_name, file_name);
+
+	index_file_name = get_index_file_name();
+
+	ifile_stream.open(index_file_name, ios::binary);
+	free(index_file_name);
+
+	if (ifile_stream.fail()) {
+		clear();
+		return false;
+	}
+
+	ifile_stream.read(magic, sizeof(MAGIC));
+	if ((ifile_stream.gcount() != (streamsize)sizeof(MAGIC)) || (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)) {
+		loaded = false;
+	}
+
+	loaded = loaded && read_number(ifile_stream, &version) && (version == FORMAT_VERSION);
+	loaded = loaded && read_number(ifile_stream, &file_size);
+	loaded = loaded && read_number(ifile_stream, &offset);
+	loaded = loaded && read_number(ifile_stream, &value) && ((interval = (unsigned long int)value) > 0ul);
+	loaded = loaded && read_number(ifile_stream, &value);
+	loaded = loaded && read_number(ifile_stream, &checkpoints_number) && (checkpoints_number == ((lines_count = (unsigned long int)value) + interval - 1ul) / interval);
+
+	if (loaded) {
+		modification_time = (long int)offset;
+		offsets.reserve(checkpoints_number);
+		for (uint64_t i = 0u; i < checkpoints_number; i++) {
+			if (!read_number(ifile_stream, &offset)) {
+				loaded = false;
+				break;
+			}
+			offsets.push_back(offset);
+		}
+	}
+
+	ifile_stream.close();
+
+	if (!loaded || !is_current(file_name)) {
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+void LineIndex::save() throw (ReaderException) {
+	ofstream ofile_stream;
+	char* index_file_name = NULL;
+
+	if (file_name == NULL) {
+		throw ReaderException("LineIndex", "save()", __LINE__, 0, "file_name");
+	}
+
+	index_file_name = get_index_file_name();
+
+	ofile_stream.open(index_file_name, ios::binary | ios::trunc);
+	if (ofile_stream.fail()) {
+		ReaderException e("LineIndex", "save()", __LINE__, 3, index_file_name);
+		free(index_file_name);
+		throw e;
+	}
+
+	ofile_stream.write(MAGIC, sizeof(MAGIC));
+	write_number(ofile_stream, FORMAT_VERSION);
+	write_number(ofile_stream, file_size);
+	write_number(ofile_stream, (uint64_t)modification_time);
+	write_number(ofile_stream, interval);
+	write_number(ofile_stream, lines_count);
+	write_number(ofile_stream, offsets.size());
+
+	for (vector<uint64_t>::iterator offsets_it = offsets.begin(); offsets_it != offsets.end(); offsets_it++) {
+		write_number(ofile_stream, *offsets_it);
+	}
+
+	ofile_stream.close();
+
+	if (ofile_stream.fail()) {
+		ReaderException e("LineIndex", "save()", __LINE__, 11, index_file_name);
+		free(index_file_name);
+		throw e;
+	}
+
+	free(index_file_name);
+}
+
+bool LineIndex::is_current(const char* file_name) {
+	struct stat file_stat;
+
+	if ((this->file_name == NULL) || (file_name == NULL) || (strcmp(this->file_name, file_name) != 0)) {
+		return false;
+	}
+
+	if (stat(file_name, &file_stat) != 0) {
+		return false;
+	}
+
+	return ((uint64_t)file_stat.st_size == file_size) && ((long int)file_stat.st_mtime == modification_time);
+}
+
+/* positions reader so that the next read_line() returns the given line (0-based, header included) */
+void LineIndex::seek_line(Reader* reader, unsigned long int line) throw (ReaderException) {
+	unsigned long int skip = 0ul;
+
+	if (reader == NULL) {
+		throw ReaderException("LineIndex", "seek_line( Reader*, unsigned long int )", __LINE__, 0, "reader");
+	}
+
+	if (line > lines_count) {
+		throw ReaderException("LineIndex", "seek_line( Reader*, unsigned long int )", __LINE__, 1, "line");
+	}
+
+	if (line == lines_count) {
+		reader->seek(offsets.size() > 0u ? offsets.back() : 0u);
+		skip = lines_count - (offsets.size() > 0u ? (offsets.size() - 1u) * interval : 0ul);
+	} else {
+		reader->seek(offsets[line / interval]);
+		skip = line % interval;
+	}
+
+	while (skip > 0ul) {
+		if (reader->read_line() < 0) {
+			throw ReaderException("LineIndex", "seek_line( Reader*, unsigned long int )", __LINE__, 6, file_name);
+		}
+		skip -= 1ul;
+	}
+}
+
+const char* LineIndex::get_file_name() {
+	return file_name;
+}
+
+unsigned long int LineIndex::get_interval() {
+	return interval;
+}
+
+unsigned long int LineIndex::get_lines_count() {
+	return lines_count;
+}
+
+unsigned long int LineIndex::get_checkpoints_number() {
+	return offsets.size();
+}
+
+/* byte offset (uncompressed for gzip files) of line checkpoint * get_interval() */
+uint64_t LineIndex::get_offset(unsigned long int checkpoint) throw (ReaderException) {
+	if (checkpoint >= offsets.size()) {
+		throw ReaderException("LineIndex", "get_offset( unsigned long int )", __LINE__, 1, "checkpoint");
+	}
+
+	return offsets[checkpoint];
+}
@@ -0,0 +1,276 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/MmapReader.h"
+
+#ifndef WIN32
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+const unsigned int MmapReader::DEFAULT_BUFFER_SIZE = 65536;
+const unsigned long int MmapReader::SCAN_SIZE = 1048576;
+
+MmapReader::MmapReader(unsigned int buffer_size) throw (ReaderException) : Reader(&buffer),
+	map(NULL), map_end(NULL), position(NULL), next_lf(NULL), next_cr(NULL), opened(false),
+	buffer_size(buffer_size), buffer(NULL) {
+	if (buffer_size <= 0) {
+		throw ReaderException("MmapReader", "MmapReader( int )", __LINE__, 1, "buffer_size");
+	}
+
+	buffer = (char*)malloc((buffer_size + 1) * sizeof(char));
+	if (buffer == NULL) {
+		throw ReaderException("MmapReader", "MmapReader( int )", __LINE__, 2, (buffer_size + 1) * sizeof(char));
+	}
+
+	buffer[0] = '\0';
+}
+
+MmapReader::~MmapReader() {
+	if (opened) {
+		if (map != NULL) {
+			munmap(map, map_end - map);
+		}
+		opened = false;
+	}
+
+	map = NULL;
+	map_end = NULL;
+	position = NULL;
+
+	buffer_size = 0;
+
+	free(buffer);
+	buffer = NULL;
+}
+
+void MmapReader::open() throw (ReaderException) {
+	int file_descriptor = -1;
+	struct stat file_stat;
+
+	close();
+
+	if ((file_descriptor = ::open(file_name, O_RDONLY)) < 0) {
+		throw ReaderException("MmapReader", "open()", __LINE__, 3, file_name);
+	}
+
+	if (fstat(file_descriptor, &file_stat) != 0) {
+		::close(file_descriptor);
+		throw ReaderException("MmapReader", "open()", __LINE__, 10, file_name);
+	}
+
+	if (file_stat.st_size > 0) {
+		map = (char*)mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+		if (map == MAP_FAILED) {
+			map = NULL;
+			::close(file_descriptor);
+			throw ReaderException("MmapReader", "open()", __LINE__, 10, file_name);
+		}
+
+		madvise(map, file_stat.st_size, MADV_SEQUENTIAL);
+		map_end = map + file_stat.st_size;
+	}
+
+	if (::close(file_descriptor) != 0) {
+		throw ReaderException("MmapReader", "open()", __LINE__, 5, file_name);
+	}
+
+	position = map;
+	next_lf = NULL;
+	next_cr = NULL;
+	opened = true;
+
+	buffer[0] = '\0';
+}
+
+void MmapReader::close() throw (ReaderException) {
+	if (opened) {
+		if (map != NULL) {
+			if (munmap(map, map_end - map) != 0) {
+				throw ReaderException("MmapReader", "close()", __LINE__, 5, file_name);
+			}
+		}
+
+		map = NULL;
+		map_end = NULL;
+		position = NULL;
+		next_lf = NULL;
+		next_cr = NULL;
+		opened = false;
+	}
+
+	buffer[0] = '\0';
+}
+
+char* MmapReader::find_next(char character, char* cached, char* search_end) {
+	char* scan_start = position;
+	char* scan_end = NULL;
+
+	if ((cached != NULL) && (cached >= position)) {
+		if ((cached >= search_end) || (*cached == character)) {
+			return cached;
+		}
+		scan_start = cached;
+	}
+
+	scan_end = ((unsigned long int)(map_end - scan_start) > SCAN_SIZE) ? scan_start + SCAN_SIZE : map_end;
+	if (scan_end < search_end) {
+		scan_end = search_end;
+	}
+
+	if ((cached = (char*)memchr(scan_start, character, scan_end - scan_start)) == NULL) {
+		cached = scan_end;
+	}
+
+	return cached;
+}
+
+bool MmapReader::grow_buffer() throw (ReaderException) {
+	unsigned int new_buffer_size = 0u;
+	char* new_buffer = NULL;
+
+	if ((unsigned int)buffer_size >= MAX_BUFFER_SIZE) {
+		return false;
+	}
+
+	new_buffer_size = ((unsigned int)buffer_size > MAX_BUFFER_SIZE / 2u) ? MAX_BUFFER_SIZE : 2u * buffer_size;
+
+	new_buffer = (char*)realloc(buffer, (new_buffer_size + 1u) * sizeof(char));
+	if (new_buffer == NULL) {
+		throw ReaderException("MmapReader", "grow_buffer()", __LINE__, 2, (new_buffer_size + 1u) * sizeof(char));
+	}
+
+	buffer = new_buffer;
+	buffer_size = new_buffer_size;
+
+	return true;
+}
+
+int MmapReader::read_line() throw (ReaderException) {
+	char* search_end = NULL;
+	char* line_end = NULL;
+	int length = 0;
+
+	if (position >= map_end) {
+		buffer[0] = '\0';
+		return -1;
+	}
+
+	while (true) {
+		search_end = ((map_end - position) > buffer_size) ? position + buffer_size : map_end;
+
+		next_lf = find_next('\n', next_lf, search_end);
+		next_cr = find_next('\r', next_cr, search_end);
+
+		line_end = (next_lf < next_cr) ? next_lf : next_cr;
+		if ((line_end < search_end) || (search_end >= map_end) || (!grow_buffer())) {
+			break;
+		}
+	}
+
+	if (line_end > search_end) {
+		line_end = search_end;
+	}
+
+	length = line_end - position;
+	memcpy(buffer, position, length);
+	buffer[length] = '\0';
+
+	position = line_end;
+
+	if (line_end < search_end) {
+		position += 1;
+		if ((*line_end == '\r') && (position < map_end) && (*position == '\n')) {
+			position += 1;
+		}
+	}
+
+	return length;
+}
+
+void MmapReader::reset() throw (ReaderException) {
+	if (opened) {
+		position = map;
+		next_lf = NULL;
+		next_cr = NULL;
+	}
+}
+
+bool MmapReader::eof() {
+	return opened && (position >= map_end);
+}
+
+bool MmapReader::sof() {
+	return opened && (position == map);
+}
+
+bool MmapReader::is_open() {
+	return opened;
+}
+
+bool MmapReader::is_compressed() {
+	return false;
+}
+
+int MmapReader::get_buffer_size() {
+	return buffer_size;
+}
+
+bool MmapReader::is_seekable() {
+	return true;
+}
+
+uint64_t MmapReader::tell() throw (ReaderException) {
+	return position - map;
+}
+
+void MmapReader::seek(uint64_t position) throw (ReaderException) {
+	if ((!opened) || (position > (uint64_t)(map_end - map))) {
+		throw ReaderException("MmapReader", "seek( uint64_t )", __LINE__, 6, file_name);
+	}
+
+	this->position = map + position;
+	next_lf = NULL;
+	next_cr = NULL;
+
+	buffer[0] = '\0';
+}
+
+unsigned long int MmapReader::estimate_lines_count() throw (ReaderException) {
+	unsigned long int lines_count = 0ul;
+	bool pending_cr = false;
+
+	open();
+
+	if (map != NULL) {
+		lines_count = count_line_ends(map, map_end - map, &pending_cr);
+		if ((*(map_end - 1) != '\n') && (*(map_end - 1) != '\r')) {
+			lines_count += 1ul;
+		}
+	}
+
+	close();
+
+	return lines_count > 0ul ? lines_count - 1ul : 0ul;
+}
+
+#endif
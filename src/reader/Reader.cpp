@@ -18,14 +18,27 @@
  */
 
 #include "include/Reader.h"
+#include "include/RegionIndex.h"
 
-Reader::Reader(char** buffer) : file_name(NULL), line(buffer) {
+const int Reader::SEPARATORS_NUMBER;
+const char Reader::separators[] = {',', '\t', ' ' , ';'};
+const unsigned int Reader::TOP_ROWS_NUMBER = 10;
+const unsigned int Reader::MAX_BUFFER_SIZE = 1073741824;
+
+Reader::Reader(char** buffer) : file_name(NULL), quoted(false),
+	region_index(NULL), region_chromosome(NULL), region_start(0ul), region_end(0ul), region_active(false), region_chromosome_seen(false), line(buffer) {
 
 }
 
 Reader::~Reader() {
 	free(file_name);
 	file_name = NULL;
+
+	delete region_index;
+	region_index = NULL;
+
+	free(region_chromosome);
+	region_chromosome = NULL;
 }
 
 void Reader::set_file_name(const char* file_name) throw (ReaderException) {
@@ -39,6 +52,11 @@ void Reader::set_file_name(const char* file_name) throw (ReaderException) {
 
 	free(this->file_name);
 	this->file_name = NULL;
+
+	delete region_index;
+	region_index = NULL;
+	region_active = false;
+
 	this->file_name = (char*)malloc((strlen(file_name) + 1) * sizeof(char));
 	if (this->file_name == NULL) {
 		throw ReaderException("Reader", "set_file_name( const char* )", __LINE__, 2, (strlen(file_name) + 1) * sizeof(char));
@@ -50,10 +68,365 @@ const char* Reader::get_file_name() {
 	return file_name;
 }
 
+/* known only after detect_field_separators() */
+bool Reader::is_quoted() {
+	return quoted;
+}
+
+/* a CR closing the previous chunk is reported through pending_cr, so that a CRLF split between chunks counts once */
+unsigned long int Reader::count_line_ends(const char* data, unsigned long int size, bool* pending_cr) {
+	unsigned long int lf_count = 0ul;
+	unsigned long int cr_count = 0ul;
+	unsigned long int crlf_count = 0ul;
+	const char* end = data + size;
+	const char* cr = data;
+
+	if (size == 0ul) {
+		return 0ul;
+	}
+
+	lf_count = auxiliary::memcount(data, size, '\n');
+	cr_count = auxiliary::memcount(data, size, '\r');
+
+	if ((*pending_cr) && (data[0] == '\n')) {
+		crlf_count += 1ul;
+	}
+
+	if ((lf_count > 0ul) && (cr_count > 0ul)) {
+		while ((cr = (const char*)memchr(cr, '\r', end - cr)) != NULL) {
+			cr += 1;
+			if ((cr < end) && (*cr == '\n')) {
+				crlf_count += 1ul;
+			}
+		}
+	}
+
+	*pending_cr = (data[size - 1] == '\r');
+
+	return lf_count + cr_count - crlf_count;
+}
+
 unsigned long int Reader::estimate_lines_count() throw (ReaderException) {
 	return 0;
 }
 
+bool Reader::is_seekable() {
+	return false;
+}
+
+uint64_t Reader::tell() throw (ReaderException) {
+	throw ReaderException("Reader", "tell()", __LINE__, 12, file_name);
+}
+
+void Reader::seek(uint64_t position) throw (ReaderException) {
+	throw ReaderException("Reader", "seek( uint64_t )", __LINE__, 12, file_name);
+}
+
+/* offset of a BGZF block in the file shifted by 16 bits, plus the offset within the uncompressed block */
+void Reader::seek_virtual(uint64_t offset) throw (ReaderException) {
+	throw ReaderException("Reader", "seek_virtual( uint64_t )", __LINE__, 12, file_name);
+}
+
+/* readers without a read-ahead thread ignore it */
+void Reader::set_read_ahead_depth(unsigned int buffers_number) {
+
+}
+
+/* only readers that keep their own seek data (e.g. inflate checkpoints) write it next to the file */
+void Reader::save_checkpoints() throw (ReaderException) {
+
+}
+
+/* a quote opens a field only at the line start or right after a separator; separators inside quoted fields are not counted */
+/* returns true if the line has quoted fields; if one of them is not well formed, *malformed is set and all separators are counted */
+bool Reader::count_separators(const char* line, int line_length, int* tokens_number, bool* malformed) {
+	int char_position = 0;
+	bool quotes = false;
+	bool field_start = true;
+	int i = 0;
+
+	for (i = 0; i < SEPARATORS_NUMBER; i++) {
+		tokens_number[i] = 0;
+	}
+
+	while (char_position < line_length) {
+		if (field_start && (line[char_position] == '"')) {
+			char_position += 1;
+			while ((char_position < line_length) && ((line[char_position] != '"') || ((char_position + 1 < line_length) && (line[char_position + 1] == '"')))) {
+				char_position += (line[char_position] == '"') ? 2 : 1;
+			}
+
+			char_position += 1;
+			if (char_position > line_length) {
+				break;
+			}
+
+			for (i = 0; (char_position < line_length) && (i < SEPARATORS_NUMBER); i++) {
+				if (line[char_position] == separators[i]) {
+					break;
+				}
+			}
+
+			if (i >= SEPARATORS_NUMBER) {
+				break;
+			}
+
+			quotes = true;
+			field_start = false;
+			continue;
+		}
+
+		field_start = false;
+		for (i = 0; i < SEPARATORS_NUMBER; i++) {
+			if (line[char_position] == separators[i]) {
+				tokens_number[i] += 1;
+				field_start = true;
+			}
+		}
+		char_position += 1;
+	}
+
+	if (char_position != line_length) {
+		*malformed = true;
+
+		for (i = 0; i < SEPARATORS_NUMBER; i++) {
+			tokens_number[i] = 0;
+		}
+
+		for (char_position = 0; char_position < line_length; char_position++) {
+			for (i = 0; i < SEPARATORS_NUMBER; i++) {
+				if (line[char_position] == separators[i]) {
+					tokens_number[i] += 1;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	return quotes;
+}
+
+bool Reader::choose_separators(const int* header_tokens_number, const int* row_tokens_number, bool data_was_read, char* header_separator, char* data_separator) {
+	int header_separator_index = -1;
+	int data_separator_index = -1;
+	unsigned int matches = 0;
+	int i = 0, j = 0;
+
+	if (data_was_read) {
+		for (i = 0; i < SEPARATORS_NUMBER; i++) {
+			for (j = 0; j < SEPARATORS_NUMBER; j++) {
+				if ((header_tokens_number[i] == row_tokens_number[j]) && (header_tokens_number[i] > 0)) {
+					header_separator_index = i;
+					data_separator_index = j;
+					matches += 1;
+				}
+			}
+		}
+	} else {
+		for (i = 0; i < SEPARATORS_NUMBER; i++) {
+			if (header_tokens_number[i] > 0) {
+				header_separator_index = i;
+				data_separator_index = i;
+				matches += 1;
+			}
+		}
+	}
+
+	if (matches < 1) {
+		for (i = 0; i < SEPARATORS_NUMBER; i++) {
+			if ((header_tokens_number[i] != 0) || (row_tokens_number[i] != 0)) {
+				return false;
+			}
+		}
+	} else if (matches > 1) {
+		return false;
+	} else {
+		*header_separator = separators[header_separator_index];
+		*data_separator = separators[data_separator_index];
+	}
+
+	return true;
+}
+
+/* tokens are counted in the header and in the top rows read from the current position */
+void Reader::inspect_top_rows(int* header_tokens_number, int* row_tokens_number, bool* header_was_read, bool* data_was_read) throw (ReaderException) {
+	int tokens_number[SEPARATORS_NUMBER];
+	unsigned int rows_read = 0;
+	bool malformed = false;
+
+	int line_length = 0;
+	int i = 0;
+
+	for (i = 0; i < SEPARATORS_NUMBER; i++) {
+		header_tokens_number[i] = 0;
+		row_tokens_number[i] = 0;
+	}
+
+	*header_was_read = false;
+	*data_was_read = false;
+	quoted = false;
+
+	while ((!*header_was_read) && ((line_length = read_line()) >= 0)) {
+		if (line_length > 0) {
+			*header_was_read = true;
+			quoted |= count_separators(*line, line_length, header_tokens_number, &malformed);
+		}
+	}
+
+	while ((!*data_was_read) && ((line_length = read_line()) >= 0)) {
+		if (line_length > 0) {
+			*data_was_read = true;
+			quoted |= count_separators(*line, line_length, row_tokens_number, &malformed);
+		}
+	}
+
+	while ((rows_read < TOP_ROWS_NUMBER) && ((line_length = read_line()) >= 0)) {
+		if (line_length > 0) {
+			quoted |= count_separators(*line, line_length, tokens_number, &malformed);
+			for (i = 0; i < SEPARATORS_NUMBER; i++) {
+				if (row_tokens_number[i] != tokens_number[i]) {
+					row_tokens_number[i] = numeric_limits<int>::min();
+				}
+			}
+			rows_read += 1;
+		}
+	}
+
+	quoted = quoted && !malformed;
+}
+
 void Reader::detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException) {
+	int header_tokens_number[SEPARATORS_NUMBER];
+	int row_tokens_number[SEPARATORS_NUMBER];
+
+	bool header_was_read = false;
+	bool data_was_read = false;
+
+	if (header_separator == NULL) {
+		throw ReaderException("Reader", "detect_field_separators( char*, char* )", __LINE__, 0, "header_separator");
+	}
+
+	if (data_separator == NULL) {
+		throw ReaderException("Reader", "detect_field_separators( char*, char* )", __LINE__, 0, "data_separator");
+	}
+
+	open();
+
+	try {
+		inspect_top_rows(header_tokens_number, row_tokens_number, &header_was_read, &data_was_read);
+	} catch (ReaderException &e) {
+		e.add_message("Reader", "detect_field_separators( char*, char* )", __LINE__, 7, (const char*)file_name);
+		throw;
+	}
+
+	close();
+
+	if (header_was_read) {
+		if (!choose_separators(header_tokens_number, row_tokens_number, data_was_read, header_separator, data_separator)) {
+			throw ReaderException("Reader", "detect_field_separators( char*, char* )", __LINE__, 8, file_name);
+		}
+	}
+}
+
+/* returns the start of the column-th (1-based) field, or NULL if the line has fewer fields */
+const char* Reader::get_field(const char* line, int column, char separator, unsigned int* length) {
+	const char* end = NULL;
 
+	while (--column > 0) {
+		line = strchr(line, separator);
+		if (line == NULL) {
+			return NULL;
+		}
+		line += 1;
+	}
+
+	end = strchr(line, separator);
+	*length = end != NULL ? (unsigned int)(end - line) : (unsigned int)strlen(line);
+
+	return line;
+}
+
+/* positions the reader at the first indexed record that may fall into the 1-based closed interval [start, end];
+ * returns false if the file has no records in the interval */
+bool Reader::query_region(const char* chromosome, unsigned long int start, unsigned long int end) throw (ReaderException) {
+	uint64_t offset = 0u;
+
+	if (chromosome == NULL) {
+		throw ReaderException("Reader", "query_region( const char*, unsigned long int, unsigned long int )", __LINE__, 0, "chromosome");
+	}
+
+	if (region_index == NULL) {
+		region_index = new RegionIndex();
+		if (!region_index->load(file_name)) {
+			delete region_index;
+			region_index = NULL;
+			throw ReaderException("Reader", "query_region( const char*, unsigned long int, unsigned long int )", __LINE__, 15, file_name);
+		}
+	}
+
+	free(region_chromosome);
+	region_chromosome = (char*)malloc((strlen(chromosome) + 1u) * sizeof(char));
+	if (region_chromosome == NULL) {
+		throw ReaderException("Reader", "query_region( const char*, unsigned long int, unsigned long int )", __LINE__, 2, (strlen(chromosome) + 1u) * sizeof(char));
+	}
+	strcpy(region_chromosome, chromosome);
+
+	region_start = start;
+	region_end = end;
+	region_chromosome_seen = false;
+	region_active = region_index->find_offset(chromosome, start, end, &offset);
+
+	if (region_active) {
+		seek_virtual(offset);
+	}
+
+	return region_active;
+}
+
+/* reads the next line inside the region set by query_region(); returns 0 after the last one */
+int Reader::read_region_line() throw (ReaderException) {
+	const char* field = NULL;
+	unsigned int length = 0u;
+	unsigned long int position = 0ul;
+	int line_length = 0;
+
+	while (region_active && ((line_length = read_line()) >= 0)) {
+		if ((line_length == 0) || ((*line)[0] == region_index->get_meta())) {
+			continue;
+		}
+
+		field = get_field(*line, region_index->get_chromosome_column(), '\t', &length);
+		if ((field == NULL) || (strncmp(field, region_chromosome, length) != 0) || (region_chromosome[length] != '\0')) {
+			if (region_chromosome_seen) {
+				break;
+			}
+			continue;
+		}
+		region_chromosome_seen = true;
+
+		field = get_field(*line, region_index->get_position_column(), '\t', &length);
+		if (field == NULL) {
+			continue;
+		}
+
+		position = 0ul;
+		while ((length > 0u) && (*field >= '0') && (*field <= '9')) {
+			position = position * 10ul + (unsigned long int)(*field - '0');
+			field += 1;
+			length -= 1u;
+		}
+
+		if (position > region_end) {
+			break;
+		}
+
+		if (position >= region_start) {
+			return line_length;
+		}
+	}
+
+	region_active = false;
+
+	return 0;
 }
@@ -19,7 +19,7 @@
 
 #include "include/ReaderException.h"
 
-const int ReaderException::MESSAGE_TEMPLATES_NUMBER = 11;
+const int ReaderException::MESSAGE_TEMPLATES_NUMBER = 16;
 const char* ReaderException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
@@ -31,7 +31,12 @@ const char* ReaderException::MESSAGE_TEMPLATES[] = {
 /*07*/	"Error while inspecting lines in '%s' file.",
 /*08*/	"Failed to automatically detect the field separator in '%s' file.",
 /*09*/	"Error while getting the read position in '%s' file.",
-/*10*/	"Error while initializing reading facilities for '%s' file."
+/*10*/	"Error while initializing reading facilities for '%s' file.",
+/*11*/	"Error while writing '%s' file.",
+/*12*/	"Random access is not supported for '%s' file.",
+/*13*/	"The '%s' stream can be read only once.",
+/*14*/	"The header of '%s' shard doesn't match the header of '%s' shard.",
+/*15*/	"Neither a '.tbi' nor a '.csi' index was found for '%s' file."
 };
 
 ReaderException::ReaderException() : Exception() {
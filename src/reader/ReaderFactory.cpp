@@ -1,5 +1,12 @@
 #include "include/ReaderFactory.h"
 
+#ifndef WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+const unsigned long int ReaderFactory::MMAP_SIZE_THRESHOLD = 67108864;
+
 ReaderFactory::ReaderFactory() {
 
 }
@@ -8,50 +15,96 @@ ReaderFactory::~ReaderFactory() {
 
 }
 
-bool ReaderFactory::is_gzip(const char* file_name) throw (ReaderException) {
+unsigned int ReaderFactory::read_header(const char* file_name, unsigned char* header, unsigned int length) throw (ReaderException) {
 	ifstream ifile_stream;
-	char characters[2] = {'\x00', '\x00'};
+	unsigned int header_length = 0u;
 
-	ifile_stream.exceptions(ifstream::failbit | ifstream::badbit);
-	ifile_stream.setf(ifstream::skipws);
+	ifile_stream.open(file_name, ios::binary);
+	if (ifile_stream.fail()) {
+		throw ReaderException("ReaderFactory", "read_header( const char*, unsigned char*, unsigned int )", __LINE__, 3, file_name);
+	}
 
-	try {
-		ifile_stream.open(file_name, ios::binary);
-	} catch (ifstream::failure &e) {
-		throw ReaderException("ReaderFactory", "is_gzip( const char* )", __LINE__, 3, file_name);
+	ifile_stream.read((char*)header, length);
+	if (!ifile_stream.eof() && ifile_stream.fail()) {
+		throw ReaderException("ReaderFactory", "read_header( const char*, unsigned char*, unsigned int )", __LINE__, 4, file_name);
 	}
+	header_length = (unsigned int)ifile_stream.gcount();
 
-	try {
-		ifile_stream.read(characters, 2);
-	} catch (ifstream::failure &e) {
-		if (!ifile_stream.eof()) {
-			throw ReaderException("ReaderFactory", "is_gzip( const char* )", __LINE__, 4, file_name);
-		}
+	ifile_stream.clear();
+	ifile_stream.close();
+	if (ifile_stream.fail()) {
+		throw ReaderException("ReaderFactory", "read_header( const char*, unsigned char*, unsigned int )", __LINE__, 5, file_name);
 	}
 
-	try {
-		ifile_stream.close();
-	} catch (ifstream::failure &e) {
-		throw ReaderException("ReaderFactory", "is_gzip( const char* )", __LINE__, 5, file_name);
+	return header_length;
+}
+
+#ifndef WIN32
+bool ReaderFactory::is_mappable(const char* file_name) {
+	struct stat file_stat;
+
+	if (stat(file_name, &file_stat) != 0) {
+		return false;
+	}
+
+	if (!S_ISREG(file_stat.st_mode)) {
+		return false;
 	}
 
-	if ((characters[0] == '\x1F') && (characters[1] == '\x8B')) {
-		return true;
+	return (unsigned long int)file_stat.st_size >= MMAP_SIZE_THRESHOLD;
+}
+#endif
+
+Reader* ReaderFactory::create(const char* file_name, bool gzip, bool bgzf, bool mappable) throw (ReaderException) {
+	Reader* reader = NULL;
+
+#ifndef WIN32
+	BlockReader* block_reader = NULL;
+
+	if (bgzf) {
+		reader = new BgzfReader();
+	} else if (gzip) {
+		block_reader = new GzipReader();
+		block_reader->set_read_ahead(true);
+		reader = block_reader;
+	} else if (mappable) {
+		reader = new MmapReader();
+	} else {
+		block_reader = new TextReader();
+		block_reader->set_read_ahead(true);
+		reader = block_reader;
+	}
+#else
+	if (gzip) {
+		reader = new GzipReader();
+	} else {
+		reader = new TextReader();
 	}
+#endif
+	reader->set_file_name(file_name);
 
-	return false;
+	return reader;
 }
 
 Reader* ReaderFactory::create(const char* file_name) throw (ReaderException) {
+	unsigned char header[18];
+	unsigned int header_length = 0u;
 	Reader* reader = NULL;
 
 	try {
-		if (is_gzip(file_name)) {
-			reader = new GzipReader();
-		} else {
-			reader = new TextReader();
+#ifndef WIN32
+		if (StreamReader::is_stream(file_name)) {
+			reader = new StreamReader();
+			reader->set_file_name(file_name);
+			return reader;
 		}
-		reader->set_file_name(file_name);
+#endif
+		header_length = read_header(file_name, header, 18u);
+#ifndef WIN32
+		reader = create(file_name, GzipReader::is_gzip_header(header, header_length), BgzfReader::is_bgzf_header(header, header_length), is_mappable(file_name));
+#else
+		reader = create(file_name, GzipReader::is_gzip_header(header, header_length), false, false);
+#endif
 	} catch (Exception &e) {
 		e.add_message("ReaderFactory", "create( const char* )", __LINE__, 10, file_name);
 		throw;
@@ -59,3 +112,29 @@ Reader* ReaderFactory::create(const char* file_name) throw (ReaderException) {
 
 	return reader;
 }
+
+/* no file access besides the reader itself: the probe already knows the format */
+Reader* ReaderFactory::create(FileProbe* probe) throw (ReaderException) {
+	Reader* reader = NULL;
+
+	if (probe == NULL) {
+		throw ReaderException("ReaderFactory", "create( FileProbe* )", __LINE__, 0, "probe");
+	}
+
+	try {
+#ifndef WIN32
+		if (probe->is_stream()) {
+			if ((reader = probe->take_stream_reader()) == NULL) {
+				throw ReaderException("ReaderFactory", "create( FileProbe* )", __LINE__, 13, probe->get_file_name());
+			}
+			return reader;
+		}
+#endif
+		reader = create(probe->get_file_name(), probe->is_compressed(), probe->is_bgzf(), probe->is_regular() && (probe->get_file_size() >= MMAP_SIZE_THRESHOLD));
+	} catch (Exception &e) {
+		e.add_message("ReaderFactory", "create( FileProbe* )", __LINE__, 10, probe->get_file_name());
+		throw;
+	}
+
+	return reader;
+}
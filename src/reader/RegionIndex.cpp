@@ -0,0 +1,334 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/RegionIndex.h"
+
+const char* RegionIndex::TBI_EXTENSION = ".tbi";
+const char* RegionIndex::CSI_EXTENSION = ".csi";
+
+RegionIndex::RegionIndex() {
+	clear();
+}
+
+RegionIndex::~RegionIndex() {
+	clear();
+}
+
+void RegionIndex::clear() {
+	vector<reference*>::iterator references_it;
+
+	for (references_it = references.begin(); references_it != references.end(); references_it++) {
+		free((*references_it)->name);
+		delete *references_it;
+	}
+	references.clear();
+
+	min_shift = 14;
+	depth = 5;
+	chromosome_column = 0;
+	position_column = 0;
+	meta = '#';
+	skip = 0;
+}
+
+bool RegionIndex::read_int32(gzFile ifile, int32_t* value) {
+	unsigned char bytes[4];
+
+	if (gzread(ifile, bytes, 4u) != 4) {
+		return false;
+	}
+
+	*value = (int32_t)((uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+
+	return true;
+}
+
+bool RegionIndex::read_uint64(gzFile ifile, uint64_t* value) {
+	unsigned char bytes[8];
+
+	if (gzread(ifile, bytes, 8u) != 8) {
+		return false;
+	}
+
+	*value = 0u;
+	for (int i = 7; i >= 0; --i) {
+		*value = (*value << 8) | bytes[i];
+	}
+
+	return true;
+}
+
+/* the tabix configuration and the names of the references */
+bool RegionIndex::load_header(gzFile ifile, vector<char*>& names) throw (ReaderException) {
+	int32_t format = 0;
+	int32_t end_column = 0;
+	int32_t value = 0;
+	int32_t names_length = 0;
+	char* names_buffer = NULL;
+	char* name = NULL;
+	bool loaded = true;
+
+	loaded = loaded && read_int32(ifile, &format) && ((format & 0xffff) == 0);
+	loaded = loaded && read_int32(ifile, &value) && (value > 0);
+	chromosome_column = value;
+	loaded = loaded && read_int32(ifile, &value) && (value > 0);
+	position_column = value;
+	loaded = loaded && read_int32(ifile, &end_column);
+	loaded = loaded && read_int32(ifile, &value);
+	meta = (char)value;
+	loaded = loaded && read_int32(ifile, &value) && (value >= 0);
+	skip = value;
+	loaded = loaded && read_int32(ifile, &names_length) && (names_length >= 0);
+
+	if (!loaded) {
+		return false;
+	}
+
+	names_buffer = (char*)malloc((names_length + 1) * sizeof(char));
+	if (names_buffer == NULL) {
+		throw ReaderException("RegionIndex", "load_header( gzFile, vector<char*>& )", __LINE__, 2, (names_length + 1) * sizeof(char));
+	}
+
+	if (gzread(ifile, names_buffer, names_length) != names_length) {
+		free(names_buffer);
+		return false;
+	}
+	names_buffer[names_length] = '\0';
+
+	name = names_buffer;
+	while (name < names_buffer + names_length) {
+		names.push_back(name);
+		name += strlen(name) + 1u;
+	}
+
+	for (unsigned int i = 0u; i < names.size(); ++i) {
+		name = (char*)malloc((strlen(names[i]) + 1u) * sizeof(char));
+		if (name == NULL) {
+			for (unsigned int j = 0u; j < i; ++j) {
+				free(names[j]);
+			}
+			names.clear();
+			free(names_buffer);
+			throw ReaderException("RegionIndex", "load_header( gzFile, vector<char*>& )", __LINE__, 2, (strlen(names[i]) + 1u) * sizeof(char));
+		}
+		strcpy(name, names[i]);
+		names[i] = name;
+	}
+
+	free(names_buffer);
+	names_buffer = NULL;
+
+	return true;
+}
+
+bool RegionIndex::load_index(const char* index_file_name, bool csi) throw (ReaderException) {
+	gzFile ifile = NULL;
+	char magic[4];
+	vector<char*> names;
+	int32_t references_number = 0;
+	int32_t bins_number = 0;
+	int32_t chunks_number = 0;
+	int32_t intervals_number = 0;
+	int32_t aux_length = 0;
+	int32_t value = 0;
+	uint64_t loffset = 0u;
+	reference* new_reference = NULL;
+	vector<chunk>* chunks = NULL;
+	chunk new_chunk;
+	bool loaded = true;
+
+	ifile = gzopen(index_file_name, "rb");
+	if (ifile == NULL) {
+		return false;
+	}
+
+	if ((gzread(ifile, magic, 4u) != 4) || (memcmp(magic, csi ? "CSI\1" : "TBI\1", 4u) != 0)) {
+		gzclose(ifile);
+		return false;
+	}
+
+	if (csi) {
+		loaded = loaded && read_int32(ifile, &value) && (value > 0);
+		min_shift = value;
+		loaded = loaded && read_int32(ifile, &value) && (value > 0) && (min_shift + 3 * value < 64);
+		depth = value;
+		/* without the tabix configuration in the auxiliary data the references can't be named */
+		loaded = loaded && read_int32(ifile, &aux_length) && (aux_length >= 28);
+		loaded = loaded && load_header(ifile, names);
+		loaded = loaded && read_int32(ifile, &references_number);
+	} else {
+		loaded = loaded && read_int32(ifile, &references_number);
+		loaded = loaded && load_header(ifile, names);
+	}
+
+	loaded = loaded && (references_number >= 0) && ((unsigned int)references_number == names.size());
+
+	for (int32_t i = 0; loaded && (i < references_number); ++i) {
+		new_reference = new reference();
+		new_reference->name = names[i];
+		names[i] = NULL;
+		references.push_back(new_reference);
+
+		loaded = read_int32(ifile, &bins_number) && (bins_number >= 0);
+		for (int32_t j = 0; loaded && (j < bins_number); ++j) {
+			loaded = read_int32(ifile, &value);
+			chunks = &(new_reference->bins[(unsigned int)value]);
+			if (csi) {
+				loaded = loaded && read_uint64(ifile, &loffset);
+			}
+			loaded = loaded && read_int32(ifile, &chunks_number) && (chunks_number >= 0);
+			for (int32_t k = 0; loaded && (k < chunks_number); ++k) {
+				loaded = read_uint64(ifile, &new_chunk.begin) && read_uint64(ifile, &new_chunk.end);
+				chunks->push_back(new_chunk);
+			}
+		}
+
+		if (loaded && !csi) {
+			loaded = read_int32(ifile, &intervals_number) && (intervals_number >= 0);
+			new_reference->intervals.resize(loaded ? intervals_number : 0, 0u);
+			for (int32_t j = 0; loaded && (j < intervals_number); ++j) {
+				loaded = read_uint64(ifile, &(new_reference->intervals[j]));
+			}
+		}
+	}
+
+	for (unsigned int i = 0u; i < names.size(); ++i) {
+		free(names[i]);
+	}
+
+	gzclose(ifile);
+
+	return loaded;
+}
+
+/* returns false when neither .tbi nor .csi index exists next to the file */
+bool RegionIndex::load(const char* file_name) throw (ReaderException) {
+	char* index_file_name = NULL;
+	bool loaded = false;
+
+	if (file_name == NULL) {
+		throw ReaderException("RegionIndex", "load( const char* )", __LINE__, 0, "file_name");
+	}
+
+	if (strlen(file_name) <= 0) {
+		throw ReaderException("RegionIndex", "load( const char* )", __LINE__, 1, "file_name");
+	}
+
+	index_file_name = (char*)malloc((strlen(file_name) + 5u) * sizeof(char));
+	if (index_file_name == NULL) {
+		throw ReaderException("RegionIndex", "load( const char* )", __LINE__, 2, (strlen(file_name) + 5u) * sizeof(char));
+	}
+
+	clear();
+	strcpy(index_file_name, file_name);
+	strcat(index_file_name, TBI_EXTENSION);
+	loaded = load_index(index_file_name, false);
+
+	if (!loaded) {
+		clear();
+		strcpy(index_file_name, file_name);
+		strcat(index_file_name, CSI_EXTENSION);
+		loaded = load_index(index_file_name, true);
+	}
+
+	free(index_file_name);
+	index_file_name = NULL;
+
+	if (!loaded) {
+		clear();
+	}
+
+	return loaded;
+}
+
+/* the smallest virtual offset of chunks in bins overlapping the 1-based closed interval [start, end] */
+bool RegionIndex::find_offset(const char* chromosome, unsigned long int start, unsigned long int end, uint64_t* offset) {
+	vector<reference*>::iterator references_it;
+	map<unsigned int, vector<chunk> >::iterator bins_it;
+	vector<chunk>::iterator chunks_it;
+	reference* target = NULL;
+	uint64_t begin = start > 0ul ? start - 1ul : 0ul;
+	uint64_t last = end > 0ul ? end - 1ul : 0ul;
+	uint64_t min_offset = 0u;
+	uint64_t candidate = 0u;
+	uint64_t window = 0u;
+	unsigned int first = 0u;
+	int shift = 0;
+	bool found = false;
+
+	for (references_it = references.begin(); references_it != references.end(); references_it++) {
+		if (strcmp((*references_it)->name, chromosome) == 0) {
+			target = *references_it;
+			break;
+		}
+	}
+
+	if (last >= ((uint64_t)1 << (min_shift + 3 * depth))) {
+		last = ((uint64_t)1 << (min_shift + 3 * depth)) - 1u;
+	}
+
+	if ((target == NULL) || (last < begin)) {
+		return false;
+	}
+
+	/* records before the linear index window of the start can't overlap the region */
+	if (!target->intervals.empty()) {
+		window = begin >> min_shift;
+		min_offset = target->intervals[window < target->intervals.size() ? window : target->intervals.size() - 1u];
+	}
+
+	for (int level = 0; level <= depth; ++level) {
+		shift = min_shift + 3 * (depth - level);
+		first = ((1u << (3 * level)) - 1u) / 7u;
+		for (uint64_t i = begin >> shift; i <= (last >> shift); ++i) {
+			bins_it = target->bins.find(first + (unsigned int)i);
+			if (bins_it == target->bins.end()) {
+				continue;
+			}
+			for (chunks_it = bins_it->second.begin(); chunks_it != bins_it->second.end(); chunks_it++) {
+				if (chunks_it->end <= min_offset) {
+					continue;
+				}
+				candidate = chunks_it->begin > min_offset ? chunks_it->begin : min_offset;
+				if (!found || (candidate < *offset)) {
+					*offset = candidate;
+					found = true;
+				}
+			}
+		}
+	}
+
+	return found;
+}
+
+int RegionIndex::get_chromosome_column() {
+	return chromosome_column;
+}
+
+int RegionIndex::get_position_column() {
+	return position_column;
+}
+
+char RegionIndex::get_meta() {
+	return meta;
+}
+
+int RegionIndex::get_skip() {
+	return skip;
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "include/ShardReader.h"
+#include "include/ReaderFactory.h"
+
+const unsigned int ShardReader::DEFAULT_BUFFER_SIZE = 65536;
+const unsigned int ShardReader::SHARD_READ_AHEAD_BUFFERS_NUMBER = 16;
+
+ShardReader::ShardReader() : Reader(&buffer),
+	current_shard(0u), parallel_shards(1u), header(NULL), header_line(NULL), started(false), opened(false), buffer(NULL) {
+	compressed = false;
+}
+
+ShardReader::~ShardReader() {
+	vector<char*>::iterator names_it;
+
+	try {
+		close();
+	} catch (ReaderException &e) {
+	}
+
+	for (names_it = shard_names.begin(); names_it != shard_names.end(); names_it++) {
+		free(*names_it);
+	}
+	shard_names.clear();
+}
+
+void ShardReader::add_shard(const char* shard_name) throw (ReaderException) {
+	char* shard_name_copy = NULL;
+
+	if (shard_name == NULL) {
+		throw ReaderException("ShardReader", "add_shard( const char* )", __LINE__, 0, "shard_name");
+	}
+
+	if (strlen(shard_name) <= 0) {
+		throw ReaderException("ShardReader", "add_shard( const char* )", __LINE__, 1, "shard_name");
+	}
+
+	shard_name_copy = (char*)malloc((strlen(shard_name) + 1u) * sizeof(char));
+	if (shard_name_copy == NULL) {
+		throw ReaderException("ShardReader", "add_shard( const char* )", __LINE__, 2, (strlen(shard_name) + 1u) * sizeof(char));
+	}
+	strcpy(shard_name_copy, shard_name);
+
+	shard_names.push_back(shard_name_copy);
+}
+
+unsigned int ShardReader::get_shards_number() {
+	return shard_names.size();
+}
+
+const char* ShardReader::get_shard_name(unsigned int shard) throw (ReaderException) {
+	if (shard >= shard_names.size()) {
+		throw ReaderException("ShardReader", "get_shard_name( unsigned int )", __LINE__, 1, "shard");
+	}
+
+	return shard_names[shard];
+}
+
+/* number of shards kept open at once, each with its own read-ahead thread; 1 reads the shards strictly one after another */
+void ShardReader::set_parallel_shards(unsigned int parallel_shards) throw (ReaderException) {
+	if (parallel_shards <= 0u) {
+		throw ReaderException("ShardReader", "set_parallel_shards( unsigned int )", __LINE__, 1, "parallel_shards");
+	}
+
+	this->parallel_shards = parallel_shards;
+}
+
+/* the next parallel_shards shards are opened and their headers are read, which starts their read-ahead threads */
+void ShardReader::open_shards() throw (ReaderException) {
+	unsigned int last_shard = current_shard + parallel_shards;
+	Reader* reader = NULL;
+	char* shard_header = NULL;
+	int line_length = 0;
+
+	if (last_shard > shard_names.size()) {
+		last_shard = shard_names.size();
+	}
+
+	for (unsigned int shard = current_shard; shard < last_shard; shard++) {
+		if (shard_readers[shard] != NULL) {
+			continue;
+		}
+
+		reader = ReaderFactory::create(shard_names[shard]);
+		shard_readers[shard] = reader;
+
+		if (parallel_shards > 1u) {
+			reader->set_read_ahead_depth(SHARD_READ_AHEAD_BUFFERS_NUMBER);
+		}
+
+		reader->open();
+
+		if ((line_length = reader->read_line()) >= 0) {
+			shard_header = (char*)malloc((line_length + 1) * sizeof(char));
+			if (shard_header == NULL) {
+				throw ReaderException("ShardReader", "open_shards()", __LINE__, 2, (line_length + 1) * sizeof(char));
+			}
+			strcpy(shard_header, *(reader->line));
+			shard_headers[shard] = shard_header;
+		}
+	}
+}
+
+void ShardReader::close_shards() throw (ReaderException) {
+	for (unsigned int shard = 0u; shard < shard_readers.size(); shard++) {
+		free(shard_headers[shard]);
+		shard_headers[shard] = NULL;
+
+		if (shard_readers[shard] != NULL) {
+			shard_readers[shard]->close();
+
+			delete shard_readers[shard];
+			shard_readers[shard] = NULL;
+		}
+	}
+
+	shard_readers.clear();
+	shard_headers.clear();
+}
+
+/* the header of every following shard must be identical to the first header and is not returned */
+bool ShardReader::next_shard() throw (ReaderException) {
+	while (current_shard < shard_readers.size()) {
+		open_shards();
+
+		if (shard_headers[current_shard] != NULL) {
+			if (header == NULL) {
+				header = shard_headers[current_shard];
+				shard_headers[current_shard] = NULL;
+				return true;
+			}
+
+			if (strcmp(header, shard_headers[current_shard]) != 0) {
+				throw ReaderException("ShardReader", "next_shard()", __LINE__, 14, shard_names[current_shard], shard_names[0]);
+			}
+
+			free(shard_headers[current_shard]);
+			shard_headers[current_shard] = NULL;
+			return false;
+		}
+
+		shard_readers[current_shard]->close();
+		delete shard_readers[current_shard];
+		shard_readers[current_shard] = NULL;
+
+		current_shard += 1u;
+	}
+
+	return false;
+}
+
+void ShardReader::open() throw (ReaderException) {
+	close();
+
+	if (shard_names.size() <= 0u) {
+		throw ReaderException("ShardReader", "open()", __LINE__, 3, file_name);
+	}
+
+	shard_readers.assign(shard_names.size(), (Reader*)NULL);
+	shard_headers.assign(shard_names.size(), (char*)NULL);
+
+	current_shard = 0u;
+	started = false;
+	opened = true;
+
+	open_shards();
+
+	compressed = shard_readers[0]->is_compressed();
+}
+
+void ShardReader::close() throw (ReaderException) {
+	opened = false;
+	started = false;
+	current_shard = 0u;
+
+	free(header);
+	header = NULL;
+
+	free(header_line);
+	header_line = NULL;
+
+	buffer = NULL;
+
+	close_shards();
+}
+
+int ShardReader::read_line() throw (ReaderException) {
+	int line_length = 0;
+
+	if (!opened) {
+		return -1;
+	}
+
+	if (!started) {
+		started = true;
+
+		/* consumers tokenize lines in place, so the header is returned as a copy */
+		if (next_shard()) {
+			line_length = strlen(header);
+
+			header_line = (char*)malloc((line_length + 1) * sizeof(char));
+			if (header_line == NULL) {
+				throw ReaderException("ShardReader", "read_line()", __LINE__, 2, (line_length + 1) * sizeof(char));
+			}
+			strcpy(header_line, header);
+
+			buffer = header_line;
+			return line_length;
+		}
+	}
+
+	while (current_shard < shard_readers.size()) {
+		if ((line_length = shard_readers[current_shard]->read_line()) >= 0) {
+			buffer = *(shard_readers[current_shard]->line);
+			return line_length;
+		}
+
+		shard_readers[current_shard]->close();
+		delete shard_readers[current_shard];
+		shard_readers[current_shard] = NULL;
+
+		current_shard += 1u;
+
+		next_shard();
+	}
+
+	buffer = NULL;
+
+	return -1;
+}
+
+void ShardReader::reset() throw (ReaderException) {
+	open();
+}
+
+bool ShardReader::eof() {
+	return opened && started && (current_shard >= shard_readers.size());
+}
+
+bool ShardReader::sof() {
+	return opened && !started;
+}
+
+bool ShardReader::is_open() {
+	return opened;
+}
+
+bool ShardReader::is_compressed() {
+	return opened && compressed;
+}
+
+int ShardReader::get_buffer_size() {
+	if (opened && (current_shard < shard_readers.size()) && (shard_readers[current_shard] != NULL)) {
+		return shard_readers[current_shard]->get_buffer_size();
+	}
+
+	return DEFAULT_BUFFER_SIZE;
+}
+
+unsigned long int ShardReader::estimate_lines_count() throw (ReaderException) {
+	unsigned long int lines_count = 0ul;
+	Reader* reader = NULL;
+
+	close();
+
+	for (unsigned int shard = 0u; shard < shard_names.size(); shard++) {
+		reader = ReaderFactory::create(shard_names[shard]);
+
+		try {
+			lines_count += reader->estimate_lines_count();
+		} catch (ReaderException &e) {
+			delete reader;
+			throw;
+		}
+
+		delete reader;
+	}
+
+	return lines_count;
+}
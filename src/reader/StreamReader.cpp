@@ -0,0 +1,259 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "include/StreamReader.h"
+
+#ifndef WIN32
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+const unsigned int StreamReader::DEFAULT_BUFFER_SIZE = 65536;
+const unsigned int StreamReader::GZIP_BUFFER_SIZE = 131072;
+const unsigned int StreamReader::PREFIX_SIZE = 4194304;
+const char* StreamReader::STDIN_NAME = "-";
+
+StreamReader::StreamReader(unsigned int buffer_size) throw (ReaderException) : BlockReader(buffer_size),
+	infile(NULL), opened(false), compressed(false),
+	prefix(NULL), prefix_length(0u), prefix_position(0u), prefix_complete(false), prefix_only(true) {
+
+}
+
+StreamReader::~StreamReader() {
+	clear_block();
+
+	if (opened) {
+		gzclose(infile);
+		opened = false;
+	}
+
+	free(prefix);
+	prefix = NULL;
+}
+
+/* pipes, FIFOs, terminals and "-" for the standard input can be read only once and can't be reopened */
+bool StreamReader::is_stream(const char* file_name) {
+	struct stat file_stat;
+
+	if (file_name == NULL) {
+		return false;
+	}
+
+	if (strcmp(file_name, STDIN_NAME) == 0) {
+		return true;
+	}
+
+	if (stat(file_name, &file_stat) != 0) {
+		return false;
+	}
+
+	return S_ISFIFO(file_stat.st_mode) || S_ISCHR(file_stat.st_mode) || S_ISSOCK(file_stat.st_mode);
+}
+
+/* the prefix is replayed first, then the data continues straight from the stream */
+unsigned int StreamReader::read_block(char* destination, unsigned int size) throw (ReaderException) {
+	unsigned int length = 0u;
+	int read_size = 0;
+
+	if (prefix_position < prefix_length) {
+		length = prefix_length - prefix_position;
+		if (length > size) {
+			length = size;
+		}
+
+		memcpy(destination, prefix + prefix_position, length);
+		prefix_position += length;
+
+		return length;
+	}
+
+	if (prefix_complete) {
+		return 0u;
+	}
+
+	prefix_only = false;
+
+	if ((read_size = gzread(infile, destination, size)) < 0) {
+		throw ReaderException("StreamReader", "unsigned int read_block( char*, unsigned int )", __LINE__, 4, file_name);
+	}
+
+	return (unsigned int)read_size;
+}
+
+/* compression is recognized by zlib from the first bytes; plain text is passed through unchanged */
+void StreamReader::open() throw (ReaderException) {
+	int file_descriptor = -1;
+	int read_size = 0;
+
+	if (opened) {
+		return;
+	}
+
+	if (strcmp(file_name, STDIN_NAME) == 0) {
+		file_descriptor = dup(STDIN_FILENO);
+	} else {
+		file_descriptor = ::open(file_name, O_RDONLY);
+	}
+
+	if (file_descriptor < 0) {
+		throw ReaderException("StreamReader", "open()", __LINE__, 3, file_name);
+	}
+
+	infile = gzdopen(file_descriptor, "rb");
+	if (infile == NULL) {
+		::close(file_descriptor);
+		throw ReaderException("StreamReader", "open()", __LINE__, 3, file_name);
+	}
+
+	opened = true;
+
+	if (gzbuffer(infile, GZIP_BUFFER_SIZE) < 0) {
+		throw ReaderException("StreamReader", "open()", __LINE__, 10, file_name);
+	}
+
+	if (prefix == NULL) {
+		prefix = (char*)malloc(PREFIX_SIZE * sizeof(char));
+		if (prefix == NULL) {
+			throw ReaderException("StreamReader", "open()", __LINE__, 2, PREFIX_SIZE * sizeof(char));
+		}
+	}
+
+	if ((read_size = gzread(infile, prefix, PREFIX_SIZE)) < 0) {
+		throw ReaderException("StreamReader", "open()", __LINE__, 4, file_name);
+	}
+
+	prefix_length = (unsigned int)read_size;
+	prefix_position = 0u;
+	prefix_complete = (prefix_length < PREFIX_SIZE) || (gzeof(infile) != 0);
+	prefix_only = true;
+	compressed = (gzdirect(infile) == 0);
+}
+
+void StreamReader::close() throw (ReaderException) {
+	clear_block();
+
+	if (opened) {
+		int gzerrno = 0;
+
+		opened = false;
+
+		gzerrno = gzclose(infile);
+		if (gzerrno != Z_OK) {
+			throw ReaderException("StreamReader", "close()", __LINE__, 5, file_name);
+		}
+	}
+
+	prefix_length = 0u;
+	prefix_position = 0u;
+	prefix_complete = false;
+	prefix_only = true;
+}
+
+/* possible only while everything read so far is still in the prefix */
+void StreamReader::reset() throw (ReaderException) {
+	if (!opened || !prefix_only) {
+		throw ReaderException("StreamReader", "reset()", __LINE__, 12, file_name);
+	}
+
+	clear_block();
+	prefix_position = 0u;
+}
+
+bool StreamReader::eof() {
+	return is_block_end();
+}
+
+bool StreamReader::sof() {
+	return opened && is_block_start();
+}
+
+bool StreamReader::is_open() {
+	return opened;
+}
+
+bool StreamReader::is_compressed() {
+	return compressed;
+}
+
+/* exact when the whole stream fits into the prefix, otherwise unknown */
+unsigned long int StreamReader::estimate_lines_count() throw (ReaderException) {
+	unsigned long int lines_count = 0ul;
+	bool pending_cr = false;
+
+	if (!opened || !prefix_complete) {
+		return 0ul;
+	}
+
+	lines_count = Reader::count_line_ends(prefix, prefix_length, &pending_cr);
+	if ((prefix_length > 0u) && (prefix[prefix_length - 1u] != '\n') && (prefix[prefix_length - 1u] != '\r')) {
+		lines_count += 1ul;
+	}
+
+	return lines_count > 0ul ? lines_count - 1ul : 0ul;
+}
+
+/* the stream stays open: the top rows are read from the prefix, which is rewound afterwards */
+void StreamReader::detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException) {
+	int header_tokens_number[SEPARATORS_NUMBER];
+	int row_tokens_number[SEPARATORS_NUMBER];
+
+	bool header_was_read = false;
+	bool data_was_read = false;
+
+	if (header_separator == NULL) {
+		throw ReaderException("StreamReader", "detect_field_separators( char*, char* )", __LINE__, 0, "header_separator");
+	}
+
+	if (data_separator == NULL) {
+		throw ReaderException("StreamReader", "detect_field_separators( char*, char* )", __LINE__, 0, "data_separator");
+	}
+
+	open();
+	reset();
+
+	try {
+		inspect_top_rows(header_tokens_number, row_tokens_number, &header_was_read, &data_was_read);
+	} catch (ReaderException &e) {
+		e.add_message("StreamReader", "detect_field_separators( char*, char* )", __LINE__, 7, (const char*)file_name);
+		throw;
+	}
+
+	reset();
+
+	if (header_was_read) {
+		if (!choose_separators(header_tokens_number, row_tokens_number, data_was_read, header_separator, data_separator)) {
+			throw ReaderException("StreamReader", "detect_field_separators( char*, char* )", __LINE__, 8, file_name);
+		}
+	}
+}
+
+const char* StreamReader::get_prefix() {
+	return prefix;
+}
+
+unsigned int StreamReader::get_prefix_length() {
+	return prefix_length;
+}
+
+bool StreamReader::is_prefix_complete() {
+	return prefix_complete;
+}
+
+#endif
@@ -19,38 +19,42 @@
 
 #include "include/TextReader.h"
 
-const unsigned int TextReader::DEFAULT_BUFFER_SIZE = 16777216;
-const unsigned int TextReader::TOP_ROWS_NUMBER = 10;
-const unsigned int TextReader::ROWS_SAMPLE_SIZE = 30;
-const unsigned int TextReader::ROWS_SAMPLE_COUNT = 15;
-
-TextReader::TextReader(unsigned int buffer_size) throw (ReaderException) : Reader(&buffer),
-	buffer_size(buffer_size), buffer(NULL) {
-	if (buffer_size <= 0) {
-		throw ReaderException("TextReader", "TextReader( int )", __LINE__, 1, "buffer_size");
-	}
+const unsigned int TextReader::DEFAULT_BUFFER_SIZE = 65536;
+const unsigned int TextReader::COUNT_CHUNK_SIZE = 4194304;
 
-	buffer = (char*)malloc((buffer_size + 1) * sizeof(char));
-	if (buffer == NULL) {
-		throw ReaderException("TextReader", "TextReader( int )", __LINE__, 2, (buffer_size + 1) * sizeof(char));
-	}
+TextReader::TextReader(unsigned int buffer_size) throw (ReaderException) : BlockReader(buffer_size) {
 
-	buffer[0] = '\0';
 }
 
 TextReader::~TextReader() {
-	buffer_size = 0;
+	clear_block();
+}
+
+unsigned int TextReader::read_block(char* destination, unsigned int size) throw (ReaderException) {
+	ifile_stream.read(destination, size);
+	if (!ifile_stream.eof() && ifile_stream.fail()) {
+		throw ReaderException("TextReader", "unsigned int read_block( char*, unsigned int )", __LINE__, 4, file_name);
+	}
 
-	free(buffer);
-	buffer = NULL;
+	return (unsigned int)ifile_stream.gcount();
 }
 
+void TextReader::seek_block(uint64_t position) throw (ReaderException) {
+	ifile_stream.clear();
+	ifile_stream.seekg((streampos)position, ifstream::beg);
+
+	if (ifile_stream.fail()) {
+		throw ReaderException("TextReader", "seek_block( uint64_t )", __LINE__, 6, file_name);
+	}
+}
 
 void TextReader::open() throw (ReaderException) {
 	if (ifile_stream.is_open()) {
 		close();
 	}
 
+	clear_block();
+
 	ifile_stream.clear();
 	ifile_stream.open(file_name, ios::binary);
 
@@ -60,6 +64,8 @@ void TextReader::open() throw (ReaderException) {
 }
 
 void TextReader::close() throw (ReaderException) {
+	clear_block();
+
 	if (ifile_stream.is_open()) {
 		ifile_stream.clear();
 		ifile_stream.close();
@@ -68,44 +74,12 @@ void TextReader::close() throw (ReaderException) {
 			throw ReaderException("TextReader", "open()", __LINE__, 5, file_name);
 		}
 	}
-
-	buffer[0] = '\0';
-}
-
-int TextReader::read_line() throw (ReaderException) {
-	int i = 0;
-	int c = 0;
-
-	while ((i < buffer_size) && ((c = ifile_stream.get()) != ifstream::traits_type::eof())) {
-		buffer[i] = (char)c;
-
-		if (buffer[i] == '\n') {
-			buffer[i] = '\0';
-			return i;
-		} else if (buffer[i] == '\r') {
-			buffer[i] = '\0';
-			if ((c = ifile_stream.peek()) != ifstream::traits_type::eof()) {
-				if ((char)c == '\n') {
-					ifile_stream.ignore();
-				}
-			}
-			return i;
-		}
-
-		i += 1;
-	}
-
-	buffer[i] = '\0';
-
-	if (!ifile_stream.eof() && ifile_stream.fail()) {
-		throw ReaderException("TextReader", "int read_line()", __LINE__, 4, file_name);
-	}
-
-	return (i == 0 ? -1 : i);
 }
 
 void TextReader::reset() throw (ReaderException) {
 	if (ifile_stream.is_open()) {
+		clear_block();
+
 		ifile_stream.clear();
 		ifile_stream.seekg((streampos)0, ifstream::beg);
 
@@ -116,11 +90,11 @@ void TextReader::reset() throw (ReaderException) {
 }
 
 bool TextReader::eof() {
-	return ifile_stream.eof();
+	return is_block_end();
 }
 
 bool TextReader::sof() {
-	return ifile_stream.tellg() == std::ifstream::pos_type(0);
+	return ifile_stream.is_open() && is_block_start();
 }
 
 bool TextReader::is_open() {
@@ -131,155 +105,53 @@ bool TextReader::is_compressed() {
 	return false;
 }
 
-int TextReader::get_buffer_size() {
-	return buffer_size;
+bool TextReader::is_seekable() {
+	return true;
 }
 
 unsigned long int TextReader::estimate_lines_count() throw (ReaderException) {
-	long int file_length = 0;
-	int header_length = 0;
-	int c = 0;
-
-	int denominator = ROWS_SAMPLE_SIZE * 100;
-	double estimated_location = 0.0;
-	long int file_position = 0;
-	int chars_count = 0;
-	int lines_count = 0;
+	char* chunk = NULL;
+	unsigned long int chunk_length = 0ul;
+	unsigned long int lines_count = 0ul;
+	bool pending_cr = false;
+	char last_char = '\n';
 
-	multiset<int> line_lengths;
-	multiset<int>::iterator line_lengths_it;
-	vector<double> sample_means;
-	double sample_mean = 0.0;
-	double mean = 0.0;
-
-	unsigned int estimated_lines_count = 0;
+	clear_block();
 
 	if (ifile_stream.is_open()) {
 		ifile_stream.close();
 	}
 
+	chunk = (char*)malloc(COUNT_CHUNK_SIZE * sizeof(char));
+	if (chunk == NULL) {
+		throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 2, COUNT_CHUNK_SIZE * sizeof(char));
+	}
+
 	ifile_stream.clear();
 	ifile_stream.open(file_name, ios::binary);
 	if (ifile_stream.fail()) {
+		free(chunk);
 		throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 3, file_name);
 	}
 
-	ifile_stream.seekg((streampos)0, ifstream::end);
-	if (ifile_stream.fail()) {
-		throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 6, file_name);
-	}
-
-	file_length = ifile_stream.tellg();
-	if (file_length < 0) {
-		ifile_stream.clear();
-		ifile_stream.close();
-		if (ifile_stream.fail()) {
-			throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 5, file_name);
+	do {
+		ifile_stream.read(chunk, COUNT_CHUNK_SIZE);
+		if (!ifile_stream.eof() && ifile_stream.fail()) {
+			free(chunk);
+			throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 4, file_name);
 		}
 
-		return 0;
-	}
-
-	ifile_stream.seekg((streampos)0, ifstream::beg);
-	if (ifile_stream.fail()) {
-		throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 6, file_name);
-	}
-
-	while ((c = ifile_stream.get()) != ifstream::traits_type::eof()) {
-		header_length += 1;
-		if ((char)c == '\n') {
-			break;
-		} else if ((char)c == '\r') {
-			if ((c = ifile_stream.peek()) != ifstream::traits_type::eof()) {
-				if ((char)c == '\n') {
-					ifile_stream.ignore();
-				}
-			}
-			break;
-		}
-	}
-
-	if ((!ifile_stream.eof()) && ifile_stream.fail()) {
-		throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 4, file_name);
-	}
-
-	if (header_length < file_length) {
-		srand(time(NULL));
-
-		for (unsigned int i = 0; i < ROWS_SAMPLE_COUNT; i++) {
-			for (unsigned int j = 0; j < ROWS_SAMPLE_SIZE; j++) {
-				estimated_location = (rand() % denominator) / (double)denominator;
-				file_position = (long int)(file_length * estimated_location);
-
-				ifile_stream.seekg((streampos)file_position, ifstream::beg);
-				if (ifile_stream.fail()) {
-					throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 6, file_name);
-				}
-
-				while ((c = ifile_stream.get()) != ifstream::traits_type::eof()) {
-					if ((char)c == '\n') {
-						break;
-					} else if ((char)c == '\r') {
-						if ((c = ifile_stream.peek()) != ifstream::traits_type::eof()) {
-							if ((char)c == '\n') {
-								ifile_stream.ignore();
-							}
-						}
-						break;
-					}
-				}
-
-				while ((c = ifile_stream.get()) != ifstream::traits_type::eof()) {
-					chars_count += 1;
-					if ((char)c == '\n') {
-						line_lengths.insert(chars_count);
-						chars_count = 0;
-						break;
-					} else if ((char)c == '\r') {
-						if ((c = ifile_stream.peek()) != ifstream::traits_type::eof()) {
-							if ((char)c == '\n') {
-								ifile_stream.ignore();
-							}
-						}
-						line_lengths.insert(chars_count);
-						chars_count = 0;
-						break;
-					}
-				}
-
-				if (ifile_stream.eof()) {
-					ifile_stream.clear();
-
-					if (chars_count > 0) {
-						line_lengths.insert(chars_count);
-						chars_count = 0;
-					}
-				} else if (ifile_stream.fail()) {
-					throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 4, file_name);
-				}
-			}
-
-			lines_count = line_lengths.size();
-
-			if (lines_count > 0) {
-				line_lengths_it = line_lengths.begin();
-				while (line_lengths_it != line_lengths.end()) {
-					sample_mean += (*line_lengths_it);
-					line_lengths_it++;
-				}
-				sample_mean = sample_mean / lines_count;
-				sample_means.push_back(sample_mean);
-				sample_mean = 0.0;
-				line_lengths.clear();
-			}
+		chunk_length = (unsigned long int)ifile_stream.gcount();
+		if (chunk_length > 0ul) {
+			lines_count += count_line_ends(chunk, chunk_length, &pending_cr);
+			last_char = chunk[chunk_length - 1ul];
 		}
+	} while (!ifile_stream.eof());
 
-		for (unsigned int i = 0; i < sample_means.size(); i++) {
-			mean += sample_means.at(i);
-		}
-		mean = mean / sample_means.size();
+	free(chunk);
 
-		estimated_lines_count =  (long int)ceil((file_length - header_length) / mean);
+	if ((last_char != '\n') && (last_char != '\r')) {
+		lines_count += 1ul;
 	}
 
 	ifile_stream.clear();
@@ -288,27 +160,16 @@ unsigned long int TextReader::estimate_lines_count() throw (ReaderException) {
 		throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 5, file_name);
 	}
 
-	return estimated_lines_count;
+	/* header is not counted */
+	return lines_count > 0ul ? lines_count - 1ul : 0ul;
 }
 
 void TextReader::detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException) {
-	const unsigned int separators_number = 4;
-	char separators[separators_number] = {',', '\t', ' ' , ';'};
-
-	int header_tokens_number[separators_number];
-	int row_tokens_number[separators_number];
+	int header_tokens_number[SEPARATORS_NUMBER];
+	int row_tokens_number[SEPARATORS_NUMBER];
 
 	bool header_was_read = false;
 	bool data_was_read = false;
-	unsigned int rows_read = 0;
-
-	int line_length = 0;
-	int tokens_number = 0;
-	int char_position = 0;
-	unsigned int i = 0, j = 0;
-	int header_separator_index = -1;
-	int data_separator_index = -1;
-	unsigned int matches = 0;
 
 	if (header_separator == NULL) {
 		throw ReaderException("TextReader", "detect_field_separators( char*, char* )", __LINE__, 0, "header_separator");
@@ -318,6 +179,8 @@ void TextReader::detect_field_separators(char* header_separator, char* data_sepa
 		throw ReaderException("TextReader", "detect_field_separators( char*, char* )", __LINE__, 0, "data_separator");
 	}
 
+	clear_block();
+
 	if (ifile_stream.is_open()) {
 		ifile_stream.close();
 	}
@@ -333,128 +196,24 @@ void TextReader::detect_field_separators(char* header_separator, char* data_sepa
 		throw ReaderException("TextReader", "detect_field_separators( char*, char* )", __LINE__, 6, file_name);
 	}
 
-	i = 0;
-	while (i < separators_number) {
-		header_tokens_number[i] = 0;
-		row_tokens_number[i] = 0;
-		i += 1;
-	}
-
 	try {
-		while ((!header_was_read) && ((line_length = read_line()) >= 0)) {
-			if (line_length > 0) {
-				header_was_read = true;
-
-				i = 0;
-				while (i < separators_number) {
-					tokens_number = 0;
-					char_position = 0;
-					while (char_position < line_length) {
-						if ((*line)[char_position] == separators[i]) {
-							tokens_number += 1;
-						}
-						char_position += 1;
-					}
-					header_tokens_number[i] = tokens_number;
-					i += 1;
-				}
-			}
-		}
-
-		while ((!data_was_read) && ((line_length = read_line()) >= 0)) {
-			if (line_length > 0) {
-				data_was_read = true;
-
-				i = 0;
-				while (i < separators_number) {
-					tokens_number = 0;
-					char_position = 0;
-					while (char_position < line_length) {
-						if ((*line)[char_position] == separators[i]) {
-							tokens_number += 1;
-						}
-						char_position += 1;
-					}
-					row_tokens_number[i] = tokens_number;
-					i += 1;
-				}
-			}
-		}
-
-		while ((rows_read < TOP_ROWS_NUMBER) && ((line_length = read_line()) >= 0)) {
-			if (line_length > 0) {
-				i = 0;
-				while (i < separators_number) {
-					tokens_number = 0;
-					char_position = 0;
-					while (char_position < line_length) {
-						if ((*line)[char_position] == separators[i]) {
-							tokens_number += 1;
-						}
-						char_position += 1;
-					}
-
-					if ((row_tokens_number[i] != tokens_number) && (row_tokens_number[i] != numeric_limits<int>::min())) {
-						row_tokens_number[i] = numeric_limits<int>::min();
-					}
-					i += 1;
-				}
-				rows_read += 1;
-			}
-		}
+		inspect_top_rows(header_tokens_number, row_tokens_number, &header_was_read, &data_was_read);
 	} catch (ReaderException &e) {
 		e.add_message("TextReader", "detect_field_separators( char*, char* )", __LINE__, 7, (const char*)file_name);
 		throw;
 	}
 
+	clear_block();
+
 	ifile_stream.clear();
 	ifile_stream.close();
 	if (ifile_stream.fail()) {
 		throw ReaderException("TextReader", "detect_field_separators( char*, char* )", __LINE__, 5, file_name);
 	}
 
-	buffer[0] = '\0';
-
 	if (header_was_read) {
-		if (data_was_read) {
-			i = 0;
-			while (i < separators_number) {
-				j = 0;
-				while (j < separators_number) {
-					if ((header_tokens_number[i] == row_tokens_number[j]) && (header_tokens_number[i] > 0)) {
-						header_separator_index = i;
-						data_separator_index = j;
-						matches += 1;
-					}
-					j += 1;
-				}
-				i += 1;
-			}
-		} else {
-			i = 0;
-			while (i < separators_number) {
-				if (header_tokens_number[i] > 0) {
-					header_separator_index = i;
-					data_separator_index = i;
-					matches += 1;
-				}
-				i += 1;
-			}
-		}
-
-		if (matches < 1) {
-			i = 0;
-			while (i < separators_number) {
-				if ((header_tokens_number[i] != 0) || (row_tokens_number[i] != 0)) {
-					throw ReaderException("TextReader", "detect_field_separators( char*, char* )", __LINE__, 8, file_name);
-				}
-				i += 1;
-			}
-		} else if (matches > 1) {
+		if (!choose_separators(header_tokens_number, row_tokens_number, data_was_read, header_separator, data_separator)) {
 			throw ReaderException("TextReader", "detect_field_separators( char*, char* )", __LINE__, 8, file_name);
-		} else {
-			*header_separator = separators[header_separator_index];
-			*data_separator = separators[data_separator_index];
 		}
 	}
 }
@@ -0,0 +1,104 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BGZFREADER_H_
+#define BGZFREADER_H_
+
+#ifndef WIN32
+
+#include <fstream>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "BlockReader.h"
+#include "GzipReader.h"
+#include "../../zlib/zlib.h"
+
+class BgzfReader : public BlockReader {
+private:
+	struct bgzf_block {
+		char* compressed;
+		char* uncompressed;
+		unsigned int compressed_length;
+		unsigned int data_offset;
+		unsigned int uncompressed_length;
+		unsigned int offset;
+		bool inflated;
+		bool failed;
+	};
+
+	ifstream ifile_stream;
+
+	bool opened;
+	bool input_end;
+
+	unsigned int threads_number;
+	pthread_t* threads;
+	unsigned int running_threads_number;
+	bool threads_stop;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t blocks_loaded;
+	pthread_cond_t blocks_inflated;
+
+	unsigned int slots_number;
+	bgzf_block* slots;
+
+	unsigned long int loaded;
+	unsigned long int claimed;
+	unsigned long int inflated;
+	unsigned long int consumed;
+
+	bool load_block(bgzf_block* slot) throw (ReaderException);
+	void start_threads() throw (ReaderException);
+	void stop_threads();
+	void drain_threads();
+
+	static bool inflate_block(z_stream* stream, bgzf_block* slot);
+	static void* inflate_blocks(void* reader);
+
+protected:
+	unsigned int read_block(char* destination, unsigned int size) throw (ReaderException);
+
+public:
+	static const unsigned int DEFAULT_BUFFER_SIZE;
+	static const unsigned int MAX_BLOCK_SIZE;
+	static const unsigned int SLOTS_PER_THREAD;
+	static const unsigned int MAX_THREADS_NUMBER;
+
+	static unsigned int get_default_threads_number();
+	static bool is_bgzf_header(const unsigned char* header, unsigned int length);
+
+	BgzfReader(unsigned int buffer_size = DEFAULT_BUFFER_SIZE, unsigned int threads_number = 0u) throw (ReaderException);
+	virtual ~BgzfReader();
+
+	void open() throw (ReaderException);
+	void close() throw (ReaderException);
+	void reset() throw (ReaderException);
+	bool eof();
+	bool sof();
+	bool is_open();
+	bool is_compressed();
+	unsigned long int estimate_lines_count() throw (ReaderException);
+	void seek_virtual(uint64_t offset) throw (ReaderException);
+};
+
+#endif
+
+#endif
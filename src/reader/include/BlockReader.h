@@ -0,0 +1,102 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOCKREADER_H_
+#define BLOCKREADER_H_
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+#include "Reader.h"
+
+class BlockReader : public Reader {
+private:
+	unsigned int block_size;
+	char* block;
+	char* block_start;
+	char* block_end;
+	char* next_lf;
+	char* next_cr;
+	char* held_position;
+	char held_char;
+	uint64_t block_offset;
+	bool input_eof;
+
+	bool read_ahead;
+
+#ifndef WIN32
+	struct read_ahead_buffer {
+		char* data;
+		unsigned int length;
+	};
+
+	read_ahead_buffer* read_ahead_buffers;
+	unsigned int read_ahead_buffers_number;
+	unsigned long int read_ahead_produced;
+	unsigned long int read_ahead_consumed;
+	unsigned int read_ahead_offset;
+	bool read_ahead_running;
+	bool read_ahead_stop;
+	bool read_ahead_end;
+	ReaderException* read_ahead_exception;
+
+	pthread_t read_ahead_thread;
+	pthread_mutex_t read_ahead_mutex;
+	pthread_cond_t read_ahead_filled;
+	pthread_cond_t read_ahead_drained;
+
+	void start_read_ahead() throw (ReaderException);
+	void stop_read_ahead();
+	void free_read_ahead_buffers();
+	unsigned int take_block(char* destination, unsigned int size) throw (ReaderException);
+
+	static void* read_ahead_blocks(void* reader);
+#endif
+
+	bool fill_block() throw (ReaderException);
+	bool grow_block() throw (ReaderException);
+
+protected:
+	int buffer_size;
+	char* buffer;
+
+	void clear_block();
+	bool is_block_start();
+	bool is_block_end();
+
+	virtual unsigned int read_block(char* destination, unsigned int size) throw (ReaderException) = 0;
+	virtual void seek_block(uint64_t position) throw (ReaderException);
+
+public:
+	static const unsigned int READ_AHEAD_BUFFERS_NUMBER;
+	static const unsigned int READ_AHEAD_BUFFER_SIZE;
+
+	BlockReader(unsigned int buffer_size) throw (ReaderException);
+	virtual ~BlockReader();
+
+	int read_line() throw (ReaderException);
+	int get_buffer_size();
+	uint64_t tell() throw (ReaderException);
+	void seek(uint64_t position) throw (ReaderException);
+	void set_read_ahead(bool read_ahead);
+	void set_read_ahead_depth(unsigned int buffers_number);
+};
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FILEPROBE_H_
+#define FILEPROBE_H_
+
+#include <fstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "GzipReader.h"
+#include "BgzfReader.h"
+#include "StreamReader.h"
+
+class FileProbe {
+private:
+	char* file_name;
+	bool compressed;
+	bool bgzf;
+	bool regular;
+	bool stream;
+	unsigned long int file_size;
+	long int modification_time;
+
+	char* header;
+	bool header_found;
+	bool separators_found;
+	char header_separator;
+	char data_separator;
+	bool quoted;
+
+	unsigned long int estimated_lines_count;
+
+	char* chunk;
+	char* sample;
+
+#ifndef WIN32
+	StreamReader* stream_reader;
+#endif
+
+	void clear();
+	void inspect_lines(const char* data, unsigned long int length, bool complete) throw (ReaderException);
+	void probe_text(ifstream& ifile_stream, unsigned long int chunk_length) throw (ReaderException);
+	void probe_gzip(ifstream& ifile_stream, unsigned long int chunk_length) throw (ReaderException);
+#ifndef WIN32
+	void probe_stream() throw (ReaderException);
+#endif
+
+public:
+	static const unsigned int CHUNK_SIZE;
+
+	FileProbe();
+	virtual ~FileProbe();
+
+	void probe(const char* file_name) throw (ReaderException);
+	bool is_current(const char* file_name);
+
+	const char* get_file_name();
+	bool is_compressed();
+	bool is_bgzf();
+	bool is_regular();
+	bool is_stream();
+	unsigned long int get_file_size();
+	long int get_modification_time();
+	const char* get_header();
+	void get_field_separators(char* header_separator, char* data_separator) throw (ReaderException);
+	bool is_quoted();
+	unsigned long int get_estimated_lines_count();
+#ifndef WIN32
+	StreamReader* take_stream_reader();
+#endif
+};
+
+#endif
@@ -20,35 +20,70 @@
 #ifndef GZIPREADER_H_
 #define GZIPREADER_H_
 
-#include "Reader.h"
+#include <fstream>
+#include <algorithm>
+#include <math.h>
+
+#include "BlockReader.h"
+#include "InflateIndex.h"
 #include "../../zlib/zlib.h"
 
-class GzipReader: public Reader {
+class GzipReader: public BlockReader {
 private:
-	gzFile infile;
+	ifstream ifile_stream;
+
+	z_stream stream;
+	unsigned char* input;
+	uint64_t input_position;
+	uint64_t output_position;
+	bool input_eof;
+	bool stream_end;
+	bool transparent;
+	bool raw;
+
+	unsigned char* window;
+	unsigned int window_next;
+	unsigned int window_length;
+
+	InflateIndex inflate_index;
+	unsigned long int checkpoint_span;
 
 	bool opened;
 
-	int buffer_size;
-	char* buffer;
+	unsigned int fill_input() throw (ReaderException);
+	void start_inflate(long int checkpoint) throw (ReaderException);
+	void next_member() throw (ReaderException);
+	void update_window(const unsigned char* data, unsigned int length);
+	void add_checkpoint() throw (ReaderException);
+
+protected:
+	unsigned int read_block(char* destination, unsigned int size) throw (ReaderException);
+	void seek_block(uint64_t position) throw (ReaderException);
 
 public:
 	static const unsigned int DEFAULT_BUFFER_SIZE;
-	static const unsigned int TOP_ROWS_NUMBER;
+	static const unsigned int GZIP_BUFFER_SIZE;
+	static const unsigned int ESTIMATE_SAMPLE_SIZE;
+
+	static bool is_gzip_header(const unsigned char* header, unsigned int length);
+	static unsigned long int scale_lines_count(unsigned long int lines_count, unsigned long int sample_length, unsigned long int sample_offset, double file_length, const unsigned char* trailer);
 
 	GzipReader(unsigned int buffer_size = DEFAULT_BUFFER_SIZE) throw (ReaderException);
 	virtual ~GzipReader();
 
 	void open() throw (ReaderException);
 	void close() throw (ReaderException);
-	int read_line() throw (ReaderException);
 	void reset() throw (ReaderException);
 	bool eof();
 	bool sof();
 	bool is_open();
 	bool is_compressed();
-	int get_buffer_size();
-	void detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException);
+	bool is_seekable();
+	unsigned long int estimate_lines_count() throw (ReaderException);
+	void save_checkpoints() throw (ReaderException);
+
+	void set_checkpoint_span(unsigned long int span);
+	unsigned long int get_checkpoints_number();
 };
 
 #endif
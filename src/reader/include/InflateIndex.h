@@ -0,0 +1,82 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INFLATEINDEX_H_
+#define INFLATEINDEX_H_
+
+#include <fstream>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "Reader.h"
+
+class InflateIndex {
+private:
+	struct checkpoint {
+		uint64_t output_offset;
+		uint64_t input_offset;
+		unsigned int bits;
+		unsigned int window_length;
+		unsigned char* window;
+	};
+
+	char* file_name;
+	uint64_t file_size;
+	long int modification_time;
+
+	unsigned long int span;
+	vector<checkpoint> checkpoints;
+
+	void clear();
+	void set_file(const char* file_name) throw (ReaderException);
+	char* get_index_file_name() throw (ReaderException);
+
+	static void write_number(ofstream& ofile_stream, uint64_t value);
+	static bool read_number(ifstream& ifile_stream, uint64_t* value);
+
+public:
+	static const char* FILE_EXTENSION;
+	static const char MAGIC[];
+	static const unsigned long int FORMAT_VERSION;
+	static const unsigned long int DEFAULT_SPAN;
+	static const unsigned int WINDOW_SIZE;
+
+	InflateIndex();
+	virtual ~InflateIndex();
+
+	void start(const char* file_name, unsigned long int span = DEFAULT_SPAN) throw (ReaderException);
+	void add_checkpoint(uint64_t output_offset, uint64_t input_offset, unsigned int bits, const unsigned char* window, unsigned int window_length) throw (ReaderException);
+	bool load(const char* file_name) throw (ReaderException);
+	void save() throw (ReaderException);
+	bool is_current(const char* file_name);
+
+	long int find_checkpoint(uint64_t position);
+
+	const char* get_file_name();
+	unsigned long int get_span();
+	unsigned long int get_checkpoints_number();
+	uint64_t get_output_offset(unsigned long int checkpoint) throw (ReaderException);
+	uint64_t get_input_offset(unsigned long int checkpoint) throw (ReaderException);
+	unsigned int get_bits(unsigned long int checkpoint) throw (ReaderException);
+	const unsigned char* get_window(unsigned long int checkpoint) throw (ReaderException);
+	unsigned int get_window_length(unsigned long int checkpoint) throw (ReaderException);
+};
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LINEINDEX_H_
+#define LINEINDEX_H_
+
+#include <fstream>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "Reader.h"
+
+class LineIndex {
+private:
+	char* file_name;
+	uint64_t file_size;
+	long int modification_time;
+
+	unsigned long int interval;
+	unsigned long int lines_count;
+	vector<uint64_t> offsets;
+
+	void clear();
+	char* get_index_file_name() throw (ReaderException);
+
+	static void write_number(ofstream& ofile_stream, uint64_t value);
+	static bool read_number(ifstream& ifile_stream, uint64_t* value);
+
+public:
+	static const char* FILE_EXTENSION;
+	static const char MAGIC[];
+	static const unsigned long int FORMAT_VERSION;
+	static const unsigned long int DEFAULT_INTERVAL;
+
+	LineIndex();
+	virtual ~LineIndex();
+
+	void start(const char* file_name, unsigned long int interval = DEFAULT_INTERVAL) throw (ReaderException);
+	void add_line(uint64_t offset);
+	void build(const char* file_name, Reader* reader, unsigned long int interval = DEFAULT_INTERVAL) throw (ReaderException);
+	bool load(const char* file_name) throw (ReaderException);
+	void save() throw (ReaderException);
+	bool is_current(const char* file_name);
+
+	void seek_line(Reader* reader, unsigned long int line) throw (ReaderException);
+
+	const char* get_file_name();
+	unsigned long int get_interval();
+	unsigned long int get_lines_count();
+	unsigned long int get_checkpoints_number();
+	uint64_t get_offset(unsigned long int checkpoint) throw (ReaderException);
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MMAPREADER_H_
+#define MMAPREADER_H_
+
+#ifndef WIN32
+
+#include "Reader.h"
+
+class MmapReader : public Reader {
+private:
+	char* map;
+	char* map_end;
+	char* position;
+	char* next_lf;
+	char* next_cr;
+
+	bool opened;
+
+	int buffer_size;
+	char* buffer;
+
+	char* find_next(char character, char* cached, char* search_end);
+	bool grow_buffer() throw (ReaderException);
+
+public:
+	static const unsigned int DEFAULT_BUFFER_SIZE;
+	static const unsigned long int SCAN_SIZE;
+
+	MmapReader(unsigned int buffer_size = DEFAULT_BUFFER_SIZE) throw (ReaderException);
+	virtual ~MmapReader();
+
+	void open() throw (ReaderException);
+	void close() throw (ReaderException);
+	int read_line() throw (ReaderException);
+	void reset() throw (ReaderException);
+	bool eof();
+	bool sof();
+	bool is_open();
+	bool is_compressed();
+	int get_buffer_size();
+	bool is_seekable();
+	uint64_t tell() throw (ReaderException);
+	void seek(uint64_t position) throw (ReaderException);
+	unsigned long int estimate_lines_count() throw (ReaderException);
+};
+
+#endif
+
+#endif
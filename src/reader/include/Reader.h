@@ -21,23 +21,45 @@
 #define READER_H_
 
 #include "ReaderException.h"
+#include "../../auxiliary/include/auxiliary.h"
+
+class RegionIndex;
 
 class Reader {
 protected:
 	char* file_name;
 	bool compressed;
+	bool quoted;
+
+	RegionIndex* region_index;
+	char* region_chromosome;
+	unsigned long int region_start;
+	unsigned long int region_end;
+	bool region_active;
+	bool region_chromosome_seen;
+
+	static const char* get_field(const char* line, int column, char separator, unsigned int* length);
+
+	void inspect_top_rows(int* header_tokens_number, int* row_tokens_number, bool* header_was_read, bool* data_was_read) throw (ReaderException);
 
 public:
-	static const int SEPARATORS_NUMBER;
+	static const int SEPARATORS_NUMBER = 4;
 	static const char separators[];
+	static const unsigned int TOP_ROWS_NUMBER;
+	static const unsigned int MAX_BUFFER_SIZE;
 
 	char* const* line;
 
+	static unsigned long int count_line_ends(const char* data, unsigned long int size, bool* pending_cr);
+	static bool count_separators(const char* line, int line_length, int* tokens_number, bool* malformed);
+	static bool choose_separators(const int* header_tokens_number, const int* row_tokens_number, bool data_was_read, char* header_separator, char* data_separator);
+
 	Reader(char** buffer);
 	virtual ~Reader();
 
 	void set_file_name(const char* file_name) throw (ReaderException);
 	const char* get_file_name();
+	bool is_quoted();
 
 	virtual void open() throw (ReaderException) = 0;
 	virtual void close() throw (ReaderException) = 0;
@@ -49,7 +71,16 @@ public:
 	virtual bool is_compressed() = 0;
 	virtual int get_buffer_size() = 0;
 	virtual unsigned long int estimate_lines_count() throw (ReaderException);
+	virtual bool is_seekable();
+	virtual uint64_t tell() throw (ReaderException);
+	virtual void seek(uint64_t position) throw (ReaderException);
+	virtual void set_read_ahead_depth(unsigned int buffers_number);
+	virtual void save_checkpoints() throw (ReaderException);
 	virtual void detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException);
+	virtual void seek_virtual(uint64_t offset) throw (ReaderException);
+
+	bool query_region(const char* chromosome, unsigned long int start, unsigned long int end) throw (ReaderException);
+	int read_region_line() throw (ReaderException);
 };
 
 #endif
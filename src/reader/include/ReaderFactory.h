@@ -22,16 +22,28 @@
 
 #include "TextReader.h"
 #include "GzipReader.h"
+#include "MmapReader.h"
+#include "BgzfReader.h"
+#include "FileProbe.h"
+#include "LineIndex.h"
+#include "ShardReader.h"
 
 class ReaderFactory {
 private:
-	static bool is_gzip(const char* file_name) throw (ReaderException);
+	static unsigned int read_header(const char* file_name, unsigned char* header, unsigned int length) throw (ReaderException);
+#ifndef WIN32
+	static bool is_mappable(const char* file_name);
+#endif
+	static Reader* create(const char* file_name, bool gzip, bool bgzf, bool mappable) throw (ReaderException);
 
 public:
+	static const unsigned long int MMAP_SIZE_THRESHOLD;
+
 	ReaderFactory();
 	virtual ~ReaderFactory();
 
 	static Reader* create(const char* file_name) throw (ReaderException);
+	static Reader* create(FileProbe* probe) throw (ReaderException);
 };
 
 #endif
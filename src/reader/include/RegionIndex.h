@@ -0,0 +1,74 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REGIONINDEX_H_
+#define REGIONINDEX_H_
+
+#include <vector>
+#include <map>
+
+#include "Reader.h"
+#include "../../zlib/zlib.h"
+
+class RegionIndex {
+private:
+	struct chunk {
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	struct reference {
+		char* name;
+		map<unsigned int, vector<chunk> > bins;
+		vector<uint64_t> intervals;
+	};
+
+	int min_shift;
+	int depth;
+	int chromosome_column;
+	int position_column;
+	char meta;
+	int skip;
+
+	vector<reference*> references;
+
+	void clear();
+	bool load_index(const char* index_file_name, bool csi) throw (ReaderException);
+	bool load_header(gzFile ifile, vector<char*>& names) throw (ReaderException);
+
+	static bool read_int32(gzFile ifile, int32_t* value);
+	static bool read_uint64(gzFile ifile, uint64_t* value);
+
+public:
+	static const char* TBI_EXTENSION;
+	static const char* CSI_EXTENSION;
+
+	RegionIndex();
+	virtual ~RegionIndex();
+
+	bool load(const char* file_name) throw (ReaderException);
+	bool find_offset(const char* chromosome, unsigned long int start, unsigned long int end, uint64_t* offset);
+
+	int get_chromosome_column();
+	int get_position_column();
+	char get_meta();
+	int get_skip();
+};
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SHARDREADER_H_
+#define SHARDREADER_H_
+
+#include <vector>
+
+#include "Reader.h"
+
+class ShardReader : public Reader {
+private:
+	vector<char*> shard_names;
+	vector<Reader*> shard_readers;
+	vector<char*> shard_headers;
+
+	unsigned int current_shard;
+	unsigned int parallel_shards;
+
+	char* header;
+	char* header_line;
+	bool started;
+	bool opened;
+
+	char* buffer;
+
+	void open_shards() throw (ReaderException);
+	void close_shards() throw (ReaderException);
+	bool next_shard() throw (ReaderException);
+
+public:
+	static const unsigned int DEFAULT_BUFFER_SIZE;
+	static const unsigned int SHARD_READ_AHEAD_BUFFERS_NUMBER;
+
+	ShardReader();
+	virtual ~ShardReader();
+
+	void add_shard(const char* shard_name) throw (ReaderException);
+	unsigned int get_shards_number();
+	const char* get_shard_name(unsigned int shard) throw (ReaderException);
+	void set_parallel_shards(unsigned int parallel_shards) throw (ReaderException);
+
+	void open() throw (ReaderException);
+	void close() throw (ReaderException);
+	int read_line() throw (ReaderException);
+	void reset() throw (ReaderException);
+	bool eof();
+	bool sof();
+	bool is_open();
+	bool is_compressed();
+	int get_buffer_size();
+	unsigned long int estimate_lines_count() throw (ReaderException);
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef STREAMREADER_H_
+#define STREAMREADER_H_
+
+#ifndef WIN32
+
+#include "BlockReader.h"
+#include "../../zlib/zlib.h"
+
+class StreamReader : public BlockReader {
+private:
+	gzFile infile;
+
+	bool opened;
+	bool compressed;
+
+	char* prefix;
+	unsigned int prefix_length;
+	unsigned int prefix_position;
+	bool prefix_complete;
+	bool prefix_only;
+
+protected:
+	unsigned int read_block(char* destination, unsigned int size) throw (ReaderException);
+
+public:
+	static const unsigned int DEFAULT_BUFFER_SIZE;
+	static const unsigned int GZIP_BUFFER_SIZE;
+	static const unsigned int PREFIX_SIZE;
+	static const char* STDIN_NAME;
+
+	static bool is_stream(const char* file_name);
+
+	StreamReader(unsigned int buffer_size = DEFAULT_BUFFER_SIZE) throw (ReaderException);
+	virtual ~StreamReader();
+
+	void open() throw (ReaderException);
+	void close() throw (ReaderException);
+	void reset() throw (ReaderException);
+	bool eof();
+	bool sof();
+	bool is_open();
+	bool is_compressed();
+	unsigned long int estimate_lines_count() throw (ReaderException);
+	void detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException);
+
+	const char* get_prefix();
+	unsigned int get_prefix_length();
+	bool is_prefix_complete();
+};
+
+#endif
+
+#endif
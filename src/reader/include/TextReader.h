@@ -27,33 +27,31 @@
 #include <limits>
 #include <time.h>
 
-#include "Reader.h"
+#include "BlockReader.h"
 
-class TextReader : public Reader {
+class TextReader : public BlockReader {
 private:
 	ifstream ifile_stream;
 
-	int buffer_size;
-	char* buffer;
+protected:
+	unsigned int read_block(char* destination, unsigned int size) throw (ReaderException);
+	void seek_block(uint64_t position) throw (ReaderException);
 
 public:
 	static const unsigned int DEFAULT_BUFFER_SIZE;
-	static const unsigned int TOP_ROWS_NUMBER;
-	static const unsigned int ROWS_SAMPLE_SIZE;
-	static const unsigned int ROWS_SAMPLE_COUNT;
+	static const unsigned int COUNT_CHUNK_SIZE;
 
 	TextReader(unsigned int buffer_size = DEFAULT_BUFFER_SIZE) throw (ReaderException);
 	virtual ~TextReader();
 
 	void open() throw (ReaderException);
 	void close() throw (ReaderException);
-	int read_line() throw (ReaderException);
 	void reset() throw (ReaderException);
 	bool eof();
 	bool sof();
 	bool is_open();
 	bool is_compressed();
-	int get_buffer_size();
+	bool is_seekable();
 	unsigned long int estimate_lines_count() throw (ReaderException);
 	void detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException);
 };
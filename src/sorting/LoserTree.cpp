@@ -0,0 +1,130 @@
+/*
+ * Copyright  2012 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/LoserTree.h"
+
+SortSource::SortSource() : key(0u), line(NULL), line_length(0u) {
+
+}
+
+SortSource::~SortSource() {
+
+}
+
+LoserTree::LoserTree(SortSource** sources, unsigned int sources_number) throw (SorterException) :
+	sources(sources), sources_number(sources_number), tree(NULL), exhausted(NULL) {
+
+	if (sources == NULL) {
+		throw SorterException("LoserTree", "LoserTree( SortSource**, unsigned int )", __LINE__, 0, "sources");
+	}
+
+	if (sources_number <= 0u) {
+		throw SorterException("LoserTree", "LoserTree( SortSource**, unsigned int )", __LINE__, 1, "sources_number");
+	}
+
+	tree = (unsigned int*)malloc(sources_number * sizeof(unsigned int));
+	if (tree == NULL) {
+		throw SorterException("LoserTree", "LoserTree( SortSource**, unsigned int )", __LINE__, 2, sources_number * sizeof(unsigned int));
+	}
+
+	exhausted = (bool*)malloc(sources_number * sizeof(bool));
+	if (exhausted == NULL) {
+		free(tree);
+		tree = NULL;
+		throw SorterException("LoserTree", "LoserTree( SortSource**, unsigned int )", __LINE__, 2, sources_number * sizeof(bool));
+	}
+}
+
+LoserTree::~LoserTree() {
+	free(tree);
+	tree = NULL;
+
+	free(exhausted);
+	exhausted = NULL;
+
+	sources = NULL;
+}
+
+/* equal keys go to the source with the lower index, which keeps the merge stable */
+bool LoserTree::beats(unsigned int first, unsigned int second) {
+	if (exhausted[first]) {
+		return false;
+	}
+
+	if (exhausted[second]) {
+		return true;
+	}
+
+	if (sources[first]->key != sources[second]->key) {
+		return sources[first]->key < sources[second]->key;
+	}
+
+	return first < second;
+}
+
+/* leaves are the nodes sources_number, ..., 2 * sources_number - 1; inner nodes keep the losers and pass the winner up */
+unsigned int LoserTree::build(unsigned int node) {
+	unsigned int left = 0u;
+	unsigned int right = 0u;
+
+	if (node >= sources_number) {
+		return node - sources_number;
+	}
+
+	left = build(2u * node);
+	right = build(2u * node + 1u);
+
+	if (beats(left, right)) {
+		tree[node] = right;
+		return left;
+	}
+
+	tree[node] = left;
+	return right;
+}
+
+void LoserTree::start() throw (SorterException) {
+	for (unsigned int i = 0u; i < sources_number; ++i) {
+		exhausted[i] = !sources[i]->next();
+	}
+
+	tree[0] = build(1u);
+}
+
+/* the source with the smallest current key or NULL when all sources are exhausted */
+SortSource* LoserTree::top() {
+	return exhausted[tree[0]] ? NULL : sources[tree[0]];
+}
+
+void LoserTree::pop() throw (SorterException) {
+	unsigned int winner = tree[0];
+	unsigned int loser = 0u;
+
+	exhausted[winner] = !sources[winner]->next();
+
+	for (unsigned int node = (winner + sources_number) / 2u; node > 0u; node /= 2u) {
+		if (beats(tree[node], winner)) {
+			loser = winner;
+			winner = tree[node];
+			tree[node] = loser;
+		}
+	}
+
+	tree[0] = winner;
+}
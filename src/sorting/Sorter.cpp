@@ -0,0 +1,849 @@
+/*
+ * Copyright  2012 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/Sorter.h"
+
+const unsigned long int Sorter::DEFAULT_MEMORY_SIZE = 268435456ul;
+const unsigned long int Sorter::MIN_MEMORY_SIZE = 16777216ul;
+const unsigned int Sorter::MAX_THREADS_NUMBER = 8u;
+const unsigned int Sorter::MIN_TASK_SIZE = 65536u;
+const unsigned int Sorter::MAX_RUNS_NUMBER = 128u;
+const unsigned int Sorter::MIN_RUN_BUFFER_SIZE = 65536u;
+
+const unsigned int Sorter::OTHER_CHROMOSOMES_RANK = 100010u;
+const unsigned int Sorter::MISSING_RANK = 0xFFFFFFu;
+const unsigned int Sorter::MISSING_POSITION = 0xFFFFFFFFu;
+
+Sorter::RecordSource::RecordSource(record* begin, record* end) : SortSource(), current(begin), end(end) {
+
+}
+
+Sorter::RecordSource::~RecordSource() {
+
+}
+
+bool Sorter::RecordSource::next() throw (SorterException) {
+	if (current >= end) {
+		return false;
+	}
+
+	key = current->key;
+	line = current->line;
+	line_length = current->line_length;
+
+	current += 1;
+
+	return true;
+}
+
+Sorter::RunSource::RunSource(const char* file_name, char* buffer, unsigned int buffer_size) throw (SorterException) : SortSource(),
+	file_name(file_name), buffer(buffer), buffer_size(buffer_size), start(buffer), end(buffer), long_line(NULL) {
+
+	ifile_stream.open(file_name, ios::binary);
+	if (ifile_stream.fail()) {
+		throw SorterException("RunSource", "RunSource( const char*, char*, unsigned int )", __LINE__, 11, file_name);
+	}
+}
+
+Sorter::RunSource::~RunSource() {
+	if (ifile_stream.is_open()) {
+		ifile_stream.close();
+	}
+
+	free(long_line);
+	long_line = NULL;
+}
+
+/* moves the unread bytes to the beginning of the buffer and reads until at least 'needed' bytes are available */
+bool Sorter::RunSource::fill(unsigned int needed) throw (SorterException) {
+	unsigned int available = (unsigned int)(end - start);
+
+	if (available >= needed) {
+		return true;
+	}
+
+	memmove(buffer, start, available);
+	start = buffer;
+	end = buffer + available;
+
+	if (ifile_stream.good()) {
+		ifile_stream.read(end, buffer_size - available);
+		if (ifile_stream.bad()) {
+			throw SorterException("RunSource", "fill( unsigned int )", __LINE__, 11, file_name);
+		}
+		end += ifile_stream.gcount();
+	}
+
+	return (unsigned int)(end - start) >= needed;
+}
+
+/* run records are the 8 bytes key, the 4 bytes line length and the line itself */
+bool Sorter::RunSource::next() throw (SorterException) {
+	unsigned int available = 0u;
+	char* new_long_line = NULL;
+
+	if (!fill(sizeof(uint64_t) + sizeof(unsigned int))) {
+		if (start != end) {
+			throw SorterException("RunSource", "next()", __LINE__, 11, file_name);
+		}
+		return false;
+	}
+
+	memcpy(&key, start, sizeof(uint64_t));
+	start += sizeof(uint64_t);
+	memcpy(&line_length, start, sizeof(unsigned int));
+	start += sizeof(unsigned int);
+
+	if (line_length > buffer_size) {
+		new_long_line = (char*)realloc(long_line, line_length * sizeof(char));
+		if (new_long_line == NULL) {
+			throw SorterException("RunSource", "next()", __LINE__, 2, line_length * sizeof(char));
+		}
+		long_line = new_long_line;
+
+		available = (unsigned int)(end - start);
+		memcpy(long_line, start, available);
+		start = end;
+
+		ifile_stream.read(long_line + available, line_length - available);
+		if ((unsigned int)ifile_stream.gcount() != line_length - available) {
+			throw SorterException("RunSource", "next()", __LINE__, 11, file_name);
+		}
+
+		line = long_line;
+	} else {
+		if (!fill(line_length)) {
+			throw SorterException("RunSource", "next()", __LINE__, 11, file_name);
+		}
+
+		line = start;
+		start += line_length;
+	}
+
+	return true;
+}
+
+Sorter::Sorter() : gwafile(NULL), reader(NULL), header(NULL),
+	chr_column_pos(numeric_limits<int>::min()),
+	position_column_pos(numeric_limits<int>::min()),
+	key_columns_number(0),
+	memory(NULL), memory_size(DEFAULT_MEMORY_SIZE),
+	threads_number(get_default_threads_number()), runs_number(0u),
+	o_gwafile_name(NULL), index_format(NULL),
+	chromosome_codes(auxiliary::bool_strcmp), other_chromosomes_number(0u),
+	last_chromosome(NULL), last_chromosome_code(0u),
+	data_separator('\0'), quoted(false) {
+
+}
+
+Sorter::~Sorter() {
+	if (reader != NULL) {
+		try {
+			reader->close();
+		} catch (ReaderException &e) {
+		}
+
+		delete reader;
+		reader = NULL;
+	}
+
+	remove_runs();
+	clear_chromosomes();
+
+	free(header);
+	header = NULL;
+
+	free(memory);
+	memory = NULL;
+
+	free(o_gwafile_name);
+	o_gwafile_name = NULL;
+
+	gwafile = NULL;
+}
+
+unsigned int Sorter::get_default_threads_number() {
+#ifndef WIN32
+	long int processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (processors < 1) {
+		return 1u;
+	}
+
+	if ((unsigned long int)processors > MAX_THREADS_NUMBER) {
+		return MAX_THREADS_NUMBER;
+	}
+
+	return (unsigned int)processors;
+#else
+	return 1u;
+#endif
+}
+
+/* numbered chromosomes come first, then X, Y, XY and MT; an optional 'chr' prefix is ignored */
+unsigned int Sorter::get_chromosome_rank(const char* chromosome) {
+	const char* name = chromosome;
+	unsigned int rank = 0u;
+
+	if ((strlen(name) > 3) && (auxiliary::strcmp_ignore_case(name, "chr", 3) == 0)) {
+		name += 3;
+	}
+
+	if (isdigit(*name)) {
+		while (isdigit(*name)) {
+			rank = rank * 10u + (unsigned int)(*name - '0');
+			if (rank >= OTHER_CHROMOSOMES_RANK - 10u) {
+				return numeric_limits<unsigned int>::max();
+			}
+			++name;
+		}
+
+		return (*name == '\0') ? rank : numeric_limits<unsigned int>::max();
+	}
+
+	if (auxiliary::strcmp_ignore_case(name, "X") == 0) {
+		return OTHER_CHROMOSOMES_RANK - 9u;
+	} else if (auxiliary::strcmp_ignore_case(name, "Y") == 0) {
+		return OTHER_CHROMOSOMES_RANK - 8u;
+	} else if (auxiliary::strcmp_ignore_case(name, "XY") == 0) {
+		return OTHER_CHROMOSOMES_RANK - 7u;
+	} else if ((auxiliary::strcmp_ignore_case(name, "M") == 0) || (auxiliary::strcmp_ignore_case(name, "MT") == 0)) {
+		return OTHER_CHROMOSOMES_RANK - 6u;
+	}
+
+	return numeric_limits<unsigned int>::max();
+}
+
+/* non-numeric and negative positions are placed after all other positions of a chromosome */
+unsigned int Sorter::get_position(const char* value) {
+	char* end_ptr = NULL;
+	long int position = 0l;
+
+	position = auxiliary::fast_strtol(value, &end_ptr);
+	if ((end_ptr == value) || (*end_ptr != '\0') || (position < 0l)) {
+		return MISSING_POSITION;
+	}
+
+	if ((unsigned long int)position >= MISSING_POSITION) {
+		return MISSING_POSITION - 1u;
+	}
+
+	return (unsigned int)position;
+}
+
+bool Sorter::compare_records(const record& first, const record& second) {
+	if (first.key != second.key) {
+		return first.key < second.key;
+	}
+
+	return first.order < second.order;
+}
+
+void* Sorter::sort_records(void* task) {
+	std::sort(((sort_task*)task)->begin, ((sort_task*)task)->end, compare_records);
+
+	return NULL;
+}
+
+/* every distinct chromosome name gets its own code: the rank in the upper 24 bits and the spelling of the rank (e.g. '1' or 'chr1') in the lower 8 bits */
+unsigned int Sorter::get_chromosome_code(const char* chromosome) throw (SorterException) {
+	unsigned int rank = 0u;
+	unsigned int spelling = 0u;
+	unsigned int code = 0u;
+	char* name = NULL;
+
+	if ((last_chromosome != NULL) && (strcmp(last_chromosome, chromosome) == 0)) {
+		return last_chromosome_code;
+	}
+
+	chromosome_codes_it = chromosome_codes.find(chromosome);
+	if (chromosome_codes_it != chromosome_codes.end()) {
+		last_chromosome = chromosome_codes_it->first;
+		last_chromosome_code = chromosome_codes_it->second;
+		return last_chromosome_code;
+	}
+
+	if ((rank = get_chromosome_rank(chromosome)) == numeric_limits<unsigned int>::max()) {
+		rank = OTHER_CHROMOSOMES_RANK + other_chromosomes_number;
+		other_chromosomes_number += 1u;
+	}
+
+	if ((rank >= MISSING_RANK) || ((spelling = chromosome_spellings[rank]) > 0xFFu)) {
+		throw SorterException("Sorter", "get_chromosome_code( const char* )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+	}
+	chromosome_spellings[rank] = spelling + 1u;
+
+	name = (char*)malloc((strlen(chromosome) + 1u) * sizeof(char));
+	if (name == NULL) {
+		throw SorterException("Sorter", "get_chromosome_code( const char* )", __LINE__, 2, (strlen(chromosome) + 1u) * sizeof(char));
+	}
+	strcpy(name, chromosome);
+
+	code = (rank << 8) | spelling;
+	chromosome_codes.insert(pair<const char*, unsigned int>(name, code));
+	chromosome_names.insert(pair<unsigned int, const char*>(code, name));
+
+	last_chromosome = name;
+	last_chromosome_code = code;
+
+	return code;
+}
+
+/* packs chromosome code and position into one integer, so that records are compared without parsing */
+uint64_t Sorter::get_key(char* line) throw (SorterException) {
+	unsigned int code = (MISSING_RANK << 8) | 0xFFu;
+	unsigned int position = MISSING_POSITION;
+
+	auxiliary::split(line, data_separator, fields, key_columns_number, quoted);
+
+	if ((chr_column_pos < (int)fields.size()) && (fields[chr_column_pos][0] != '\0')) {
+		code = get_chromosome_code(fields[chr_column_pos]);
+	}
+
+	if (position_column_pos < (int)fields.size()) {
+		position = get_position(fields[position_column_pos]);
+	}
+
+	return ((uint64_t)code << 32) | position;
+}
+
+void Sorter::clear_chromosomes() {
+	chromosome_codes_it = chromosome_codes.begin();
+	while (chromosome_codes_it != chromosome_codes.end()) {
+		free((char*)chromosome_codes_it->first);
+		chromosome_codes_it++;
+	}
+	chromosome_codes.clear();
+	chromosome_names.clear();
+	chromosome_spellings.clear();
+
+	other_chromosomes_number = 0u;
+	last_chromosome = NULL;
+	last_chromosome_code = 0u;
+}
+
+void Sorter::open_gwafile(GwaFile* gwafile) throw (SorterException) {
+	if (gwafile == NULL) {
+		throw SorterException("Sorter", "open_gwafile( GwaFile* )", __LINE__, 0, "gwafile");
+	}
+
+	try {
+		close_gwafile();
+
+		this->gwafile = gwafile;
+
+		reader = gwafile->create_reader();
+		reader->open();
+	} catch (DescriptorException& e) {
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (GwaFileException& e) {
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (ReaderException& e) {
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (SorterException& e) {
+		e.add_message("Sorter", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
+		throw;
+	}
+}
+
+void Sorter::close_gwafile() throw (SorterException) {
+	try {
+		if (reader != NULL) {
+			reader->close();
+			delete reader;
+			reader = NULL;
+		}
+	} catch (ReaderException &e) {
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "close_gwafile()", __LINE__, 4, (gwafile != NULL) ? gwafile->get_descriptor()->get_full_path() : "NULL");
+		throw new_e;
+	}
+
+	remove_runs();
+	clear_chromosomes();
+
+	free(header);
+	header = NULL;
+
+	free(memory);
+	memory = NULL;
+
+	free(o_gwafile_name);
+	o_gwafile_name = NULL;
+
+	gwafile = NULL;
+}
+
+void Sorter::process_header() throw (SorterException) {
+	Descriptor* descriptor = NULL;
+	char header_separator = '\0';
+	char* line = NULL;
+	char* token = NULL;
+	int column_position = 0;
+	const char* column_name = NULL;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	try {
+		descriptor = gwafile->get_descriptor();
+		header_separator = gwafile->get_header_separator();
+		data_separator = gwafile->get_data_separator();
+		quoted = gwafile->is_quoted();
+
+		if (reader->read_line() <= 0) {
+			throw SorterException("Sorter", "process_header()", __LINE__, 5, 1, descriptor->get_name());
+		}
+
+		line = *(reader->line);
+
+		free(header);
+		header = (char*)malloc((strlen(line) + 1u) * sizeof(char));
+		if (header == NULL) {
+			throw SorterException("Sorter", "process_header()", __LINE__, 2, (strlen(line) + 1u) * sizeof(char));
+		}
+		strcpy(header, line);
+
+		chr_column_pos = numeric_limits<int>::min();
+		position_column_pos = numeric_limits<int>::min();
+
+		token = auxiliary::strtok(&line, header_separator, quoted);
+		while (token != NULL) {
+			column_name = descriptor->get_default_column(token, gwafile->is_case_sensitive());
+			if (column_name != NULL) {
+				if (strcmp(column_name, Descriptor::CHR) == 0) {
+					chr_column_pos = column_position;
+				} else if (strcmp(column_name, Descriptor::POSITION) == 0) {
+					position_column_pos = column_position;
+				}
+			}
+			token = auxiliary::strtok(&line, header_separator, quoted);
+			++column_position;
+		}
+
+		if (chr_column_pos < 0) {
+			throw SorterException("Sorter", "process_header()", __LINE__, 7, ((column_name = descriptor->get_column(Descriptor::CHR)) != NULL) ? column_name : Descriptor::CHR, descriptor->get_name());
+		}
+
+		if (position_column_pos < 0) {
+			throw SorterException("Sorter", "process_header()", __LINE__, 7, ((column_name = descriptor->get_column(Descriptor::POSITION)) != NULL) ? column_name : Descriptor::POSITION, descriptor->get_name());
+		}
+
+		key_columns_number = (chr_column_pos > position_column_pos ? chr_column_pos : position_column_pos) + 1;
+	} catch (ReaderException &e) {
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "process_header()", __LINE__, 6, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	} catch (DescriptorException &e) {
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "process_header()", __LINE__, 6, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	} catch (SorterException &e) {
+		e.add_message("Sorter", "process_header()", __LINE__, 6, gwafile->get_descriptor()->get_name());
+		throw;
+	}
+}
+
+/* temporary runs are written next to the output file */
+Writer* Sorter::create_run() throw (SorterException) {
+	Writer* writer = NULL;
+	char* run_file_name = NULL;
+
+	run_file_name = (char*)malloc((strlen(o_gwafile_name) + 32u) * sizeof(char));
+	if (run_file_name == NULL) {
+		throw SorterException("Sorter", "create_run()", __LINE__, 2, (strlen(o_gwafile_name) + 32u) * sizeof(char));
+	}
+	sprintf(run_file_name, "%s.sort%u.tmp", o_gwafile_name, runs_number);
+	run_file_names.push_back(run_file_name);
+	runs_number += 1u;
+
+	try {
+		writer = new TextWriter(1024u);
+		writer->set_file_name(run_file_name);
+		writer->open();
+	} catch (WriterException &e) {
+		delete writer;
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "create_run()", __LINE__, 10, run_file_name);
+		throw new_e;
+	}
+
+	return writer;
+}
+
+void Sorter::remove_run(const char* run_file_name) {
+	remove(run_file_name);
+}
+
+void Sorter::remove_runs() {
+	vector<char*>::iterator run_file_names_it;
+
+	for (run_file_names_it = run_file_names.begin(); run_file_names_it != run_file_names.end(); run_file_names_it++) {
+		remove_run(*run_file_names_it);
+		free(*run_file_names_it);
+	}
+	run_file_names.clear();
+
+	runs_number = 0u;
+}
+
+void Sorter::write_record(Writer* writer, SortSource* source, bool last) throw (SorterException, WriterException) {
+	map<unsigned int, const char*>::iterator chromosome_names_it;
+	unsigned int position = 0u;
+
+	if (!last) {
+		writer->put_bytes((const char*)&source->key, sizeof(uint64_t));
+		writer->put_bytes((const char*)&source->line_length, sizeof(unsigned int));
+		writer->put_bytes(source->line, source->line_length);
+		return;
+	}
+
+	writer->put_bytes(source->line, source->line_length);
+	writer->put_char('\n');
+
+	if (index_format != NULL) {
+		position = (unsigned int)(source->key & 0xFFFFFFFFu);
+		if ((source->key >> 40) == MISSING_RANK) {
+			writer->index_record(NULL, -1l);
+		} else if ((chromosome_names_it = chromosome_names.find((unsigned int)(source->key >> 32))) != chromosome_names.end()) {
+			writer->index_record(chromosome_names_it->second, position == MISSING_POSITION ? -1l : (long int)position);
+		} else {
+			throw SorterException("Sorter", "write_record( Writer*, SortSource*, bool )", __LINE__, 1, "source");
+		}
+	}
+}
+
+void Sorter::merge(vector<SortSource*>& sources, Writer* writer, bool last) throw (SorterException) {
+	SortSource* source = NULL;
+
+	try {
+		LoserTree tree(&sources[0], sources.size());
+
+		tree.start();
+		while ((source = tree.top()) != NULL) {
+			write_record(writer, source, last);
+			tree.pop();
+		}
+	} catch (WriterException &e) {
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "merge( vector<SortSource*>&, Writer*, bool )", __LINE__, last ? 13 : 10, writer->get_file_name());
+		throw new_e;
+	}
+}
+
+/* the run is split into equal parts, which are sorted in parallel and then merged */
+void Sorter::sort_run(record* records, unsigned int records_number, Writer* writer, bool last) throw (SorterException) {
+	sort_task tasks[MAX_THREADS_NUMBER];
+	unsigned int tasks_number = threads_number;
+	vector<SortSource*> sources;
+	vector<SortSource*>::iterator sources_it;
+
+#ifndef WIN32
+	pthread_t threads[MAX_THREADS_NUMBER];
+	bool threads_started[MAX_THREADS_NUMBER];
+#endif
+
+	if (records_number / MIN_TASK_SIZE < tasks_number) {
+		tasks_number = records_number / MIN_TASK_SIZE;
+	}
+
+	if (tasks_number < 1u) {
+		tasks_number = 1u;
+	}
+
+	for (unsigned int i = 0u; i < tasks_number; ++i) {
+		tasks[i].begin = records + (unsigned long int)(((uint64_t)records_number * i) / tasks_number);
+		tasks[i].end = records + (unsigned long int)(((uint64_t)records_number * (i + 1u)) / tasks_number);
+	}
+
+#ifndef WIN32
+	for (unsigned int i = 1u; i < tasks_number; ++i) {
+		threads_started[i] = (pthread_create(&threads[i], NULL, sort_records, &tasks[i]) == 0);
+	}
+
+	sort_records(&tasks[0]);
+
+	for (unsigned int i = 1u; i < tasks_number; ++i) {
+		if (threads_started[i]) {
+			pthread_join(threads[i], NULL);
+		} else {
+			sort_records(&tasks[i]);
+		}
+	}
+#else
+	for (unsigned int i = 0u; i < tasks_number; ++i) {
+		sort_records(&tasks[i]);
+	}
+#endif
+
+	try {
+		for (unsigned int i = 0u; i < tasks_number; ++i) {
+			sources.push_back(new RecordSource(tasks[i].begin, tasks[i].end));
+		}
+
+		merge(sources, writer, last);
+	} catch (SorterException &e) {
+		for (sources_it = sources.begin(); sources_it != sources.end(); sources_it++) {
+			delete *sources_it;
+		}
+		throw;
+	}
+
+	for (sources_it = sources.begin(); sources_it != sources.end(); sources_it++) {
+		delete *sources_it;
+	}
+}
+
+/* runs are merged in groups of at most MAX_RUNS_NUMBER, until one group remains; the sorting memory is shared by the group's read buffers */
+void Sorter::merge_runs(Writer* writer) throw (SorterException) {
+	vector<const char*> runs;
+	vector<const char*> merged_runs;
+	vector<const char*>::iterator runs_it;
+	vector<SortSource*> sources;
+	vector<SortSource*>::iterator sources_it;
+	Writer* run_writer = NULL;
+	unsigned int max_runs_number = MAX_RUNS_NUMBER;
+	unsigned int buffer_size = 0u;
+	unsigned int group_end = 0u;
+	bool last = false;
+
+	if (memory_size / MIN_RUN_BUFFER_SIZE < max_runs_number) {
+		max_runs_number = (unsigned int)(memory_size / MIN_RUN_BUFFER_SIZE);
+	}
+	buffer_size = (unsigned int)(memory_size / max_runs_number);
+
+	runs.assign(run_file_names.begin(), run_file_names.end());
+
+	try {
+		do {
+			last = runs.size() <= max_runs_number;
+			merged_runs.clear();
+
+			for (unsigned int group_start = 0u; group_start < runs.size(); group_start = group_end) {
+				group_end = group_start + max_runs_number < runs.size() ? group_start + max_runs_number : runs.size();
+
+				if (!last && (group_end - group_start == 1u)) {
+					merged_runs.push_back(runs[group_start]);
+					continue;
+				}
+
+				for (unsigned int i = group_start; i < group_end; ++i) {
+					sources.push_back(new RunSource(runs[i], memory + (unsigned long int)(i - group_start) * buffer_size, buffer_size));
+				}
+
+				if (last) {
+					merge(sources, writer, true);
+				} else {
+					run_writer = create_run();
+					merged_runs.push_back(run_file_names.back());
+					merge(sources, run_writer, false);
+					run_writer->close();
+					delete run_writer;
+					run_writer = NULL;
+				}
+
+				for (sources_it = sources.begin(); sources_it != sources.end(); sources_it++) {
+					delete *sources_it;
+				}
+				sources.clear();
+
+				for (unsigned int i = group_start; i < group_end; ++i) {
+					remove_run(runs[i]);
+				}
+			}
+
+			runs.assign(merged_runs.begin(), merged_runs.end());
+		} while (!last);
+	} catch (WriterException &e) {
+		for (sources_it = sources.begin(); sources_it != sources.end(); sources_it++) {
+			delete *sources_it;
+		}
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "merge_runs( Writer* )", __LINE__, 10, run_writer->get_file_name());
+		delete run_writer;
+		throw new_e;
+	} catch (SorterException &e) {
+		for (sources_it = sources.begin(); sources_it != sources.end(); sources_it++) {
+			delete *sources_it;
+		}
+		delete run_writer;
+		throw;
+	}
+}
+
+void Sorter::sort() throw (SorterException) {
+	Descriptor* descriptor = NULL;
+	const char* output_prefix = NULL;
+	const char* file_name = NULL;
+	const char* memory_property = NULL;
+	const char* compression = NULL;
+
+	Writer* writer = NULL;
+	Writer* run_writer = NULL;
+
+	record* records = NULL;
+	unsigned int records_number = 0u;
+	char* lines_start = NULL;
+
+	char* line = NULL;
+	int line_length = 0;
+	unsigned long int line_number = 1ul;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	try {
+		descriptor = gwafile->get_descriptor();
+		output_prefix = descriptor->get_property(Descriptor::PREFIX);
+		file_name = descriptor->get_name();
+
+		free(o_gwafile_name);
+		o_gwafile_name = NULL;
+		index_format = gwafile->get_index_format();
+		compression = gwafile->get_compression();
+		if ((compression != NULL) && ((strlen(file_name) < 3) || (strcmp(file_name + strlen(file_name) - 3, ".gz") != 0))) {
+			auxiliary::transform_file_name(&o_gwafile_name, output_prefix, file_name, ".gz", true);
+		} else {
+			auxiliary::transform_file_name(&o_gwafile_name, output_prefix, file_name, NULL, true);
+		}
+		if (o_gwafile_name == NULL) {
+			throw SorterException("Sorter", "sort()", __LINE__, 16);
+		}
+
+		if ((index_format != NULL) && (data_separator != '\t')) {
+			throw SorterException("Sorter", "sort()", __LINE__, 15, o_gwafile_name);
+		}
+
+		memory_size = DEFAULT_MEMORY_SIZE;
+		if ((memory_property = descriptor->get_property(Descriptor::SORT_MEMORY)) != NULL) {
+			memory_size = strtoul(memory_property, NULL, 10);
+			memory_size = memory_size < (numeric_limits<unsigned long int>::max() >> 20) ? memory_size << 20 : DEFAULT_MEMORY_SIZE;
+		}
+
+		if (memory_size < MIN_MEMORY_SIZE) {
+			memory_size = MIN_MEMORY_SIZE;
+		}
+
+		free(memory);
+		memory = (char*)malloc(memory_size * sizeof(char));
+		if (memory == NULL) {
+			throw SorterException("Sorter", "sort()", __LINE__, 2, memory_size * sizeof(char));
+		}
+
+		/* records grow from the beginning of the memory and their lines from the end */
+		records = (record*)memory;
+		lines_start = memory + memory_size;
+
+		while ((line_length = reader->read_line()) >= 0) {
+			line_number += 1ul;
+
+			if (line_length == 0) {
+				throw SorterException("Sorter", "sort()", __LINE__, 8, line_number, file_name);
+			}
+
+			if (sizeof(record) + line_length > memory_size) {
+				throw SorterException("Sorter", "sort()", __LINE__, 9, line_number, file_name, memory_size);
+			}
+
+			if ((char*)(records + records_number + 1u) + line_length > lines_start) {
+				run_writer = create_run();
+				sort_run(records, records_number, run_writer, false);
+				run_writer->close();
+				delete run_writer;
+				run_writer = NULL;
+
+				records_number = 0u;
+				lines_start = memory + memory_size;
+			}
+
+			line = *(reader->line);
+
+			lines_start -= line_length;
+			memcpy(lines_start, line, line_length);
+
+			records[records_number].key = get_key(line);
+			records[records_number].line = lines_start;
+			records[records_number].line_length = (unsigned int)line_length;
+			records[records_number].order = records_number;
+			records_number += 1u;
+		}
+
+		if ((records_number > 0u) && (!run_file_names.empty())) {
+			run_writer = create_run();
+			sort_run(records, records_number, run_writer, false);
+			run_writer->close();
+			delete run_writer;
+			run_writer = NULL;
+		}
+
+		writer = WriterFactory::create_async(compression != NULL ? compression : WriterFactory::TEXT);
+		writer->set_file_name(o_gwafile_name);
+		writer->open();
+
+		writer->put_str(header);
+		writer->put_char('\n');
+
+		if (index_format != NULL) {
+			writer->set_index(index_format, chr_column_pos + 1, position_column_pos + 1);
+		}
+
+		if (run_file_names.empty()) {
+			sort_run(records, records_number, writer, true);
+		} else {
+			merge_runs(writer);
+		}
+
+		writer->close();
+		delete writer;
+		writer = NULL;
+
+		remove_runs();
+
+		free(memory);
+		memory = NULL;
+	} catch (ReaderException &e) {
+		delete run_writer;
+		delete writer;
+		remove_runs();
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "sort()", __LINE__, 12, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	} catch (WriterException &e) {
+		SorterException new_e(e);
+		new_e.add_message("Sorter", "sort()", __LINE__, run_writer != NULL ? 10 : 13, run_writer != NULL ? run_writer->get_file_name() : o_gwafile_name);
+		delete run_writer;
+		delete writer;
+		remove_runs();
+		throw new_e;
+	} catch (SorterException &e) {
+		delete run_writer;
+		delete writer;
+		remove_runs();
+		e.add_message("Sorter", "sort()", __LINE__, 12, gwafile->get_descriptor()->get_name());
+		throw;
+	}
+}
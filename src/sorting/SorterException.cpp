@@ -0,0 +1,81 @@
+/*
+ * Copyright  2012 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/SorterException.h"
+
+const int SorterException::MESSAGE_TEMPLATES_NUMBER = 17;
+const char* SorterException::MESSAGE_TEMPLATES[] = {
+/*00*/	"The '%s' argument has NULL value.",
+/*01*/	"The '%s' argument has an invalid value.",
+/*02*/	"Memory allocation error (%lu bytes).",
+/*03*/	"Error while opening '%s' file.",
+/*04*/	"Error while closing '%s' file.",
+/*05*/	"The header is missing on line %d in '%s' file.",
+/*06*/	"Error while processing header in '%s' file.",
+/*07*/	"Column '%s' is missing in the header of '%s' file.",
+/*08*/	"Line %lu in '%s' file is empty.",
+/*09*/	"Line %lu in '%s' file does not fit into the sorting memory (%lu bytes).",
+/*10*/	"Error while writing '%s' temporary file.",
+/*11*/	"Error while reading '%s' temporary file.",
+/*12*/	"Error while sorting '%s' file.",
+/*13*/	"Error while writing '%s' file.",
+/*14*/	"Too many distinct chromosome names in '%s' file.",
+/*15*/	"The '%s' file must be tab-delimited to be indexed.",
+/*16*/	"Error while initializing output file name."
+};
+
+SorterException::SorterException() : Exception() {
+
+}
+
+SorterException::SorterException(int message_template_index, ... ) : Exception()  {
+	va_list arguments;
+
+	va_start(arguments, message_template_index);
+	add_message(message_template_index, arguments);
+	va_end(arguments);
+}
+
+SorterException::SorterException(const char* class_name, const char* method_name, int source_line) : Exception(class_name, method_name, source_line)  {
+
+}
+
+SorterException::SorterException(const char* class_name, const char* method_name, int source_line, int message_template_index, ... ) : Exception() {
+	va_list arguments;
+
+	va_start(arguments, message_template_index);
+	add_message(class_name, method_name, source_line, message_template_index, arguments);
+	va_end(arguments);
+}
+
+SorterException::SorterException(const Exception& exception) : Exception(exception) {
+
+}
+
+SorterException::~SorterException() throw() {
+
+}
+
+const char* SorterException::get_message_template(int message_template_index) {
+	if ((message_template_index >= 0) && (message_template_index < MESSAGE_TEMPLATES_NUMBER)) {
+		return  MESSAGE_TEMPLATES[message_template_index];
+	}
+
+	return NULL;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright  2012 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOSERTREE_H_
+#define LOSERTREE_H_
+
+#include "SorterException.h"
+#include "../../auxiliary/include/auxiliary.h"
+
+using namespace std;
+
+class SortSource {
+public:
+	uint64_t key;
+	const char* line;
+	unsigned int line_length;
+
+	SortSource();
+	virtual ~SortSource();
+
+	virtual bool next() throw (SorterException) = 0;
+};
+
+class LoserTree {
+private:
+	SortSource** sources;
+	unsigned int sources_number;
+
+	unsigned int* tree;
+	bool* exhausted;
+
+	bool beats(unsigned int first, unsigned int second);
+	unsigned int build(unsigned int node);
+
+public:
+	LoserTree(SortSource** sources, unsigned int sources_number) throw (SorterException);
+	virtual ~LoserTree();
+
+	void start() throw (SorterException);
+	SortSource* top();
+	void pop() throw (SorterException);
+};
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright  2012 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SORTER_H_
+#define SORTER_H_
+
+#include <map>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#include "SorterException.h"
+#include "LoserTree.h"
+#include "../../gwafile/include/GwaFile.h"
+#include "../../writer/include/WriterFactory.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+class Sorter {
+private:
+	struct record {
+		uint64_t key;
+		const char* line;
+		unsigned int line_length;
+		unsigned int order;
+	};
+
+	struct sort_task {
+		record* begin;
+		record* end;
+	};
+
+	class RecordSource : public SortSource {
+	private:
+		record* current;
+		record* end;
+
+	public:
+		RecordSource(record* begin, record* end);
+		virtual ~RecordSource();
+
+		bool next() throw (SorterException);
+	};
+
+	class RunSource : public SortSource {
+	private:
+		const char* file_name;
+		ifstream ifile_stream;
+
+		char* buffer;
+		unsigned int buffer_size;
+		char* start;
+		char* end;
+
+		char* long_line;
+
+		bool fill(unsigned int needed) throw (SorterException);
+
+	public:
+		RunSource(const char* file_name, char* buffer, unsigned int buffer_size) throw (SorterException);
+		virtual ~RunSource();
+
+		bool next() throw (SorterException);
+	};
+
+	GwaFile* gwafile;
+	Reader* reader;
+
+	char* header;
+
+	int chr_column_pos;
+	int position_column_pos;
+	int key_columns_number;
+
+	char* memory;
+	unsigned long int memory_size;
+
+	unsigned int threads_number;
+	unsigned int runs_number;
+
+	char* o_gwafile_name;
+	const char* index_format;
+
+	vector<char*> run_file_names;
+
+	map<const char*, unsigned int, bool(*)(const char*, const char*)> chromosome_codes;
+	map<const char*, unsigned int, bool(*)(const char*, const char*)>::iterator chromosome_codes_it;
+	map<unsigned int, const char*> chromosome_names;
+	map<unsigned int, unsigned int> chromosome_spellings;
+	unsigned int other_chromosomes_number;
+	const char* last_chromosome;
+	unsigned int last_chromosome_code;
+
+	char data_separator;
+	bool quoted;
+	vector<char*> fields;
+
+	static const unsigned int OTHER_CHROMOSOMES_RANK;
+	static const unsigned int MISSING_RANK;
+	static const unsigned int MISSING_POSITION;
+
+	static unsigned int get_default_threads_number();
+	static unsigned int get_chromosome_rank(const char* chromosome);
+	static unsigned int get_position(const char* value);
+	static bool compare_records(const record& first, const record& second);
+	static void* sort_records(void* task);
+
+	unsigned int get_chromosome_code(const char* chromosome) throw (SorterException);
+	uint64_t get_key(char* line) throw (SorterException);
+
+	void sort_run(record* records, unsigned int records_number, Writer* writer, bool last) throw (SorterException);
+	void merge_runs(Writer* writer) throw (SorterException);
+	void merge(vector<SortSource*>& sources, Writer* writer, bool last) throw (SorterException);
+	void write_record(Writer* writer, SortSource* source, bool last) throw (SorterException, WriterException);
+	Writer* create_run() throw (SorterException);
+	void remove_run(const char* run_file_name);
+	void remove_runs();
+	void clear_chromosomes();
+
+public:
+	static const unsigned long int DEFAULT_MEMORY_SIZE;
+	static const unsigned long int MIN_MEMORY_SIZE;
+	static const unsigned int MAX_THREADS_NUMBER;
+	static const unsigned int MIN_TASK_SIZE;
+	static const unsigned int MAX_RUNS_NUMBER;
+	static const unsigned int MIN_RUN_BUFFER_SIZE;
+
+	Sorter();
+	virtual ~Sorter();
+
+	void open_gwafile(GwaFile* gwafile) throw (SorterException);
+	void close_gwafile() throw (SorterException);
+
+	void process_header() throw (SorterException);
+	void sort() throw (SorterException);
+};
+
+#endif
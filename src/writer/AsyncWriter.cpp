@@ -0,0 +1,259 @@
+#include "include/AsyncWriter.h"
+
+const unsigned int AsyncWriter::DEFAULT_BUFFER_SIZE = 16777216;
+const unsigned int AsyncWriter::DEFAULT_SLOTS_NUMBER = 4;
+
+AsyncWriter::AsyncWriter(Writer* writer, unsigned int buffer_size, unsigned int slots_number) throw (WriterException) :
+	writer(writer), buffer(NULL), error(NULL)
+#ifndef WIN32
+	, thread_running(false), thread_stop(false), slots_number(slots_number), slots(NULL), queued(0ul), written(0ul)
+#endif
+	{
+
+	if (writer == NULL) {
+		throw WriterException("AsyncWriter", "AsyncWriter( Writer*, unsigned int, unsigned int )", __LINE__, 0, "writer");
+	}
+
+	buffer = (char*)malloc((buffer_size + 1u) * sizeof(char));
+	if (buffer == NULL) {
+		throw WriterException("AsyncWriter", "AsyncWriter( Writer*, unsigned int, unsigned int )", __LINE__, 2, (buffer_size + 1u) * sizeof(char));
+	}
+
+	buffer[0] = '\0';
+
+#ifndef WIN32
+	if (this->slots_number == 0u) {
+		this->slots_number = 1u;
+	}
+
+	slots = (output_slot*)malloc(this->slots_number * sizeof(output_slot));
+	if (slots == NULL) {
+		throw WriterException("AsyncWriter", "AsyncWriter( Writer*, unsigned int, unsigned int )", __LINE__, 2, this->slots_number * sizeof(output_slot));
+	}
+
+	for (unsigned int i = 0u; i < this->slots_number; ++i) {
+		slots[i].data = (char*)malloc(OUTPUT_BUFFER_SIZE * sizeof(char));
+		if (slots[i].data == NULL) {
+			throw WriterException("AsyncWriter", "AsyncWriter( Writer*, unsigned int, unsigned int )", __LINE__, 2, OUTPUT_BUFFER_SIZE * sizeof(char));
+		}
+		slots[i].length = 0u;
+	}
+
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&slots_queued, NULL);
+	pthread_cond_init(&slots_written, NULL);
+#endif
+}
+
+AsyncWriter::~AsyncWriter() {
+#ifndef WIN32
+	stop_thread();
+
+	pthread_cond_destroy(&slots_written);
+	pthread_cond_destroy(&slots_queued);
+	pthread_mutex_destroy(&mutex);
+
+	if (slots != NULL) {
+		for (unsigned int i = 0u; i < slots_number; ++i) {
+			free(slots[i].data);
+		}
+		free(slots);
+		slots = NULL;
+	}
+#endif
+
+	delete error;
+	error = NULL;
+
+	delete writer;
+	writer = NULL;
+
+	free(buffer);
+	buffer = NULL;
+}
+
+void AsyncWriter::rethrow_error() throw (WriterException) {
+	WriterException* thread_error = NULL;
+
+#ifndef WIN32
+	pthread_mutex_lock(&mutex);
+#endif
+	thread_error = error;
+	error = NULL;
+#ifndef WIN32
+	pthread_mutex_unlock(&mutex);
+#endif
+
+	if (thread_error != NULL) {
+		WriterException new_e(*thread_error);
+		delete thread_error;
+		new_e.add_message("AsyncWriter", "rethrow_error()", __LINE__, 4, file_name);
+		throw new_e;
+	}
+}
+
+#ifndef WIN32
+AsyncWriter::output_slot* AsyncWriter::acquire_slot() throw (WriterException) {
+	bool failed = false;
+
+	pthread_mutex_lock(&mutex);
+	while ((error == NULL) && (queued - written >= slots_number)) {
+		pthread_cond_wait(&slots_written, &mutex);
+	}
+	failed = (error != NULL);
+	pthread_mutex_unlock(&mutex);
+
+	if (failed) {
+		rethrow_error();
+	}
+
+	return &slots[queued % slots_number];
+}
+
+void AsyncWriter::queue_slot() {
+	pthread_mutex_lock(&mutex);
+	queued += 1ul;
+	pthread_cond_signal(&slots_queued);
+	pthread_mutex_unlock(&mutex);
+}
+
+void AsyncWriter::stop_thread() {
+	if (thread_running) {
+		pthread_mutex_lock(&mutex);
+		thread_stop = true;
+		pthread_cond_signal(&slots_queued);
+		pthread_mutex_unlock(&mutex);
+
+		pthread_join(thread, NULL);
+		thread_running = false;
+	}
+}
+
+/* after a failure the remaining slots are dropped, and the error waits for the producer */
+void* AsyncWriter::write_slots(void* writer) {
+	AsyncWriter* async_writer = (AsyncWriter*)writer;
+	output_slot* slot = NULL;
+	bool failed = false;
+
+	pthread_mutex_lock(&async_writer->mutex);
+	while (true) {
+		while (!async_writer->thread_stop && (async_writer->written >= async_writer->queued)) {
+			pthread_cond_wait(&async_writer->slots_queued, &async_writer->mutex);
+		}
+
+		if (async_writer->written >= async_writer->queued) {
+			break;
+		}
+
+		slot = &async_writer->slots[async_writer->written % async_writer->slots_number];
+		failed = (async_writer->error != NULL);
+		pthread_mutex_unlock(&async_writer->mutex);
+
+		if (!failed) {
+			try {
+				async_writer->writer->put_bytes(slot->data, slot->length);
+			} catch (WriterException &e) {
+				pthread_mutex_lock(&async_writer->mutex);
+				async_writer->error = new WriterException(e);
+				pthread_mutex_unlock(&async_writer->mutex);
+			}
+		}
+
+		pthread_mutex_lock(&async_writer->mutex);
+		async_writer->written += 1ul;
+		pthread_cond_broadcast(&async_writer->slots_written);
+	}
+	pthread_mutex_unlock(&async_writer->mutex);
+
+	return NULL;
+}
+#endif
+
+void AsyncWriter::open() throw (WriterException) {
+#ifndef WIN32
+	if (thread_running) {
+		close();
+	}
+#endif
+
+	delete error;
+	error = NULL;
+
+	reset_output();
+
+	writer->set_file_name(file_name);
+	writer->open();
+
+#ifndef WIN32
+	queued = 0ul;
+	written = 0ul;
+	thread_stop = false;
+
+	/* without a thread the output is passed on synchronously */
+	thread_running = (pthread_create(&thread, NULL, write_slots, this) == 0);
+#endif
+}
+
+void AsyncWriter::close() throw (WriterException) {
+	flush();
+
+#ifndef WIN32
+	stop_thread();
+#endif
+
+	rethrow_error();
+
+	writer->close();
+
+	save_index();
+}
+
+void AsyncWriter::write(const char* format, ...) throw (WriterException) {
+	va_list arguments;
+	int length = 0;
+
+	va_start(arguments, format);
+	if ((length = vsprintf(buffer, format, arguments)) < 0) {
+		throw WriterException("AsyncWriter", "write( const char* )", __LINE__, 4, file_name);
+	}
+	va_end(arguments);
+
+	append(buffer, length);
+}
+
+void AsyncWriter::write_output(const char* data, unsigned int length) throw (WriterException) {
+#ifndef WIN32
+	output_slot* slot = NULL;
+	char* free_data = NULL;
+	unsigned int chunk = 0u;
+
+	if (thread_running) {
+		if (data == output) {
+			/* a flushed output buffer is exchanged with the free slot instead of being copied */
+			slot = acquire_slot();
+			free_data = slot->data;
+			slot->data = output;
+			slot->length = length;
+			output = free_data;
+			queue_slot();
+		} else {
+			while (length > 0u) {
+				slot = acquire_slot();
+				chunk = (length < OUTPUT_BUFFER_SIZE) ? length : OUTPUT_BUFFER_SIZE;
+				memcpy(slot->data, data, chunk);
+				slot->length = chunk;
+				queue_slot();
+				data += chunk;
+				length -= chunk;
+			}
+		}
+		return;
+	}
+#endif
+
+	writer->put_bytes(data, length);
+}
+
+const vector<uint64_t>* AsyncWriter::get_block_offsets() {
+	return writer->get_block_offsets();
+}
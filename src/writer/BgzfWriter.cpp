@@ -0,0 +1,415 @@
+#include "include/BgzfWriter.h"
+
+const unsigned int BgzfWriter::DEFAULT_BUFFER_SIZE = 16777216;
+const unsigned int BgzfWriter::BLOCK_SIZE = 65280;
+const unsigned int BgzfWriter::MAX_BLOCK_SIZE = 65536;
+const unsigned int BgzfWriter::SLOTS_PER_THREAD = 4;
+const unsigned int BgzfWriter::MAX_THREADS_NUMBER = 16;
+const int BgzfWriter::DEFAULT_LEVEL = Z_DEFAULT_COMPRESSION;
+
+/* gzip header with the 'BC' extra subfield; bytes 16 and 17 receive the block size minus one */
+static const unsigned char BGZF_HEADER[18] = { 0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x06, 0x00, 'B', 'C', 0x02, 0x00, 0x00, 0x00 };
+static const unsigned char BGZF_EOF[28] = { 0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x06, 0x00, 'B', 'C', 0x02, 0x00, 0x1b, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+BgzfWriter::BgzfWriter(unsigned int buffer_size, int level, unsigned int threads_number) throw (WriterException) :
+	buffer(NULL), level(level), stream_ready(false), threads_number(threads_number), running_threads_number(0u),
+#ifndef WIN32
+	threads(NULL), threads_stop(false),
+#endif
+	slots_number(0u), slots(NULL), queued(0ul), claimed(0ul), written(0ul), compressed_offset(0u) {
+
+	if ((level < Z_DEFAULT_COMPRESSION) || (level > Z_BEST_COMPRESSION)) {
+		throw WriterException("BgzfWriter", "BgzfWriter( unsigned int, int, unsigned int )", __LINE__, 1, "level");
+	}
+
+	buffer = (char*)malloc((buffer_size + 1u) * sizeof(char));
+	if (buffer == NULL) {
+		throw WriterException("BgzfWriter", "BgzfWriter( unsigned int, int, unsigned int )", __LINE__, 2, (buffer_size + 1u) * sizeof(char));
+	}
+
+	buffer[0] = '\0';
+
+	if (this->threads_number == 0u) {
+		this->threads_number = get_default_threads_number();
+	}
+
+	slots_number = this->threads_number * SLOTS_PER_THREAD;
+
+#ifndef WIN32
+	threads = (pthread_t*)malloc(this->threads_number * sizeof(pthread_t));
+	if (threads == NULL) {
+		throw WriterException("BgzfWriter", "BgzfWriter( unsigned int, int, unsigned int )", __LINE__, 2, this->threads_number * sizeof(pthread_t));
+	}
+#endif
+
+	slots = (bgzf_block*)malloc(slots_number * sizeof(bgzf_block));
+	if (slots == NULL) {
+		throw WriterException("BgzfWriter", "BgzfWriter( unsigned int, int, unsigned int )", __LINE__, 2, slots_number * sizeof(bgzf_block));
+	}
+
+	for (unsigned int i = 0u; i < slots_number; ++i) {
+		slots[i].uncompressed = (char*)malloc(BLOCK_SIZE * sizeof(char));
+		slots[i].compressed = (char*)malloc(MAX_BLOCK_SIZE * sizeof(char));
+		if ((slots[i].uncompressed == NULL) || (slots[i].compressed == NULL)) {
+			throw WriterException("BgzfWriter", "BgzfWriter( unsigned int, int, unsigned int )", __LINE__, 2, MAX_BLOCK_SIZE * sizeof(char));
+		}
+		slots[i].uncompressed_length = 0u;
+		slots[i].compressed_length = 0u;
+		slots[i].deflated = false;
+		slots[i].failed = false;
+	}
+
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	stream_ready = (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+
+#ifndef WIN32
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&blocks_queued, NULL);
+	pthread_cond_init(&blocks_deflated, NULL);
+#endif
+}
+
+BgzfWriter::~BgzfWriter() {
+	stop_threads();
+
+	if (ofile_stream.is_open()) {
+		ofile_stream.close();
+	}
+
+#ifndef WIN32
+	pthread_cond_destroy(&blocks_deflated);
+	pthread_cond_destroy(&blocks_queued);
+	pthread_mutex_destroy(&mutex);
+
+	free(threads);
+	threads = NULL;
+#endif
+
+	if (stream_ready) {
+		deflateEnd(&stream);
+		stream_ready = false;
+	}
+
+	if (slots != NULL) {
+		for (unsigned int i = 0u; i < slots_number; ++i) {
+			free(slots[i].uncompressed);
+			free(slots[i].compressed);
+		}
+		free(slots);
+		slots = NULL;
+	}
+
+	free(buffer);
+	buffer = NULL;
+}
+
+unsigned int BgzfWriter::get_default_threads_number() {
+#ifndef WIN32
+	long int processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (processors < 1) {
+		return 1u;
+	}
+
+	if ((unsigned long int)processors > MAX_THREADS_NUMBER) {
+		return MAX_THREADS_NUMBER;
+	}
+
+	return (unsigned int)processors;
+#else
+	return 1u;
+#endif
+}
+
+void BgzfWriter::start_threads() throw (WriterException) {
+	running_threads_number = 0u;
+
+#ifndef WIN32
+	/* with a single thread the blocks are deflated in place */
+	if (threads_number < 2u) {
+		return;
+	}
+
+	threads_stop = false;
+
+	while (running_threads_number < threads_number) {
+		if (pthread_create(&threads[running_threads_number], NULL, deflate_blocks, this) != 0) {
+			stop_threads();
+			throw WriterException("BgzfWriter", "start_threads()", __LINE__, 6, "BGZF");
+		}
+		running_threads_number += 1u;
+	}
+#endif
+}
+
+void BgzfWriter::stop_threads() {
+#ifndef WIN32
+	pthread_mutex_lock(&mutex);
+	threads_stop = true;
+	pthread_cond_broadcast(&blocks_queued);
+	pthread_mutex_unlock(&mutex);
+
+	for (unsigned int i = 0u; i < running_threads_number; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+#endif
+	running_threads_number = 0u;
+}
+
+bool BgzfWriter::deflate_block(z_stream* stream, bgzf_block* slot) {
+	unsigned char* block = (unsigned char*)slot->compressed;
+	unsigned long int crc = 0ul;
+	unsigned int length = 0u;
+
+	if (deflateReset(stream) != Z_OK) {
+		return false;
+	}
+
+	stream->next_in = (Bytef*)slot->uncompressed;
+	stream->avail_in = slot->uncompressed_length;
+	stream->next_out = (Bytef*)(block + 18);
+	stream->avail_out = MAX_BLOCK_SIZE - 18u - 8u;
+
+	if (deflate(stream, Z_FINISH) != Z_STREAM_END) {
+		return false;
+	}
+
+	length = 18u + stream->total_out + 8u;
+
+	memcpy(block, BGZF_HEADER, 18u);
+	block[16] = (unsigned char)((length - 1u) & 0xff);
+	block[17] = (unsigned char)((length - 1u) >> 8);
+
+	crc = crc32(crc32(0ul, Z_NULL, 0), (const Bytef*)slot->uncompressed, slot->uncompressed_length);
+
+	block += 18u + stream->total_out;
+	block[0] = (unsigned char)(crc & 0xff);
+	block[1] = (unsigned char)((crc >> 8) & 0xff);
+	block[2] = (unsigned char)((crc >> 16) & 0xff);
+	block[3] = (unsigned char)((crc >> 24) & 0xff);
+	block[4] = (unsigned char)(slot->uncompressed_length & 0xff);
+	block[5] = (unsigned char)((slot->uncompressed_length >> 8) & 0xff);
+	block[6] = 0u;
+	block[7] = 0u;
+
+	slot->compressed_length = length;
+
+	return true;
+}
+
+#ifndef WIN32
+void* BgzfWriter::deflate_blocks(void* writer) {
+	BgzfWriter* bgzf_writer = (BgzfWriter*)writer;
+	bgzf_block* slot = NULL;
+	z_stream stream;
+	bool stream_ready = false;
+	bool success = false;
+
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	stream_ready = (deflateInit2(&stream, bgzf_writer->level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+
+	pthread_mutex_lock(&bgzf_writer->mutex);
+	while (true) {
+		while (!bgzf_writer->threads_stop && (bgzf_writer->claimed >= bgzf_writer->queued)) {
+			pthread_cond_wait(&bgzf_writer->blocks_queued, &bgzf_writer->mutex);
+		}
+
+		if (bgzf_writer->threads_stop) {
+			break;
+		}
+
+		slot = &bgzf_writer->slots[bgzf_writer->claimed % bgzf_writer->slots_number];
+		bgzf_writer->claimed += 1ul;
+		pthread_mutex_unlock(&bgzf_writer->mutex);
+
+		success = stream_ready && deflate_block(&stream, slot);
+
+		pthread_mutex_lock(&bgzf_writer->mutex);
+		slot->failed = !success;
+		slot->deflated = true;
+		pthread_cond_broadcast(&bgzf_writer->blocks_deflated);
+	}
+	pthread_mutex_unlock(&bgzf_writer->mutex);
+
+	if (stream_ready) {
+		deflateEnd(&stream);
+	}
+
+	return NULL;
+}
+#endif
+
+void BgzfWriter::queue_block() {
+	bgzf_block* slot = &slots[queued % slots_number];
+
+	if (running_threads_number == 0u) {
+		slot->failed = !(stream_ready && deflate_block(&stream, slot));
+		slot->deflated = true;
+		queued += 1ul;
+		claimed = queued;
+		return;
+	}
+
+#ifndef WIN32
+	pthread_mutex_lock(&mutex);
+	slot->deflated = false;
+	queued += 1ul;
+	pthread_cond_signal(&blocks_queued);
+	pthread_mutex_unlock(&mutex);
+#endif
+}
+
+/* writes deflated blocks in their original order; waits for all queued blocks, or only until a slot becomes free */
+void BgzfWriter::write_blocks(bool all) throw (WriterException) {
+	bgzf_block* slot = NULL;
+	bool deflated = false;
+
+	while (written < queued) {
+		slot = &slots[written % slots_number];
+
+#ifndef WIN32
+		if (running_threads_number > 0u) {
+			pthread_mutex_lock(&mutex);
+			while (!slot->deflated && (all || (queued - written >= slots_number))) {
+				pthread_cond_wait(&blocks_deflated, &mutex);
+			}
+			deflated = slot->deflated;
+			pthread_mutex_unlock(&mutex);
+		} else {
+			deflated = slot->deflated;
+		}
+#else
+		deflated = slot->deflated;
+#endif
+
+		if (!deflated) {
+			break;
+		}
+
+		if (slot->failed) {
+			throw WriterException("BgzfWriter", "write_blocks( bool )", __LINE__, 4, file_name);
+		}
+
+		ofile_stream.write(slot->compressed, slot->compressed_length);
+		if (ofile_stream.fail()) {
+			throw WriterException("BgzfWriter", "write_blocks( bool )", __LINE__, 4, file_name);
+		}
+
+		block_offsets.push_back(compressed_offset);
+		compressed_offset += slot->compressed_length;
+
+		slot->uncompressed_length = 0u;
+		slot->deflated = false;
+		written += 1ul;
+	}
+}
+
+void BgzfWriter::open() throw (WriterException) {
+	if (ofile_stream.is_open()) {
+		close();
+	}
+
+	reset_output();
+
+	queued = 0ul;
+	claimed = 0ul;
+	written = 0ul;
+
+	block_offsets.clear();
+	compressed_offset = 0u;
+
+	for (unsigned int i = 0u; i < slots_number; ++i) {
+		slots[i].uncompressed_length = 0u;
+		slots[i].deflated = false;
+		slots[i].failed = false;
+	}
+
+	ofile_stream.clear();
+	ofile_stream.open(file_name, ios::binary);
+
+	if (ofile_stream.fail()) {
+		throw WriterException("BgzfWriter", "open()", __LINE__, 3, file_name);
+	}
+
+	if (!stream_ready) {
+		throw WriterException("BgzfWriter", "open()", __LINE__, 6, "BGZF");
+	}
+
+	start_threads();
+}
+
+void BgzfWriter::close() throw (WriterException) {
+	if (ofile_stream.is_open()) {
+		flush();
+
+		if (slots[queued % slots_number].uncompressed_length > 0u) {
+			queue_block();
+		}
+
+		write_blocks(true);
+		stop_threads();
+
+		/* end of the data, where a block that would follow the last full one starts */
+		block_offsets.push_back(compressed_offset);
+
+		ofile_stream.write((const char*)BGZF_EOF, 28);
+
+		ofile_stream.clear();
+		ofile_stream.close();
+
+		if (ofile_stream.fail()) {
+			throw WriterException("BgzfWriter", "close()", __LINE__, 5, file_name);
+		}
+
+		save_index();
+	}
+}
+
+void BgzfWriter::write(const char* format, ...) throw (WriterException) {
+	va_list arguments;
+	int length = 0;
+
+	va_start(arguments, format);
+	if ((length = vsprintf(buffer, format, arguments)) < 0) {
+		throw WriterException("BgzfWriter", "write( const char* )", __LINE__, 4, file_name);
+	}
+	va_end(arguments);
+
+	append(buffer, length);
+}
+
+void BgzfWriter::write_output(const char* data, unsigned int length) throw (WriterException) {
+	bgzf_block* slot = NULL;
+	unsigned int chunk = 0u;
+
+	while (length > 0u) {
+		if (queued - written >= slots_number) {
+			write_blocks(false);
+		}
+
+		slot = &slots[queued % slots_number];
+
+		chunk = BLOCK_SIZE - slot->uncompressed_length;
+		if (chunk > length) {
+			chunk = length;
+		}
+
+		memcpy(slot->uncompressed + slot->uncompressed_length, data, chunk);
+		slot->uncompressed_length += chunk;
+		data += chunk;
+		length -= chunk;
+
+		if (slot->uncompressed_length == BLOCK_SIZE) {
+			queue_block();
+			write_blocks(false);
+		}
+	}
+}
+
+const vector<uint64_t>* BgzfWriter::get_block_offsets() {
+	return &block_offsets;
+}
@@ -2,10 +2,14 @@
 
 const unsigned int GzipWriter::DEFAULT_BUFFER_SIZE = 16777216;
 
-GzipWriter::GzipWriter(unsigned int buffer_size) throw (WriterException) : buffer(NULL) {
+GzipWriter::GzipWriter(unsigned int buffer_size, int level) throw (WriterException) : outfile(NULL), buffer(NULL), level(level) {
+	if ((level < Z_DEFAULT_COMPRESSION) || (level > Z_BEST_COMPRESSION)) {
+		throw WriterException("GzipWriter", "GzipWriter( unsigned int, int )", __LINE__, 1, "level");
+	}
+
 	buffer = (char*)malloc((buffer_size + 1u) * sizeof(char));
 	if (buffer == NULL) {
-		throw WriterException("GzipWriter", "GzipWriter( unsigned int )", __LINE__, 2, (buffer_size + 1u) * sizeof(char));
+		throw WriterException("GzipWriter", "GzipWriter( unsigned int, int )", __LINE__, 2, (buffer_size + 1u) * sizeof(char));
 	}
 
 	buffer[0] = '\0';
@@ -17,7 +21,15 @@ GzipWriter::~GzipWriter() {
 }
 
 void GzipWriter::open() throw (WriterException) {
-	outfile = gzopen(file_name, "wb");
+	char mode[4] = { 'w', 'b', '\0', '\0' };
+
+	if (level != Z_DEFAULT_COMPRESSION) {
+		mode[2] = (char)('0' + level);
+	}
+
+	reset_output();
+
+	outfile = gzopen(file_name, mode);
 	if (outfile == NULL) {
 		throw WriterException("GzipWriter", "open()", __LINE__, 3, file_name);
 	}
@@ -26,6 +38,8 @@ void GzipWriter::open() throw (WriterException) {
 void GzipWriter::close() throw (WriterException) {
 	int gzerrno = 0;
 
+	flush();
+
 	gzerrno = gzclose(outfile);
 	if (gzerrno != Z_OK) {
 		throw WriterException("GzipWriter", "close()", __LINE__, 5, file_name);
@@ -34,14 +48,19 @@ void GzipWriter::close() throw (WriterException) {
 
 void GzipWriter::write(const char* format, ...) throw (WriterException) {
 	va_list arguments;
+	int length = 0;
 
 	va_start(arguments, format);
-	if (vsprintf(buffer, format, arguments) < 0) {
+	if ((length = vsprintf(buffer, format, arguments)) < 0) {
 		throw WriterException("GzipWriter", "write( const char* )", __LINE__, 4, file_name);
 	}
 	va_end(arguments);
 
-	if (gzputs(outfile, buffer) < 0) {
-		throw WriterException("GzipWriter", "write( cosnt char* )", __LINE__, 4, file_name);
+	append(buffer, length);
+}
+
+void GzipWriter::write_output(const char* data, unsigned int length) throw (WriterException) {
+	if (gzwrite(outfile, data, length) <= 0) {
+		throw WriterException("GzipWriter", "write_output( const char*, unsigned int )", __LINE__, 4, file_name);
 	}
 }
@@ -0,0 +1,291 @@
+#include "include/TabixIndex.h"
+#include "include/BgzfWriter.h"
+
+const char* TabixIndex::TBI = "TBI";
+const char* TabixIndex::CSI = "CSI";
+const int TabixIndex::MIN_SHIFT = 14;
+const int TabixIndex::TBI_DEPTH = 5;
+const int TabixIndex::CSI_DEPTH = 6;
+
+TabixIndex::TabixIndex(const char* file_name, const char* format, int chromosome_column, int position_column) throw (WriterException) :
+	file_name(NULL), csi(false), chromosome_column(chromosome_column), position_column(position_column), min_shift(MIN_SHIFT), depth(TBI_DEPTH),
+	current_reference(NULL), bin_open(false), bin(0u), bin_begin(0u), bin_end(0u), last_position(0l), records_number(0ul) {
+
+	if (file_name == NULL) {
+		throw WriterException("TabixIndex", "TabixIndex( const char*, const char*, int, int )", __LINE__, 0, "file_name");
+	}
+
+	if (format == NULL) {
+		throw WriterException("TabixIndex", "TabixIndex( const char*, const char*, int, int )", __LINE__, 0, "format");
+	}
+
+	if (strcmp(format, CSI) == 0) {
+		csi = true;
+		depth = CSI_DEPTH;
+	} else if (strcmp(format, TBI) != 0) {
+		throw WriterException("TabixIndex", "TabixIndex( const char*, const char*, int, int )", __LINE__, 1, "format");
+	}
+
+	if (chromosome_column <= 0) {
+		throw WriterException("TabixIndex", "TabixIndex( const char*, const char*, int, int )", __LINE__, 1, "chromosome_column");
+	}
+
+	if (position_column <= 0) {
+		throw WriterException("TabixIndex", "TabixIndex( const char*, const char*, int, int )", __LINE__, 1, "position_column");
+	}
+
+	this->file_name = (char*)malloc((strlen(file_name) + 1u) * sizeof(char));
+	if (this->file_name == NULL) {
+		throw WriterException("TabixIndex", "TabixIndex( const char*, const char*, int, int )", __LINE__, 2, (strlen(file_name) + 1u) * sizeof(char));
+	}
+	strcpy(this->file_name, file_name);
+}
+
+TabixIndex::~TabixIndex() {
+	vector<reference*>::iterator references_it;
+
+	for (references_it = references.begin(); references_it != references.end(); references_it++) {
+		free((*references_it)->name);
+		delete *references_it;
+	}
+	references.clear();
+
+	free(file_name);
+	file_name = NULL;
+}
+
+const char* TabixIndex::get_extension() {
+	return csi ? ".csi" : ".tbi";
+}
+
+const char* TabixIndex::get_other_extension() {
+	return csi ? ".tbi" : ".csi";
+}
+
+/* the smallest bin containing the 0-based half-open interval [begin, end) */
+unsigned int TabixIndex::reg2bin(long int begin, long int end) {
+	int shift = min_shift;
+	int level = depth;
+	unsigned int first = ((1u << (3 * depth + 3)) - 1u) / 7u;
+
+	for (end -= 1l; level > 0; --level, shift += 3) {
+		first -= 1u << (3 * level);
+		if ((begin >> shift) == (end >> shift)) {
+			return first + (unsigned int)(begin >> shift);
+		}
+	}
+
+	return 0u;
+}
+
+void TabixIndex::close_bin() {
+	vector<chunk>* chunks = NULL;
+	chunk new_chunk;
+
+	if (bin_open) {
+		chunks = &(current_reference->bins[bin]);
+		if (!chunks->empty() && (chunks->back().end == bin_begin)) {
+			chunks->back().end = bin_end;
+		} else {
+			new_chunk.begin = bin_begin;
+			new_chunk.end = bin_end;
+			chunks->push_back(new_chunk);
+		}
+		bin_open = false;
+	}
+}
+
+/* records [begin, end) of the uncompressed output; chromosomes must be contiguous and positions non-decreasing */
+void TabixIndex::add(const char* chromosome, long int position, uint64_t begin, uint64_t end) throw (WriterException) {
+	vector<reference*>::iterator references_it;
+	unsigned int record_bin = 0u;
+	unsigned long int window = 0ul;
+
+	records_number += 1ul;
+
+	if ((chromosome == NULL) || (position <= 0l)) {
+		close_bin();
+		return;
+	}
+
+	if ((current_reference == NULL) || (strcmp(current_reference->name, chromosome) != 0)) {
+		close_bin();
+
+		for (references_it = references.begin(); references_it != references.end(); references_it++) {
+			if (strcmp((*references_it)->name, chromosome) == 0) {
+				throw WriterException("TabixIndex", "add( const char*, long int, uint64_t, uint64_t )", __LINE__, 8, records_number + 1ul, file_name);
+			}
+		}
+
+		current_reference = new reference();
+		current_reference->name = (char*)malloc((strlen(chromosome) + 1u) * sizeof(char));
+		if (current_reference->name == NULL) {
+			delete current_reference;
+			current_reference = NULL;
+			throw WriterException("TabixIndex", "add( const char*, long int, uint64_t, uint64_t )", __LINE__, 2, (strlen(chromosome) + 1u) * sizeof(char));
+		}
+		strcpy(current_reference->name, chromosome);
+		references.push_back(current_reference);
+
+		last_position = 0l;
+	} else if (position < last_position) {
+		throw WriterException("TabixIndex", "add( const char*, long int, uint64_t, uint64_t )", __LINE__, 8, records_number + 1ul, file_name);
+	}
+
+	if ((int64_t)position > ((int64_t)1 << (min_shift + 3 * depth))) {
+		throw WriterException("TabixIndex", "add( const char*, long int, uint64_t, uint64_t )", __LINE__, 9, position, records_number + 1ul, file_name);
+	}
+
+	record_bin = reg2bin(position - 1l, position);
+	if (bin_open && ((record_bin != bin) || (begin != bin_end))) {
+		close_bin();
+	}
+
+	if (!bin_open) {
+		bin = record_bin;
+		bin_begin = begin;
+		bin_open = true;
+	}
+	bin_end = end;
+
+	last_position = position;
+
+	if (!csi) {
+		window = (unsigned long int)((position - 1l) >> min_shift);
+		if (current_reference->intervals.size() <= window) {
+			current_reference->intervals.resize(window + 1ul, UINT64_MAX);
+		}
+		if (current_reference->intervals[window] == UINT64_MAX) {
+			current_reference->intervals[window] = begin;
+		}
+	}
+}
+
+/* uncompressed offset to virtual offset; all BGZF blocks except the last one hold exactly block_size bytes */
+uint64_t TabixIndex::translate(uint64_t offset, const vector<uint64_t>* block_offsets, unsigned int block_size) {
+	uint64_t block = offset / block_size;
+
+	if (block >= block_offsets->size()) {
+		return block_offsets->back() << 16;
+	}
+
+	return (block_offsets->at(block) << 16) | (offset % block_size);
+}
+
+void TabixIndex::put_int32(Writer* writer, int32_t value) throw (WriterException) {
+	uint32_t unsigned_value = (uint32_t)value;
+	char bytes[4];
+
+	for (int i = 0; i < 4; ++i) {
+		bytes[i] = (char)(unsigned_value & 0xffu);
+		unsigned_value >>= 8;
+	}
+
+	writer->put_bytes(bytes, 4u);
+}
+
+void TabixIndex::put_uint64(Writer* writer, uint64_t value) throw (WriterException) {
+	char bytes[8];
+
+	for (int i = 0; i < 8; ++i) {
+		bytes[i] = (char)(value & 0xffu);
+		value >>= 8;
+	}
+
+	writer->put_bytes(bytes, 8u);
+}
+
+/* generic tabix configuration: sequence and position columns, '#' meta lines, one header line */
+void TabixIndex::save_header(Writer* writer) throw (WriterException) {
+	vector<reference*>::iterator references_it;
+	int32_t names_length = 0;
+
+	for (references_it = references.begin(); references_it != references.end(); references_it++) {
+		names_length += (int32_t)strlen((*references_it)->name) + 1;
+	}
+
+	put_int32(writer, 0);
+	put_int32(writer, chromosome_column);
+	put_int32(writer, position_column);
+	put_int32(writer, position_column);
+	put_int32(writer, '#');
+	put_int32(writer, 1);
+	put_int32(writer, names_length);
+
+	for (references_it = references.begin(); references_it != references.end(); references_it++) {
+		writer->put_bytes((*references_it)->name, strlen((*references_it)->name) + 1u);
+	}
+}
+
+void TabixIndex::save(const char* index_file_name, const vector<uint64_t>* block_offsets, unsigned int block_size) throw (WriterException) {
+	BgzfWriter writer(1024u, BgzfWriter::DEFAULT_LEVEL, 1u);
+
+	vector<reference*>::iterator references_it;
+	map<unsigned int, vector<chunk> >::iterator bins_it;
+	vector<chunk>::iterator chunks_it;
+	vector<uint64_t>::iterator intervals_it;
+	uint64_t interval = 0u;
+	int32_t names_length = 0;
+
+	if ((block_offsets == NULL) || (block_offsets->empty())) {
+		throw WriterException("TabixIndex", "save( const char*, const vector<uint64_t>*, unsigned int )", __LINE__, 7, file_name);
+	}
+
+	close_bin();
+
+	writer.set_file_name(index_file_name);
+	writer.open();
+
+	if (csi) {
+		for (references_it = references.begin(); references_it != references.end(); references_it++) {
+			names_length += (int32_t)strlen((*references_it)->name) + 1;
+		}
+
+		writer.put_bytes("CSI\1", 4u);
+		put_int32(&writer, min_shift);
+		put_int32(&writer, depth);
+		put_int32(&writer, 28 + names_length);
+		save_header(&writer);
+		put_int32(&writer, (int32_t)references.size());
+	} else {
+		writer.put_bytes("TBI\1", 4u);
+		put_int32(&writer, (int32_t)references.size());
+		save_header(&writer);
+	}
+
+	for (references_it = references.begin(); references_it != references.end(); references_it++) {
+		put_int32(&writer, (int32_t)(*references_it)->bins.size());
+		for (bins_it = (*references_it)->bins.begin(); bins_it != (*references_it)->bins.end(); bins_it++) {
+			put_int32(&writer, (int32_t)bins_it->first);
+			if (csi) {
+				put_uint64(&writer, translate(bins_it->second.front().begin, block_offsets, block_size));
+			}
+			put_int32(&writer, (int32_t)bins_it->second.size());
+			for (chunks_it = bins_it->second.begin(); chunks_it != bins_it->second.end(); chunks_it++) {
+				put_uint64(&writer, translate(chunks_it->begin, block_offsets, block_size));
+				put_uint64(&writer, translate(chunks_it->end, block_offsets, block_size));
+			}
+		}
+
+		if (!csi) {
+			/* windows without records start where the closest preceding window does */
+			interval = UINT64_MAX;
+			for (intervals_it = (*references_it)->intervals.begin(); intervals_it != (*references_it)->intervals.end(); intervals_it++) {
+				if (*intervals_it != UINT64_MAX) {
+					interval = *intervals_it;
+					break;
+				}
+			}
+
+			put_int32(&writer, (int32_t)(*references_it)->intervals.size());
+			for (intervals_it = (*references_it)->intervals.begin(); intervals_it != (*references_it)->intervals.end(); intervals_it++) {
+				if (*intervals_it != UINT64_MAX) {
+					interval = *intervals_it;
+				}
+				put_uint64(&writer, translate(interval, block_offsets, block_size));
+			}
+		}
+	}
+
+	writer.close();
+}
@@ -12,6 +12,11 @@ TextWriter::TextWriter(unsigned int buffer_size) throw (WriterException) : buffe
 }
 
 TextWriter::~TextWriter() {
+	if (ofile_stream.is_open()) {
+		ofile_stream.write(output, output_length);
+		output_length = 0u;
+	}
+
 	free(buffer);
 	buffer = NULL;
 }
@@ -21,6 +26,8 @@ void TextWriter::open() throw (WriterException) {
 		close();
 	}
 
+	reset_output();
+
 	ofile_stream.clear();
 	ofile_stream.open(file_name, ios::binary);
 
@@ -31,6 +38,8 @@ void TextWriter::open() throw (WriterException) {
 
 void TextWriter::close() throw (WriterException) {
 	if (ofile_stream.is_open()) {
+		flush();
+
 		ofile_stream.clear();
 		ofile_stream.close();
 
@@ -42,16 +51,21 @@ void TextWriter::close() throw (WriterException) {
 
 void TextWriter::write(const char* format, ...) throw (WriterException) {
 	va_list arguments;
+	int length = 0;
 
 	va_start(arguments, format);
-	if (vsprintf(buffer, format, arguments) < 0) {
+	if ((length = vsprintf(buffer, format, arguments)) < 0) {
 		throw WriterException("TextWriter", "write( const char* )", __LINE__, 4, file_name);
 	}
 	va_end(arguments);
 
-	ofile_stream << buffer;
+	append(buffer, length);
+}
+
+void TextWriter::write_output(const char* data, unsigned int length) throw (WriterException) {
+	ofile_stream.write(data, length);
 
 	if (ofile_stream.fail()) {
-		throw WriterException("TextWriter", "write( const char* )", __LINE__, 4, file_name);
+		throw WriterException("TextWriter", "write_output( const char*, unsigned int )", __LINE__, 4, file_name);
 	}
 }
@@ -1,12 +1,25 @@
 #include "include/Writer.h"
+#include "include/TabixIndex.h"
+#include "include/BgzfWriter.h"
 
-Writer::Writer() : file_name(NULL) {
+const unsigned int Writer::OUTPUT_BUFFER_SIZE = 4194304;
 
+Writer::Writer() throw (WriterException) : file_name(NULL), output(NULL), output_length(0u), output_offset(0u), index(NULL), record_offset(0u) {
+	output = (char*)malloc(OUTPUT_BUFFER_SIZE * sizeof(char));
+	if (output == NULL) {
+		throw WriterException("Writer", "Writer()", __LINE__, 2, OUTPUT_BUFFER_SIZE * sizeof(char));
+	}
 }
 
 Writer::~Writer() {
+	delete index;
+	index = NULL;
+
 	free(file_name);
 	file_name = NULL;
+
+	free(output);
+	output = NULL;
 }
 
 void Writer::set_file_name(const char* file_name) throw (WriterException) {
@@ -22,3 +35,137 @@ void Writer::set_file_name(const char* file_name) throw (WriterException) {
 const char* Writer::get_file_name() {
 	return file_name;
 }
+
+void Writer::append(const char* data, unsigned int length) throw (WriterException) {
+	if (output_length + length > OUTPUT_BUFFER_SIZE) {
+		flush();
+	}
+
+	if (length >= OUTPUT_BUFFER_SIZE) {
+		write_output(data, length);
+		output_offset += length;
+	} else {
+		memcpy(output + output_length, data, length);
+		output_length += length;
+	}
+}
+
+void Writer::flush() throw (WriterException) {
+	unsigned int length = output_length;
+
+	if (length > 0u) {
+		output_length = 0u;
+		write_output(output, length);
+		output_offset += length;
+	}
+}
+
+void Writer::put_str(const char* value) throw (WriterException) {
+	append(value, strlen(value));
+}
+
+void Writer::put_bytes(const char* data, unsigned int length) throw (WriterException) {
+	append(data, length);
+}
+
+void Writer::put_int(long int value) throw (WriterException) {
+	if (value < 0) {
+		put_char('-');
+		put_uint(0ul - (unsigned long int)value);
+	} else {
+		put_uint((unsigned long int)value);
+	}
+}
+
+void Writer::put_uint(unsigned long int value) throw (WriterException) {
+	char digits[32];
+	int position = 32;
+
+	do {
+		digits[--position] = (char)('0' + value % 10ul);
+		value /= 10ul;
+	} while (value > 0ul);
+
+	append(digits + position, 32 - position);
+}
+
+void Writer::put_double(double value, int precision) throw (WriterException) {
+	char digits[512];
+
+	append(digits, auxiliary::format_double(digits, value, precision));
+}
+
+void Writer::reset_output() {
+	output_length = 0u;
+	output_offset = 0u;
+	record_offset = 0u;
+
+	delete index;
+	index = NULL;
+}
+
+/* number of bytes written since the file was opened */
+uint64_t Writer::tell() {
+	return output_offset + output_length;
+}
+
+const vector<uint64_t>* Writer::get_block_offsets() {
+	return NULL;
+}
+
+/* records written after this call are indexed; columns are 1-based */
+void Writer::set_index(const char* format, int chromosome_column, int position_column) throw (WriterException) {
+	if (get_block_offsets() == NULL) {
+		throw WriterException("Writer", "set_index( const char*, int, int )", __LINE__, 7, file_name);
+	}
+
+	delete index;
+	index = NULL;
+
+	index = new TabixIndex(file_name, format, chromosome_column, position_column);
+	record_offset = tell();
+}
+
+/* indexes the record written since the previous call; records without chromosome or position are skipped */
+void Writer::index_record(const char* chromosome, long int position) throw (WriterException) {
+	uint64_t offset = tell();
+
+	if (index != NULL) {
+		index->add(chromosome, position, record_offset, offset);
+	}
+
+	record_offset = offset;
+}
+
+void Writer::save_index() throw (WriterException) {
+	char* index_file_name = NULL;
+
+	if (index != NULL) {
+		index_file_name = (char*)malloc((strlen(file_name) + strlen(index->get_extension()) + 1u) * sizeof(char));
+		if (index_file_name == NULL) {
+			throw WriterException("Writer", "save_index()", __LINE__, 2, (strlen(file_name) + strlen(index->get_extension()) + 1u) * sizeof(char));
+		}
+
+		strcpy(index_file_name, file_name);
+		strcat(index_file_name, index->get_extension());
+
+		try {
+			index->save(index_file_name, get_block_offsets(), BgzfWriter::BLOCK_SIZE);
+		} catch (WriterException &e) {
+			e.add_message("Writer", "save_index()", __LINE__, 10, index_file_name);
+			free(index_file_name);
+			throw;
+		}
+
+		/* readers would otherwise pick up an index of the other format left from an earlier run */
+		strcpy(index_file_name, file_name);
+		strcat(index_file_name, index->get_other_extension());
+		remove(index_file_name);
+
+		free(index_file_name);
+		index_file_name = NULL;
+
+		delete index;
+		index = NULL;
+	}
+}
@@ -19,7 +19,7 @@
 
 #include "include/WriterException.h"
 
-const int WriterException::MESSAGE_TEMPLATES_NUMBER = 7;
+const int WriterException::MESSAGE_TEMPLATES_NUMBER = 11;
 const char* WriterException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
@@ -27,7 +27,11 @@ const char* WriterException::MESSAGE_TEMPLATES[] = {
 /*03*/	"Error while opening '%s' file.",
 /*04*/	"Error while writing '%s' file.",
 /*05*/	"Error while closing '%s' file.",
-/*06*/	"Error while initializing writing facilities for '%s' file type."
+/*06*/	"Error while initializing writing facilities for '%s' file type.",
+/*07*/	"Indexing is not supported for '%s' file.",
+/*08*/	"Line %lu in '%s' file is not sorted by chromosome and position.",
+/*09*/	"Position %ld on line %lu in '%s' file is too large to be indexed.",
+/*10*/	"Error while writing '%s' index file."
 };
 
 WriterException::WriterException() : Exception() {
@@ -2,6 +2,7 @@
 
 const char* WriterFactory::TEXT = "TEXT";
 const char* WriterFactory::GZIP = "GZIP";
+const char* WriterFactory::BGZF = "BGZF";
 
 WriterFactory::WriterFactory() {
 
@@ -11,12 +12,25 @@ WriterFactory::~WriterFactory() {
 
 }
 
-Writer* WriterFactory::create(const char* type) throw (WriterException) {
+Writer* WriterFactory::create(const char* type, int level) throw (WriterException) {
 	if (auxiliary::strcmp_ignore_case(type, TEXT) == 0) {
 		return new TextWriter();
 	} else if (auxiliary::strcmp_ignore_case(type, GZIP) == 0) {
-		return new GzipWriter();
+		return new GzipWriter(GzipWriter::DEFAULT_BUFFER_SIZE, level);
+	} else if (auxiliary::strcmp_ignore_case(type, BGZF) == 0) {
+		return new BgzfWriter(BgzfWriter::DEFAULT_BUFFER_SIZE, level);
 	} else {
-		throw WriterException("WriterFactor", "create( const char* )", __LINE__, 6, type);
+		throw WriterException("WriterFactor", "create( const char*, int )", __LINE__, 6, type);
+	}
+}
+
+Writer* WriterFactory::create_async(const char* type, int level) throw (WriterException) {
+	Writer* writer = create(type, level);
+
+	try {
+		return new AsyncWriter(writer);
+	} catch (WriterException &e) {
+		delete writer;
+		throw;
 	}
 }
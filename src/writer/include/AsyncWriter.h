@@ -0,0 +1,66 @@
+#ifndef ASYNCWRITER_H_
+#define ASYNCWRITER_H_
+
+#include "Writer.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+using namespace std;
+
+class AsyncWriter : public Writer {
+private:
+	struct output_slot {
+		char* data;
+		unsigned int length;
+	};
+
+	Writer* writer;
+
+	char* buffer;
+
+	WriterException* error;
+
+#ifndef WIN32
+	pthread_t thread;
+	bool thread_running;
+	bool thread_stop;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t slots_queued;
+	pthread_cond_t slots_written;
+
+	unsigned int slots_number;
+	output_slot* slots;
+
+	unsigned long int queued;
+	unsigned long int written;
+
+	output_slot* acquire_slot() throw (WriterException);
+	void queue_slot();
+	void stop_thread();
+
+	static void* write_slots(void* writer);
+#endif
+
+	void rethrow_error() throw (WriterException);
+
+protected:
+	void write_output(const char* data, unsigned int length) throw (WriterException);
+
+public:
+	static const unsigned int DEFAULT_BUFFER_SIZE;
+	static const unsigned int DEFAULT_SLOTS_NUMBER;
+
+	AsyncWriter(Writer* writer, unsigned int buffer_size = DEFAULT_BUFFER_SIZE, unsigned int slots_number = DEFAULT_SLOTS_NUMBER) throw (WriterException);
+	virtual ~AsyncWriter();
+
+	void open() throw (WriterException);
+	void close() throw (WriterException);
+	void write(const char* format, ...) throw (WriterException);
+
+	const vector<uint64_t>* get_block_offsets();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef BGZFWRITER_H_
+#define BGZFWRITER_H_
+
+#include "Writer.h"
+#include "../../zlib/zlib.h"
+#include <fstream>
+
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+class BgzfWriter : public Writer {
+private:
+	struct bgzf_block {
+		char* uncompressed;
+		char* compressed;
+		unsigned int uncompressed_length;
+		unsigned int compressed_length;
+		bool deflated;
+		bool failed;
+	};
+
+	ofstream ofile_stream;
+
+	char* buffer;
+
+	int level;
+
+	z_stream stream;
+	bool stream_ready;
+
+	unsigned int threads_number;
+	unsigned int running_threads_number;
+
+#ifndef WIN32
+	pthread_t* threads;
+	bool threads_stop;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t blocks_queued;
+	pthread_cond_t blocks_deflated;
+#endif
+
+	unsigned int slots_number;
+	bgzf_block* slots;
+
+	unsigned long int queued;
+	unsigned long int claimed;
+	unsigned long int written;
+
+	vector<uint64_t> block_offsets;
+	uint64_t compressed_offset;
+
+	void start_threads() throw (WriterException);
+	void stop_threads();
+
+	void queue_block();
+	void write_blocks(bool all) throw (WriterException);
+
+	static bool deflate_block(z_stream* stream, bgzf_block* slot);
+#ifndef WIN32
+	static void* deflate_blocks(void* writer);
+#endif
+
+protected:
+	void write_output(const char* data, unsigned int length) throw (WriterException);
+
+public:
+	static const unsigned int DEFAULT_BUFFER_SIZE;
+	static const unsigned int BLOCK_SIZE;
+	static const unsigned int MAX_BLOCK_SIZE;
+	static const unsigned int SLOTS_PER_THREAD;
+	static const unsigned int MAX_THREADS_NUMBER;
+	static const int DEFAULT_LEVEL;
+
+	static unsigned int get_default_threads_number();
+
+	BgzfWriter(unsigned int buffer_size = DEFAULT_BUFFER_SIZE, int level = DEFAULT_LEVEL, unsigned int threads_number = 0u) throw (WriterException);
+	virtual ~BgzfWriter();
+
+	void open() throw (WriterException);
+	void close() throw (WriterException);
+	void write(const char* format, ...) throw (WriterException);
+
+	const vector<uint64_t>* get_block_offsets();
+};
+
+#endif
@@ -12,10 +12,15 @@ private:
 
 	char* buffer;
 
+	int level;
+
+protected:
+	void write_output(const char* data, unsigned int length) throw (WriterException);
+
 public:
 	static const unsigned int DEFAULT_BUFFER_SIZE;
 
-	GzipWriter(unsigned int buffer_size = DEFAULT_BUFFER_SIZE) throw (WriterException);
+	GzipWriter(unsigned int buffer_size = DEFAULT_BUFFER_SIZE, int level = Z_DEFAULT_COMPRESSION) throw (WriterException);
 	virtual ~GzipWriter();
 
 	void open() throw (WriterException);
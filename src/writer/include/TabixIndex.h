@@ -0,0 +1,72 @@
+#ifndef TABIXINDEX_H_
+#define TABIXINDEX_H_
+
+#include "WriterException.h"
+#include "../../auxiliary/include/auxiliary.h"
+#include <cstring>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+class Writer;
+
+class TabixIndex {
+private:
+	struct chunk {
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	struct reference {
+		char* name;
+		map<unsigned int, vector<chunk> > bins;
+		vector<uint64_t> intervals;
+	};
+
+	char* file_name;
+
+	bool csi;
+	int chromosome_column;
+	int position_column;
+	int min_shift;
+	int depth;
+
+	vector<reference*> references;
+	reference* current_reference;
+
+	bool bin_open;
+	unsigned int bin;
+	uint64_t bin_begin;
+	uint64_t bin_end;
+
+	long int last_position;
+	unsigned long int records_number;
+
+	unsigned int reg2bin(long int begin, long int end);
+	void close_bin();
+
+	static uint64_t translate(uint64_t offset, const vector<uint64_t>* block_offsets, unsigned int block_size);
+	static void put_int32(Writer* writer, int32_t value) throw (WriterException);
+	static void put_uint64(Writer* writer, uint64_t value) throw (WriterException);
+
+	void save_header(Writer* writer) throw (WriterException);
+
+public:
+	static const char* TBI;
+	static const char* CSI;
+	static const int MIN_SHIFT;
+	static const int TBI_DEPTH;
+	static const int CSI_DEPTH;
+
+	TabixIndex(const char* file_name, const char* format, int chromosome_column, int position_column) throw (WriterException);
+	virtual ~TabixIndex();
+
+	const char* get_extension();
+	const char* get_other_extension();
+
+	void add(const char* chromosome, long int position, uint64_t begin, uint64_t end) throw (WriterException);
+	void save(const char* index_file_name, const vector<uint64_t>* block_offsets, unsigned int block_size) throw (WriterException);
+};
+
+#endif
@@ -12,6 +12,9 @@ private:
 
 	char* buffer;
 
+protected:
+	void write_output(const char* data, unsigned int length) throw (WriterException);
+
 public:
 	static const unsigned int DEFAULT_BUFFER_SIZE;
 
@@ -2,18 +2,38 @@
 #define WRITER_H_
 
 #include "WriterException.h"
+#include "../../auxiliary/include/auxiliary.h"
 #include <cstdarg>
 #include <cstring>
+#include <vector>
 
 using namespace std;
 
+class TabixIndex;
+
 class Writer {
 protected:
 	char* file_name;
 
-	Writer();
+	char* output;
+	unsigned int output_length;
+	uint64_t output_offset;
+
+	TabixIndex* index;
+	uint64_t record_offset;
+
+	Writer() throw (WriterException);
+
+	virtual void write_output(const char* data, unsigned int length) throw (WriterException) = 0;
+
+	void append(const char* data, unsigned int length) throw (WriterException);
+
+	void reset_output();
+	void save_index() throw (WriterException);
 
 public:
+	static const unsigned int OUTPUT_BUFFER_SIZE;
+
 	virtual ~Writer();
 
 	void set_file_name(const char* file_name) throw (WriterException);
@@ -22,6 +42,28 @@ public:
 	virtual void open() throw (WriterException) = 0;
 	virtual void close() throw (WriterException) = 0;
 	virtual void write(const char* format, ...) throw (WriterException) = 0;
+
+	void flush() throw (WriterException);
+
+	void put_str(const char* value) throw (WriterException);
+	void put_bytes(const char* data, unsigned int length) throw (WriterException);
+	void put_char(char value) throw (WriterException);
+	void put_int(long int value) throw (WriterException);
+	void put_uint(unsigned long int value) throw (WriterException);
+	void put_double(double value, int precision) throw (WriterException);
+
+	uint64_t tell();
+	virtual const vector<uint64_t>* get_block_offsets();
+
+	void set_index(const char* format, int chromosome_column, int position_column) throw (WriterException);
+	void index_record(const char* chromosome, long int position) throw (WriterException);
 };
 
+inline void Writer::put_char(char value) throw (WriterException) {
+	if (output_length >= OUTPUT_BUFFER_SIZE) {
+		flush();
+	}
+	output[output_length++] = value;
+}
+
 #endif
@@ -3,6 +3,8 @@
 
 #include "TextWriter.h"
 #include "GzipWriter.h"
+#include "BgzfWriter.h"
+#include "AsyncWriter.h"
 #include "../../auxiliary/include/auxiliary.h"
 
 using namespace std;
@@ -14,10 +16,12 @@ private:
 public:
 	static const char* TEXT;
 	static const char* GZIP;
+	static const char* BGZF;
 
 	virtual ~WriterFactory();
 
-	static Writer* create(const char* type) throw (WriterException);
+	static Writer* create(const char* type, int level = Z_DEFAULT_COMPRESSION) throw (WriterException);
+	static Writer* create_async(const char* type, int level = Z_DEFAULT_COMPRESSION) throw (WriterException);
 };
 
 #endif
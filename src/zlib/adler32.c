@@ -56,6 +56,72 @@ local uLong adler32_combine_(uLong adler1, uLong adler2, z_off64_t len2);
 #  define MOD4(a) a %= BASE
 #endif
 
+#ifdef X86_SIMD
+#include <tmmintrin.h>
+
+/* ========================================================================= */
+/* Adler-32 of 32-byte blocks: SAD sums the bytes into s1 and a multiply-add
+ * against the descending weights 32..1 accumulates their contribution to s2.
+ * Returns the recombined sums; the tail (len % 32) is left to the caller.
+ */
+__attribute__((target("ssse3")))
+local uLong adler32_ssse3(adler, buf, len)
+    uLong adler;
+    const Bytef *buf;
+    uInt len;
+{
+    unsigned long s1 = adler & 0xffff;
+    unsigned long s2 = (adler >> 16) & 0xffff;
+    unsigned blocks = len / 32;
+    unsigned n;
+    __m128i tap1, tap2, zero, ones;
+    __m128i v_ps, v_s1, v_s2, bytes1, bytes2;
+
+    tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                         24, 23, 22, 21, 20, 19, 18, 17);
+    tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9,
+                         8, 7, 6, 5, 4, 3, 2, 1);
+    zero = _mm_setzero_si128();
+    ones = _mm_set1_epi16(1);
+
+    while (blocks) {
+        n = NMAX / 32;          /* keep the 32-bit lanes from overflowing */
+        if (n > blocks)
+            n = blocks;
+        blocks -= n;
+
+        v_ps = _mm_cvtsi32_si128((int)(s1 * n));
+        v_s2 = _mm_cvtsi32_si128((int)s2);
+        v_s1 = _mm_setzero_si128();
+        do {
+            bytes1 = _mm_loadu_si128((const __m128i *)buf);
+            bytes2 = _mm_loadu_si128((const __m128i *)(buf + 16));
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+            v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+            v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+            buf += 32;
+        } while (--n);
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        /* horizontal sums */
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1 += (unsigned int)_mm_cvtsi128_si32(v_s1);
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s2 = (unsigned int)_mm_cvtsi128_si32(v_s2);
+
+        MOD(s1);
+        MOD(s2);
+    }
+    return s1 | (s2 << 16);
+}
+#endif /* X86_SIMD */
+
 /* ========================================================================= */
 uLong ZEXPORT adler32(adler, buf, len)
     uLong adler;
@@ -96,6 +162,19 @@ uLong ZEXPORT adler32(adler, buf, len)
         return adler | (sum2 << 16);
     }
 
+#ifdef X86_SIMD
+    if (len >= 64 && x86_cpu_has(X86_SSSE3)) {
+        n = len & ~31U;
+        adler = adler32_ssse3(adler | (sum2 << 16), buf, n);
+        sum2 = (adler >> 16) & 0xffff;
+        adler &= 0xffff;
+        buf += n;
+        len -= n;
+        if (len == 0)
+            return adler | (sum2 << 16);
+    }
+#endif /* X86_SIMD */
+
     /* do length NMAX blocks -- requires just one modulo operation */
     while (len >= NMAX) {
         len -= NMAX;
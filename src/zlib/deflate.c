@@ -1060,6 +1060,11 @@ local void lm_init (s)
 /* For 80x86 and 680x0, an optimized version will be provided in match.asm or
  * match.S. The code will be functionally equivalent.
  */
+#if !defined(UNALIGNED_OK) && defined(HAVE_MEMCPY) && defined(__GNUC__) && \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define WIDE_MATCH
+#endif
+
 local uInt longest_match(s, cur_match)
     deflate_state *s;
     IPos cur_match;                             /* current match */
@@ -1089,6 +1094,9 @@ local uInt longest_match(s, cur_match)
     register Bytef *strend = s->window + s->strstart + MAX_MATCH;
     register Byte scan_end1  = scan[best_len-1];
     register Byte scan_end   = scan[best_len];
+#ifdef WIDE_MATCH
+    unsigned long long scan_word, match_word;
+#endif
 #endif
 
     /* The code is optimized for HASH_BITS >= 8 and MAX_MATCH-2 multiple of 16.
@@ -1168,6 +1176,21 @@ local uInt longest_match(s, cur_match)
         scan += 2, match++;
         Assert(*scan == *match, "match[2]?");
 
+#ifdef WIDE_MATCH
+        /* Compare eight bytes at a time; the first differing byte is found
+         * from the lowest set bit of the XOR. The 32nd word ends exactly at
+         * strstart+258, so no byte past the bytewise loop's range is read.
+         */
+        do {
+            zmemcpy(&scan_word, scan + 1, sizeof(scan_word));
+            zmemcpy(&match_word, match + 1, sizeof(match_word));
+            if ((scan_word ^= match_word) != 0) {
+                scan += 1 + (__builtin_ctzll(scan_word) >> 3);
+                break;
+            }
+            scan += 8, match += 8;
+        } while (scan < strend);
+#else
         /* We check for insufficient lookahead only every 8th comparison;
          * the 256th check will be made at strstart+258.
          */
@@ -1177,6 +1200,7 @@ local uInt longest_match(s, cur_match)
                  *++scan == *++match && *++scan == *++match &&
                  *++scan == *++match && *++scan == *++match &&
                  scan < strend);
+#endif /* WIDE_MATCH */
 
         Assert(scan <= s->window+(unsigned)(s->window_size-1), "wild scan");
 
@@ -29,6 +29,36 @@
 #  define PUP(a) *++(a)
 #endif
 
+/* Copying matches. A run taken from the window never overlaps the output,
+   and a match at least eight bytes back never overlaps the eight bytes
+   written from it, so with memcpy() available both are moved in words
+   instead of bytes. The output is the same either way.
+ */
+#ifdef HAVE_MEMCPY
+#  define WINCOPY() \
+    do { \
+        zmemcpy(out + OFF, from + OFF, op); \
+        out += op; \
+        from += op; \
+    } while (0)
+#  define WORDCOPY() \
+    do { \
+        if (dist >= 8) \
+            while (len >= 8) { \
+                zmemcpy(out + OFF, from + OFF, 8); \
+                out += 8; \
+                from += 8; \
+                len -= 8; \
+            } \
+    } while (0)
+#else
+#  define WINCOPY() \
+    do { \
+        PUP(out) = PUP(from); \
+    } while (--op)
+#  define WORDCOPY()
+#endif
+
 /*
    Decode literal, length, and distance codes and write out the resulting
    literal and match bytes until either not enough input or output is
@@ -218,9 +248,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                         from += wsize - op;
                         if (op < len) {         /* some from window */
                             len -= op;
-                            do {
-                                PUP(out) = PUP(from);
-                            } while (--op);
+                            WINCOPY();
                             from = out - dist;  /* rest from output */
                         }
                     }
@@ -229,16 +257,12 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                         op -= wnext;
                         if (op < len) {         /* some from end of window */
                             len -= op;
-                            do {
-                                PUP(out) = PUP(from);
-                            } while (--op);
+                            WINCOPY();
                             from = window - OFF;
                             if (wnext < len) {  /* some from start of window */
                                 op = wnext;
                                 len -= op;
-                                do {
-                                    PUP(out) = PUP(from);
-                                } while (--op);
+                                WINCOPY();
                                 from = out - dist;      /* rest from output */
                             }
                         }
@@ -247,12 +271,11 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                         from += wnext - op;
                         if (op < len) {         /* some from window */
                             len -= op;
-                            do {
-                                PUP(out) = PUP(from);
-                            } while (--op);
+                            WINCOPY();
                             from = out - dist;  /* rest from output */
                         }
                     }
+                    WORDCOPY();
                     while (len > 2) {
                         PUP(out) = PUP(from);
                         PUP(out) = PUP(from);
@@ -267,12 +290,13 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 }
                 else {
                     from = out - dist;          /* copy direct from output */
-                    do {                        /* minimum length is three */
+                    WORDCOPY();
+                    while (len > 2) {
                         PUP(out) = PUP(from);
                         PUP(out) = PUP(from);
                         PUP(out) = PUP(from);
                         len -= 3;
-                    } while (len > 2);
+                    }
                     if (len) {
                         PUP(out) = PUP(from);
                         if (len > 1)
@@ -144,6 +144,36 @@ const char * ZEXPORT zError(err)
     int errno = 0;
 #endif
 
+#ifdef X86_SIMD
+#include <cpuid.h>
+
+local volatile int x86_cpu_features = -1;
+
+/* Returns non-zero if the processor supports all of the requested X86_*
+ * features. The detection runs once; concurrent first calls store the same
+ * value.
+ */
+int ZLIB_INTERNAL x86_cpu_has(features)
+    int features;
+{
+    unsigned int eax, ebx, ecx, edx;
+    int detected;
+
+    if (x86_cpu_features < 0) {
+        detected = 0;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            if (ecx & (1U << 9))                        /* SSSE3 */
+                detected |= X86_SSSE3;
+            if ((ecx & (1U << 19)) && (ecx & (1U << 20)) &&
+                (ecx & (1U << 1)))                      /* SSE4.1, 4.2, PCLMULQDQ */
+                detected |= X86_PCLMUL;
+        }
+        x86_cpu_features = detected;
+    }
+    return (x86_cpu_features & features) == features;
+}
+#endif /* X86_SIMD */
+
 #ifndef HAVE_MEMCPY
 
 void ZLIB_INTERNAL zmemcpy(dest, source, len)
@@ -262,6 +262,20 @@ extern const char * const z_errmsg[10]; /* indexed by 2-zlib_error */
 #endif
 
 
+/* Run-time dispatched x86 fast paths for the checksums. Define NO_SIMD to
+ * build only the portable code.
+ */
+#if !defined(NO_SIMD) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || \
+     (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#  define X86_SIMD
+#  define X86_SSSE3   1     /* SSSE3: Adler-32 */
+#  define X86_PCLMUL  2     /* SSE4.2 and PCLMULQDQ: CRC-32 folding */
+   int ZLIB_INTERNAL x86_cpu_has OF((int features));
+#endif
+
+
 voidpf ZLIB_INTERNAL zcalloc OF((voidpf opaque, unsigned items,
                         unsigned size));
 void ZLIB_INTERNAL zcfree  OF((voidpf opaque, voidpf ptr));